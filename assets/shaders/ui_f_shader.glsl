@@ -13,10 +13,12 @@ layout (location = 0) out vec4 frag_color;
 
 layout (binding = 0) uniform sampler2D texture_sampler;
 layout (binding = 1) uniform sampler2D secondary_texture_sampler;
+layout (binding = 2) uniform sampler2DArray atlas_sampler;
 layout (location = 2) uniform vec4 d_rect;
 layout (location = 6) uniform float border_size;
 layout (location = 7) uniform vec3 inner_color;
 layout (location = 10) uniform vec4 subrect;
+layout (location = 11) uniform float atlas_layer;
 		
 layout(index = 0) subroutine(font_function_class)
 vec4 border_filter(vec2 tc) {
@@ -54,6 +56,16 @@ vec4 subsprite_b(vec2 tc) {
 	return vec4(inner_color, texture(texture_sampler, vec2(tc.x * subrect.y + subrect.x, tc.y * subrect.a + subrect.z)).a);
 }
 		
+layout(index = 16) subroutine(font_function_class)
+vec4 atlas_sprite(vec2 tc) {
+	return texture(atlas_sampler, vec3(tc.x * subrect.y + subrect.x, tc.y * subrect.a + subrect.z, atlas_layer));
+}
+
+layout(index = 17) subroutine(font_function_class)
+vec4 atlas_mask(vec2 tc) {
+	return vec4(texture(atlas_sampler, vec3(tc.x * subrect.y + subrect.x, tc.y * subrect.a + subrect.z, atlas_layer)).rgb, texture(secondary_texture_sampler, tc).a);
+}
+		
 layout(index = 6) subroutine(font_function_class)
 vec4 use_mask(vec2 tc) {
 	return vec4(texture(texture_sampler, tc).rgb, texture(secondary_texture_sampler, tc).a);
@@ -40,6 +40,7 @@ struct value_modifier_description {
 	float base_factor = 0.0f;
 	uint16_t first_segment_offset = 0;
 	uint16_t segments_count = 0;
+	bool uses_this_slot = false; // false when the value does not depend on what is in the this slot
 };
 
 struct event_option {
@@ -256,6 +256,7 @@ void apply_technology(sys::state& state, dcon::nation_id target_nation, dcon::te
 	auto tech_id = fatten(state.world, t_id);
 
 	state.world.nation_set_active_technologies(target_nation, t_id, true);
+	state.invention_candidates.technology_changed(state, target_nation, t_id);
 
 	auto tech_mod = tech_id.get_modifier();
 	if(tech_mod) {
@@ -327,6 +328,7 @@ void remove_technology(sys::state& state, dcon::nation_id target_nation, dcon::t
 	auto tech_id = fatten(state.world, t_id);
 
 	state.world.nation_set_active_technologies(target_nation, t_id, false);
+	state.invention_candidates.technology_changed(state, target_nation, t_id);
 
 	auto tech_mod = tech_id.get_modifier();
 	if(tech_mod) {
@@ -398,6 +400,7 @@ void apply_invention(sys::state& state, dcon::nation_id target_nation, dcon::inv
 	auto inv_id = fatten(state.world, i_id);
 
 	state.world.nation_set_active_inventions(target_nation, i_id, true);
+	state.invention_candidates.invention_changed(state, target_nation, i_id);
 
 	// apply modifiers from active inventions
 	auto inv_mod = inv_id.get_modifier();
@@ -492,6 +495,7 @@ void remove_invention(sys::state& state, dcon::nation_id target_nation, dcon::in
 	auto inv_id = fatten(state.world, i_id);
 
 	state.world.nation_set_active_inventions(target_nation, i_id, false);
+	state.invention_candidates.invention_changed(state, target_nation, i_id);
 
 	// apply modifiers from active inventions
 	auto inv_mod = inv_id.get_modifier();
@@ -651,6 +655,8 @@ void update_all_nations_issue_rules(sys::state& state) {
 }
 
 void restore_unsaved_values(sys::state& state) {
+	state.invention_candidates.invalidate();
+
 	state.world.for_each_pop([&state](dcon::pop_id pid) {
 		float total = 0.0f;
 		float pol_sup = 0.0f;
@@ -776,48 +782,172 @@ void update_reasearch(sys::state& state, uint32_t current_year) {
 	}
 }
 
+namespace impl {
+
+// collects the technologies that a trigger cannot be satisfied without
+void collect_required_technologies(uint16_t const* t, std::vector<dcon::technology_id>& out) {
+	auto code = t[0] & trigger::code_mask;
+	if(code == trigger::technology) {
+		auto association = t[0] & trigger::association_mask;
+		if(association != trigger::association_ne && association != trigger::association_gt && association != trigger::association_lt)
+			out.push_back(trigger::payload(t[1]).tech_id);
+	} else if(code == trigger::generic_scope && (t[0] & trigger::is_disjunctive_scope) == 0) {
+		auto const source_size = 1 + trigger::get_trigger_scope_payload_size(t);
+		auto sub_units_start = t + 2 + trigger::trigger_scope_data_payload(t[0]);
+		while(sub_units_start < t + source_size) {
+			collect_required_technologies(sub_units_start, out);
+			sub_units_start += 1 + trigger::get_trigger_payload_size(sub_units_start);
+		}
+	}
+}
+
+}
+
+bool invention_candidate_sets::is_current(sys::state const& state) const {
+	return built && nation_count == state.world.nation_size() && requirements.size() == state.world.invention_size();
+}
+
+void invention_candidate_sets::rebuild(sys::state& state) {
+	requirements.clear();
+	requirements.resize(state.world.invention_size());
+	gated_inventions.clear();
+	gated_inventions.resize(state.world.technology_size());
+	state.world.for_each_invention([&](dcon::invention_id i) {
+		if(auto lim = state.world.invention_get_limit(i); lim) {
+			auto& req = requirements[i.index()];
+			impl::collect_required_technologies(state.trigger_data.data() + lim.index(), req);
+			std::sort(req.begin(), req.end(), [](dcon::technology_id a, dcon::technology_id b) { return a.index() < b.index(); });
+			req.erase(std::unique(req.begin(), req.end()), req.end());
+			for(auto t : req)
+				gated_inventions[t.index()].push_back(i);
+		}
+	});
+
+	nation_count = state.world.nation_size();
+	words = (nation_count + 63) / 64;
+	bits.assign(size_t(words) * state.world.invention_size(), 0);
+	built = true;
+
+	state.world.for_each_nation([&](dcon::nation_id n) {
+		update_nation(state, n);
+	});
+}
+
+bool invention_candidate_sets::is_candidate(sys::state& state, dcon::nation_id n, dcon::invention_id i) const {
+	if(!state.world.nation_is_valid(n) || state.world.nation_get_active_inventions(n, i))
+		return false;
+	for(auto t : requirements[i.index()]) {
+		if(!state.world.nation_get_active_technologies(n, t))
+			return false;
+	}
+	return true;
+}
+
+void invention_candidate_sets::set_candidate(dcon::nation_id n, dcon::invention_id i, bool value) {
+	auto& word = bits[size_t(i.index()) * words + n.index() / 64];
+	auto bit = uint64_t(1) << (n.index() & 63);
+	word = value ? (word | bit) : (word & ~bit);
+}
+
+void invention_candidate_sets::update_nation(sys::state& state, dcon::nation_id n) {
+	if(!built)
+		return;
+	if(uint32_t(n.index()) >= nation_count) { // a new nation; start over on next use
+		built = false;
+		return;
+	}
+	state.world.for_each_invention([&](dcon::invention_id i) {
+		set_candidate(n, i, is_candidate(state, n, i));
+	});
+}
+
+void invention_candidate_sets::technology_changed(sys::state& state, dcon::nation_id n, dcon::technology_id t) {
+	if(!built)
+		return;
+	if(uint32_t(n.index()) >= nation_count) {
+		built = false;
+		return;
+	}
+	for(auto i : gated_inventions[t.index()]) {
+		set_candidate(n, i, is_candidate(state, n, i));
+	}
+}
+
+void invention_candidate_sets::invention_changed(sys::state& state, dcon::nation_id n, dcon::invention_id i) {
+	if(!built)
+		return;
+	if(uint32_t(n.index()) >= nation_count) {
+		built = false;
+		return;
+	}
+	set_candidate(n, i, is_candidate(state, n, i));
+}
+
 void discover_inventions(sys::state& state) {
 	/*
 	Inventions have a chance to be discovered on the 1st of every month. The invention chance modifier is computed additively, and the result is the chance out of 100 that the invention will be discovered. When an invention with shared prestige is discovered, the discoverer gains that amount of shared prestige / the number of times it has been discovered (including the current time).
 	*/
-	for(auto inv : state.world.in_invention) {
+
+	/*
+	The inventions are rolled for in parallel, each against the state of the world at the start of the tick, and the discoveries
+	are then applied in order of invention and then of nation. Only the blocks of nations that contain a candidate for the
+	invention are evaluated at all.
+	*/
+	auto& candidates = state.invention_candidates;
+	if(!candidates.is_current(state))
+		candidates.rebuild(state);
+
+	static std::vector<std::vector<dcon::nation_id>> discoveries;
+	discoveries.resize(state.world.invention_size());
+
+	static_assert(ve::vector_size < 64 && 64 % ve::vector_size == 0);
+	constexpr uint64_t block_mask = (uint64_t(1) << ve::vector_size) - 1;
+
+	concurrency::parallel_for(uint32_t(0), state.world.invention_size(), [&](uint32_t index) {
+		auto inv = fatten(state.world, dcon::invention_id{ dcon::invention_id::value_base_t(index) });
+		auto& found = discoveries[index];
+		found.clear();
+
 		auto lim = inv.get_limit();
 		auto odds = inv.get_chance();
 		assert(odds);
-		if(lim) {
-			ve::execute_serial_fast<dcon::nation_id>(state.world.nation_size(), [&](auto nids) {
-				auto may_not_discover =
-					state.world.nation_get_active_inventions(nids, inv) || (state.world.nation_get_owned_province_count(nids) == 0) || !trigger::evaluate(state, lim, trigger::to_generic(nids), trigger::to_generic(nids), 0);
-				if(ve::compress_mask(may_not_discover).v != 0) {
-					auto chances = trigger::evaluate_additive_modifier(state, odds, trigger::to_generic(nids), trigger::to_generic(nids), 0);
-					ve::apply([&](dcon::nation_id n, float chance, bool block_discovery) {
-						if(!block_discovery) {
-							auto random = rng::get_random(state, uint32_t(inv.id.index()) << 5 ^ uint32_t(n.index()));
-							if(int32_t(random % 100) < int32_t(chance)) {
-								apply_invention(state, n, inv);
-								// TODO: notify player
-							}
-						}
-					}, nids, chances, may_not_discover);
-				}
-			});
-		} else {
-			ve::execute_serial_fast<dcon::nation_id>(state.world.nation_size(), [&](auto nids) {
-				auto may_not_discover =
-					state.world.nation_get_active_inventions(nids, inv) || (state.world.nation_get_owned_province_count(nids) == 0);
-				if(ve::compress_mask(may_not_discover).v != 0) {
-					auto chances = trigger::evaluate_additive_modifier(state, odds, trigger::to_generic(nids), trigger::to_generic(nids), 0);
-					ve::apply([&](dcon::nation_id n, float chance, bool block_discovery) {
-						if(!block_discovery) {
-							auto random = rng::get_random(state, uint32_t(inv.id.index()) << 5 ^ uint32_t(n.index()));
-							if(int32_t(random % 100) < int32_t(chance)) {
-								apply_invention(state, n, inv);
-								// TODO: notify player
-							}
-						}
-					}, nids, chances, may_not_discover);
-				}
-			});
+
+		auto candidate_words = candidates.candidates(inv);
+		for(uint32_t w = 0; w < candidates.word_count(); ++w) {
+			if(candidate_words[w] == 0)
+				continue;
+			for(uint32_t offset = 0; offset < 64; offset += ve::vector_size) {
+				auto block_bits = (candidate_words[w] >> offset) & block_mask;
+				if(block_bits == 0)
+					continue;
+
+				auto first = int32_t(w * 64 + offset);
+				ve::contiguous_tags<dcon::nation_id> nids(first);
+				auto may_discover = lim
+					? (state.world.nation_get_owned_province_count(nids) != 0) && trigger::evaluate(state, lim, trigger::to_generic(nids), trigger::to_generic(nids), 0)
+					: (state.world.nation_get_owned_province_count(nids) != 0);
+				// as before, a block is only rolled for when at least one nation in it may *not* discover the invention
+				auto may_not_discover = state.world.nation_get_active_inventions(nids, inv) || !may_discover;
+				if(ve::compress_mask(may_not_discover).v == 0 || ve::compress_mask(may_discover).v == 0)
+					continue;
+
+				auto chances = trigger::evaluate_additive_modifier(state, odds, trigger::to_generic(nids), trigger::to_generic(nids), 0);
+				ve::apply([&](dcon::nation_id n, float chance, bool allowed) {
+					if(allowed && ((block_bits >> (n.index() - first)) & 1) != 0) {
+						auto random = rng::get_random(state, uint32_t(inv.id.index()) << 5 ^ uint32_t(n.index()));
+						if(int32_t(random % 100) < int32_t(chance))
+							found.push_back(n);
+					}
+				}, nids, chances, may_discover);
+			}
+		}
+	});
+
+	for(uint32_t index = 0; index < state.world.invention_size(); ++index) {
+		dcon::invention_id inv{ dcon::invention_id::value_base_t(index) };
+		for(auto n : discoveries[index]) {
+			apply_invention(state, n, inv);
+			// TODO: notify player
 		}
 	}
 }
@@ -153,6 +153,43 @@ enum class rebel_independence : uint8_t {
 	none = 0, culture, culture_group, religion, colonial, any, pan_nationalist
 };
 
+/*
+For each invention, the set of nations that could still discover it: those that have not discovered it yet and that have every
+technology that its limit trigger unconditionally requires. The sets are kept up to date by the functions that apply and remove
+technologies and inventions, so that the monthly discovery pass only has to evaluate triggers for blocks of nations that contain
+a candidate. They are not saved, and are rebuilt on first use after being invalidated.
+*/
+class invention_candidate_sets {
+public:
+	void invalidate() {
+		built = false;
+	}
+	bool is_current(sys::state const& state) const;
+	void rebuild(sys::state& state);
+
+	void update_nation(sys::state& state, dcon::nation_id n); // after changing many technologies or inventions at once
+	void technology_changed(sys::state& state, dcon::nation_id n, dcon::technology_id t);
+	void invention_changed(sys::state& state, dcon::nation_id n, dcon::invention_id i);
+
+	uint32_t word_count() const {
+		return words;
+	}
+	uint64_t const* candidates(dcon::invention_id i) const { // word_count() words, one bit per nation
+		return bits.data() + size_t(i.index()) * words;
+	}
+
+private:
+	bool is_candidate(sys::state& state, dcon::nation_id n, dcon::invention_id i) const;
+	void set_candidate(dcon::nation_id n, dcon::invention_id i, bool value);
+
+	std::vector<uint64_t> bits; // by invention, then by nation
+	std::vector<std::vector<dcon::technology_id>> requirements; // by invention
+	std::vector<std::vector<dcon::invention_id>> gated_inventions; // by technology: the inventions that require it
+	uint32_t words = 0;
+	uint32_t nation_count = 0;
+	bool built = false;
+};
+
 // these functions are to be called only after loading a save
 void repopulate_technology_effects(sys::state& state);
 void repopulate_invention_effects(sys::state& state);
@@ -371,6 +371,19 @@ void change_government_type(sys::state& state, dcon::nation_id n, dcon::governme
 	}
 }
 
+void restore_unsaved_values(sys::state& state) {
+	// built here rather than on first use, as the upper house is recalculated for many nations in parallel
+	auto m = std::make_unique<support_matrix>();
+	m->rows = state.world.ideology_size();
+	for(auto i : state.world.in_ideology)
+		m->keys.push_back(pop_demographics::to_key(state, i));
+	m->issue_weights.assign(m->keys.size() * m->rows, 0.0f);
+	m->ideology_weights.assign(m->keys.size() * m->rows, 0.0f);
+	for(uint32_t i = 0; i < m->rows; ++i)
+		m->issue_weights[i * m->rows + i] = 1.0f;
+	state.ideology_support = std::move(m);
+}
+
 float pop_vote_weight(sys::state& state, dcon::pop_id p, dcon::nation_id n) {
 	/*
 	When a pop's "votes" in any form, the weight of that vote is the product of the size of the pop and the national modifier for voting for their strata (this could easily result in a strata having no votes). If the nation has primary culture voting set then primary culture pops get a full vote, accepted culture pops get a half vote, and other culture pops get no vote. If it has culture voting, primary and accepted culture pops get a full vote and no one else gets a vote. If neither is set, all pops get an equal vote.
@@ -413,12 +426,51 @@ float pop_vote_weight(sys::state& state, dcon::pop_id p, dcon::nation_id n) {
 	}
 }
 
+void support_matrix::accumulate(sys::state& state, dcon::pop_id p, float weight, float ideological_share, float* out) const {
+	auto const issue_share = weight * (1.0f - ideological_share);
+	auto const ideology_share = weight * ideological_share;
+	for(uint32_t k = 0; k < uint32_t(keys.size()); ++k) {
+		auto v = state.world.pop_get_demographics(p, keys[k]);
+		if(v == 0.0f)
+			continue;
+		auto iv = v * issue_share;
+		auto dv = v * ideology_share;
+		float const* iw = issue_weights.data() + k * rows;
+		float const* dw = ideology_weights.data() + k * rows;
+		for(uint32_t r = 0; r < rows; ++r)
+			out[r] += iw[r] * iv + dw[r] * dv;
+	}
+}
+
+namespace impl {
+uint32_t key_column(std::vector<dcon::pop_demographics_key>& keys, dcon::pop_demographics_key k) {
+	for(uint32_t i = 0; i < uint32_t(keys.size()); ++i) {
+		if(keys[i] == k)
+			return i;
+	}
+	keys.push_back(k);
+	return uint32_t(keys.size() - 1);
+}
+
+// the multiplier a province applies to the votes for each party: loyalty to its ideology, number of voters and ruling party support
+void party_vote_factors(sys::state& state, party_support_table const& table, dcon::province_id prov_id, float* out) {
+	float ruling_party_support = state.world.province_get_modifier_values(prov_id, sys::provincial_mod_offsets::local_ruling_party_support) + state.world.nation_get_modifier_values(table.nation, sys::national_mod_offsets::ruling_party_support) + 1.0f;
+	float prov_vote_mod = state.world.province_get_modifier_values(prov_id, sys::provincial_mod_offsets::number_of_voters) + 1.0f;
+	auto ruling_party = state.world.nation_get_ruling_party(table.nation);
+	for(uint32_t r = 0; r < uint32_t(table.parties.size()); ++r) {
+		auto pid = state.world.political_party_get_ideology(table.parties[r]);
+		out[r] = (state.world.province_get_party_loyalty(prov_id, pid) + 1.0f) * prov_vote_mod * (table.parties[r] == ruling_party ? ruling_party_support : 1.0f);
+	}
+}
+}
+
 void recalculate_upper_house(sys::state& state, dcon::nation_id n) {
 	/*
 	Every year, the upper house of each nation is updated. If the "same as ruling party" rule is set, the upper house becomes 100% the ideology of the ruling party. If the rule is "state vote", then for each non-colonial state: for each pop in the state that is not prevented from voting by its type we distribute its weighted vote proportionally to its ideology support, giving us an ideology distribution for each of those states. The state ideology distributions are then normalized and summed to form the distribution for the upper house. For "population_vote" and "rich_only" the voting weight of each non colonial pop (or just the rich ones for "rich only") is distributed proportionally to its ideological support, with the sum for all eligible pops forming the distribution for the upper house.
 	*/
-	static std::vector<float> accumulated_in_state;
-	accumulated_in_state.resize(state.world.ideology_size());
+	assert(state.ideology_support);
+	auto const& m = *state.ideology_support;
+	std::vector<float> accumulated(state.world.ideology_size(), 0.0f);
 
 	auto rules = state.world.nation_get_combined_issue_rules(n);
 	if((rules & issue_rule::same_as_ruling_party) != 0) {
@@ -428,96 +480,58 @@ void recalculate_upper_house(sys::state& state, dcon::nation_id n) {
 		}
 		state.world.nation_set_upper_house(n, rp_ideology, 100.0f);
 	} else if((rules & issue_rule::state_vote) != 0) {
-		for(auto i : state.world.in_ideology) {
-			state.world.nation_set_upper_house(n, i, 0.0f);
-		}
+		std::vector<float> accumulated_in_state(state.world.ideology_size(), 0.0f);
 		float state_total = 0.0f;
-		
+
 		for(auto si : state.world.nation_get_state_ownership(n)) {
 			if(si.get_state().get_capital().get_is_colonial())
 				continue; // skip colonial states
 
-			for(auto i : state.world.in_ideology) {
-				accumulated_in_state[i.id.index()] = 0.0f;
-			}
+			std::fill(accumulated_in_state.begin(), accumulated_in_state.end(), 0.0f);
 			float total = 0.0f;
 			province::for_each_province_in_state_instance(state, si.get_state(), [&](dcon::province_id p) {
 				for(auto pop : state.world.province_get_pop_location(p)) {
 					auto weight = pop_vote_weight(state, pop.get_pop(), n);
 					if(weight > 0) {
 						total += weight;
-						for(auto i : state.world.in_ideology) {
-							accumulated_in_state[i.id.index()] += weight * state.world.pop_get_demographics(pop.get_pop(), pop_demographics::to_key(state, i));
-						}
+						m.accumulate(state, pop.get_pop(), weight, 0.0f, accumulated_in_state.data());
 					}
 				}
 			});
 			if(total > 0) {
-				for(auto i : state.world.in_ideology) {
-					auto scaled = accumulated_in_state[i.id.index()] / total;
+				for(uint32_t i = 0; i < uint32_t(accumulated.size()); ++i) {
+					auto scaled = accumulated_in_state[i] / total;
 					state_total += scaled;
-					state.world.nation_get_upper_house(n, i) += scaled;
+					accumulated[i] += scaled;
 				}
 			}
 		}
 
-		if(state_total > 0) {
-			auto scale_factor = 100.0f / state_total;
-			for(auto i : state.world.in_ideology) {
-				state.world.nation_get_upper_house(n, i) *= scale_factor;
-			}
-		}
-	} else if((rules & issue_rule::rich_only) != 0) {
+		auto scale_factor = state_total > 0 ? 100.0f / state_total : 1.0f;
 		for(auto i : state.world.in_ideology) {
-			state.world.nation_set_upper_house(n, i, 0.0f);
-		}
-		float total = 0.0f;
-		for(auto p : state.world.nation_get_province_ownership(n)) {
-			if(p.get_province().get_is_colonial())
-				continue; // skip colonial provinces
-
-			for(auto pop : state.world.province_get_pop_location(p.get_province())) {
-				if(pop.get_pop().get_poptype().get_strata() == uint8_t(culture::pop_strata::rich)) {
-					auto weight = pop_vote_weight(state, pop.get_pop(), n);
-					if(weight > 0) {
-						total += weight;
-						for(auto i : state.world.in_ideology) {
-							state.world.nation_get_upper_house(n, i) += weight * state.world.pop_get_demographics(pop.get_pop(), pop_demographics::to_key(state, i));
-						}
-					}
-				}
-			}
-		}
-		if(total > 0) {
-			auto scale_factor = 100.0f / total;
-			for(auto i : state.world.in_ideology) {
-				state.world.nation_get_upper_house(n, i) *= scale_factor;
-			}
+			state.world.nation_set_upper_house(n, i, accumulated[i.id.index()] * scale_factor);
 		}
 	} else {
-		for(auto i : state.world.in_ideology) {
-			state.world.nation_set_upper_house(n, i, 0.0f);
-		}
+		bool rich_only = (rules & issue_rule::rich_only) != 0;
 		float total = 0.0f;
 		for(auto p : state.world.nation_get_province_ownership(n)) {
 			if(p.get_province().get_is_colonial())
 				continue; // skip colonial provinces
 
 			for(auto pop : state.world.province_get_pop_location(p.get_province())) {
+				if(rich_only && pop.get_pop().get_poptype().get_strata() != uint8_t(culture::pop_strata::rich))
+					continue;
 				auto weight = pop_vote_weight(state, pop.get_pop(), n);
 				if(weight > 0) {
 					total += weight;
-					for(auto i : state.world.in_ideology) {
-						state.world.nation_get_upper_house(n, i) += weight * state.world.pop_get_demographics(pop.get_pop(), pop_demographics::to_key(state, i));
-					}
+					m.accumulate(state, pop.get_pop(), weight, 0.0f, accumulated.data());
 				}
 			}
 		}
-		if(total > 0) {
-			auto scale_factor = 100.0f / total;
-			for(auto i : state.world.in_ideology) {
-				state.world.nation_get_upper_house(n, i) *= scale_factor;
-			}
+
+		auto scale_factor = total > 0 ? 100.0f / total : 1.0f;
+		for(auto i : state.world.in_ideology) {
+			state.world.nation_set_upper_house(n, i, accumulated[i.id.index()] * scale_factor);
 		}
 	}
 
@@ -536,35 +550,58 @@ void daily_party_loyalty_update(sys::state& state) {
 	});
 }
 
-float party_total_support(sys::state& state, dcon::pop_id pop, dcon::political_party_id par_id, dcon::nation_id nat_id, dcon::province_id prov_id) {
-	auto n = dcon::fatten(state.world, nat_id);
-	auto p = dcon::fatten(state.world, prov_id);
+void make_party_support_table(sys::state& state, dcon::nation_id n, party_support_table& table) {
+	table.nation = n;
+	table.parties.clear();
 
-	auto weight = pop_vote_weight(state, pop, n);
-	if(weight > 0.f) {
-		auto ideological_share = state.world.pop_get_consciousness(pop) / 20.0f;
-
-		float ruling_party_support = p.get_modifier_values(sys::provincial_mod_offsets::local_ruling_party_support) + n.get_modifier_values(sys::national_mod_offsets::ruling_party_support) + 1.0f;
-		float prov_vote_mod = p.get_modifier_values(sys::provincial_mod_offsets::number_of_voters) + 1.0f;
+	auto tag = state.world.nation_get_identity_from_identity_holder(n);
+	auto start = state.world.national_identity_get_political_party_first(tag).id.index();
+	auto end = start + state.world.national_identity_get_political_party_count(tag);
+	for(int32_t i = start; i < end; i++) {
+		auto pid = dcon::political_party_id(dcon::political_party_id::value_base_t(i));
+		if(politics::political_party_is_active(state, pid)) {
+			table.parties.push_back(pid);
+		}
+	}
 
-		auto pid = state.world.political_party_get_ideology(par_id);
-		auto base_support = (p.get_party_loyalty(pid) + 1.0f) * prov_vote_mod * (par_id == n.get_ruling_party() ? ruling_party_support : 1.0f) * weight;
-		auto issue_support = 0.0f;
+	/*
+	- For each party we do the following: figure out the pop's ideological support for the party and its issues based support for the party (by summing up its support for each issue that the party has set, except that pops of non-accepted cultures will never support more restrictive culture voting parties). The pop then votes for the party (i.e. contributes its voting weight in support) based on the sum of its issue and ideological support, except that the greater consciousness the pop has, the more its vote is based on ideological support (pops with 0 consciousness vote based on issues alone).
+	*/
+	auto& m = table.matrix;
+	m.rows = uint32_t(table.parties.size());
+	m.keys.clear();
+	for(auto par : table.parties) {
 		for(auto pi : state.culture_definitions.party_issues) {
-			auto party_pos = state.world.political_party_get_party_issues(par_id, pi);
-			issue_support += state.world.pop_get_demographics(pop, pop_demographics::to_key(state, party_pos));
+			impl::key_column(m.keys, pop_demographics::to_key(state, state.world.political_party_get_party_issues(par, pi)));
 		}
-		auto ideology_support = state.world.pop_get_demographics(pop, pop_demographics::to_key(state, pid));
-		return base_support * (issue_support * (1.0f - ideological_share) + ideology_support * ideological_share);
-	} else {
-		return 0.f;
+		impl::key_column(m.keys, pop_demographics::to_key(state, state.world.political_party_get_ideology(par)));
+	}
+	m.issue_weights.assign(m.keys.size() * m.rows, 0.0f);
+	m.ideology_weights.assign(m.keys.size() * m.rows, 0.0f);
+	for(uint32_t r = 0; r < m.rows; ++r) {
+		auto par = table.parties[r];
+		for(auto pi : state.culture_definitions.party_issues) {
+			auto k = impl::key_column(m.keys, pop_demographics::to_key(state, state.world.political_party_get_party_issues(par, pi)));
+			m.issue_weights[k * m.rows + r] += 1.0f;
+		}
+		auto k = impl::key_column(m.keys, pop_demographics::to_key(state, state.world.political_party_get_ideology(par)));
+		m.ideology_weights[k * m.rows + r] += 1.0f;
 	}
 }
 
-struct party_vote {
-	dcon::political_party_id par;
-	float vote = 0.0f;
-};
+void accumulate_party_support(sys::state& state, party_support_table const& table, dcon::pop_id pop, dcon::province_id prov_id, float* out, party_vote_scratch& scratch) {
+	auto weight = pop_vote_weight(state, pop, table.nation);
+	if(weight <= 0.0f)
+		return;
+
+	scratch.support.assign(table.parties.size(), 0.0f);
+	scratch.factors.resize(table.parties.size());
+
+	table.matrix.accumulate(state, pop, weight, state.world.pop_get_consciousness(pop) / 20.0f, scratch.support.data());
+	impl::party_vote_factors(state, table, prov_id, scratch.factors.data());
+	for(uint32_t r = 0; r < uint32_t(table.parties.size()); ++r)
+		out[r] += scratch.support[r] * scratch.factors[r];
+}
 
 void start_election(sys::state& state, dcon::nation_id n) {
 	if(state.world.nation_get_election_ends(n) < state.current_date) {
@@ -574,8 +611,11 @@ void start_election(sys::state& state, dcon::nation_id n) {
 }
 
 void update_elections(sys::state& state) {
-	static std::vector<party_vote> party_votes;
-	static std::vector<party_vote> provincial_party_votes;
+	static party_support_table table;
+	static std::vector<float> party_votes;
+	static std::vector<dcon::province_id> provinces;
+	static std::vector<float> provincial_party_votes;
+	static std::vector<float> provincial_factors;
 
 	for(auto n : state.world.in_nation) {
 		/*
@@ -586,61 +626,47 @@ void update_elections(sys::state& state) {
 			if(n.get_election_ends() == state.current_date) {
 				// make election results
 
-				party_votes.clear();
-				float total_vote = 0.0f;
-
-				auto tag = state.world.nation_get_identity_from_identity_holder(n);
-				auto start = state.world.national_identity_get_political_party_first(tag).id.index();
-				auto end = start + state.world.national_identity_get_political_party_count(tag);
-
-				for(int32_t i = start; i < end; i++) {
-					auto pid = dcon::political_party_id(dcon::political_party_id::value_base_t(i));
-					if(politics::political_party_is_active(state, pid)) {
-						party_votes.push_back(party_vote{pid, 0.0f});
-					}
-				}
-
-				if(party_votes.size() == 0)
+				make_party_support_table(state, n, table);
+				if(table.parties.size() == 0)
 					std::abort(); // ERROR: no valid parties
 
-				// - Determine the vote in each province. Note that voting is *by active party* not by ideology.
-				for(auto p : n.get_province_ownership()) {
-					if(p.get_province().get_is_colonial())
-						continue; // skip colonial provinces
-
-					provincial_party_votes.clear();
-					float province_total = 0.0f;
-					for(auto& par : party_votes) {
-						provincial_party_votes.push_back(party_vote{ par.par, 0.0f });
-					}
+				auto const party_count = uint32_t(table.parties.size());
+				party_votes.assign(party_count, 0.0f);
 
-					float ruling_party_support = p.get_province().get_modifier_values(sys::provincial_mod_offsets::local_ruling_party_support) + n.get_modifier_values(sys::national_mod_offsets::ruling_party_support) + 1.0f;
-					float prov_vote_mod = p.get_province().get_modifier_values(sys::provincial_mod_offsets::number_of_voters) + 1.0f;
+				provinces.clear();
+				for(auto p : n.get_province_ownership()) {
+					if(!p.get_province().get_is_colonial()) // skip colonial provinces
+						provinces.push_back(p.get_province());
+				}
 
-					for(auto pop : p.get_province().get_pop_location()) {
+				/*
+				- Determine the vote in each province. Note that voting is *by active party* not by ideology.
+				- The support for the party is then multiplied by (provincial-modifier-ruling-party-support + national-modifier-ruling-party-support + 1), if it is the ruling party, and by (1 + province-party-loyalty) for its ideology.
+				- Pop votes are also multiplied by (provincial-modifier-number-of-voters + 1)
+				*/
+				provincial_party_votes.assign(provinces.size() * party_count, 0.0f);
+				provincial_factors.resize(provinces.size() * party_count);
+				concurrency::parallel_for(uint32_t(0), uint32_t(provinces.size()), [&](uint32_t i) {
+					float* votes = provincial_party_votes.data() + i * party_count;
+					float* factors = provincial_factors.data() + i * party_count;
+					for(auto pop : state.world.province_get_pop_location(provinces[i])) {
 						auto weight = pop_vote_weight(state, pop.get_pop(), n);
 						if(weight > 0) {
-							auto ideological_share = pop.get_pop().get_consciousness() / 20.0f;
-							for(auto& par : provincial_party_votes) {
-								/*
-								- For each party we do the following: figure out the pop's ideological support for the party and its issues based support for the party (by summing up its support for each issue that the party has set, except that pops of non-accepted cultures will never support more restrictive culture voting parties). The pop then votes for the party (i.e. contributes its voting weight in support) based on the sum of its issue and ideological support, except that the greater consciousness the pop has, the more its vote is based on ideological support (pops with 0 consciousness vote based on issues alone). The support for the party is then multiplied by (provincial-modifier-ruling-party-support + national-modifier-ruling-party-support + 1), if it is the ruling party, and by (1 + province-party-loyalty) for its ideology.
-								- Pop votes are also multiplied by (provincial-modifier-number-of-voters + 1)
-								*/
-								auto pid = state.world.political_party_get_ideology(par.par);
-								auto base_support = (p.get_province().get_party_loyalty(pid) + 1.0f) * prov_vote_mod * (par.par == n.get_ruling_party() ? ruling_party_support : 1.0f) * weight;
-								auto issue_support = 0.0f;
-								for(auto pi : state.culture_definitions.party_issues) {
-									auto party_pos = state.world.political_party_get_party_issues(par.par, pi);
-									issue_support += pop.get_pop().get_demographics(pop_demographics::to_key(state, party_pos));
-								}
-								auto ideology_support = pop.get_pop().get_demographics(pop_demographics::to_key(state, pid));
-								auto total_support = base_support * (issue_support * (1.0f - ideological_share) + ideology_support * ideological_share);
-
-								province_total += total_support;
-								par.vote += total_support;
-							}
+							table.matrix.accumulate(state, pop.get_pop(), weight, pop.get_pop().get_consciousness() / 20.0f, votes);
 						}
 					}
+					// the province multipliers are the same for every pop, so they are applied once to the sums
+					impl::party_vote_factors(state, table, provinces[i], factors);
+					for(uint32_t r = 0; r < party_count; ++r)
+						votes[r] *= factors[r];
+				});
+
+				auto national_rule = n.get_combined_issue_rules();
+				for(uint32_t i = 0; i < uint32_t(provinces.size()); ++i) {
+					float const* votes = provincial_party_votes.data() + i * party_count;
+					float province_total = 0.0f;
+					for(uint32_t r = 0; r < party_count; ++r)
+						province_total += votes[r];
 
 					if(province_total > 0) {
 						/*
@@ -649,32 +675,30 @@ void update_elections(sys::state& state) {
 						*/
 
 						uint32_t winner = 0;
-						float winner_amount = provincial_party_votes[0].vote;
-						for(uint32_t i = 1; i < provincial_party_votes.size(); ++i) {
-							if(provincial_party_votes[i].vote > winner_amount) {
-								winner = i;
-								winner_amount = provincial_party_votes[i].vote;
+						float winner_amount = votes[0];
+						for(uint32_t r = 1; r < party_count; ++r) {
+							if(votes[r] > winner_amount) {
+								winner = r;
+								winner_amount = votes[r];
 							}
 						}
 
-						auto pid = state.world.political_party_get_ideology(provincial_party_votes[winner].par);
-						auto& l = p.get_province().get_party_loyalty(pid);
-						l = std::clamp(l + state.defines.loyalty_boost_on_party_win * (p.get_province().get_modifier_values(sys::provincial_mod_offsets::boost_strongest_party) + 1.0f) * winner_amount / province_total, -1.0f, 1.0f);
-						auto national_rule = n.get_combined_issue_rules();
+						auto pid = state.world.political_party_get_ideology(table.parties[winner]);
+						auto& l = state.world.province_get_party_loyalty(provinces[i], pid);
+						l = std::clamp(l + state.defines.loyalty_boost_on_party_win * (state.world.province_get_modifier_values(provinces[i], sys::provincial_mod_offsets::boost_strongest_party) + 1.0f) * winner_amount / province_total, -1.0f, 1.0f);
 
 						if((national_rule & issue_rule::largest_share) != 0) {
-							party_votes[winner].vote += winner_amount;
+							party_votes[winner] += winner_amount;
 						} else if((national_rule & issue_rule::dhont) != 0) {
-							for(uint32_t i = 0; i < provincial_party_votes.size(); ++i) {
-								party_votes[i].vote += provincial_party_votes[i].vote / province_total;
+							for(uint32_t r = 0; r < party_count; ++r) {
+								party_votes[r] += votes[r] / province_total;
 							}
 						} else /*if((national_rule & issue_rule::sainte_laque) != 0)*/ {
-							for(uint32_t i = 0; i < provincial_party_votes.size(); ++i) {
-								party_votes[i].vote += provincial_party_votes[i].vote;
+							for(uint32_t r = 0; r < party_count; ++r) {
+								party_votes[r] += votes[r];
 							}
 						}
 					}
-					
 				}
 
 				/*
@@ -690,7 +714,7 @@ void update_elections(sys::state& state) {
 						per_group.set(ig, 0.0f);
 					}
 					for(uint32_t i = 0; i < party_votes.size(); ++i) {
-						per_group.get(state.world.ideology_get_ideology_group_from_ideology_group_membership(state.world.political_party_get_ideology(party_votes[i].par))) += party_votes[i].vote;
+						per_group.get(state.world.ideology_get_ideology_group_from_ideology_group_membership(state.world.political_party_get_ideology(table.parties[i]))) += party_votes[i];
 					}
 					dcon::ideology_group_id winner;
 					float winner_amount = -1.0f;
@@ -704,24 +728,24 @@ void update_elections(sys::state& state) {
 					uint32_t winner_b = 0;
 					float winner_amount_b = -1.0f;
 					for(uint32_t i = 0; i < party_votes.size(); ++i) {
-						if(state.world.ideology_get_ideology_group_from_ideology_group_membership(state.world.political_party_get_ideology(party_votes[i].par)) == winner && party_votes[i].vote > winner_amount_b) {
+						if(state.world.ideology_get_ideology_group_from_ideology_group_membership(state.world.political_party_get_ideology(table.parties[i])) == winner && party_votes[i] > winner_amount_b) {
 							winner_b = i;
-							winner_amount_b = party_votes[i].vote;
+							winner_amount_b = party_votes[i];
 						}
 					}
 
-					set_ruling_party(state, n, party_votes[winner_b].par);
+					set_ruling_party(state, n, table.parties[winner_b]);
 				} else {
 					uint32_t winner = 0;
-					float winner_amount = party_votes[0].vote;
+					float winner_amount = party_votes[0];
 					for(uint32_t i = 1; i < party_votes.size(); ++i) {
-						if(party_votes[i].vote > winner_amount) {
+						if(party_votes[i] > winner_amount) {
 							winner = i;
-							winner_amount = party_votes[i].vote;
+							winner_amount = party_votes[i];
 						}
 					}
 
-					set_ruling_party(state, n, party_votes[winner].par);
+					set_ruling_party(state, n, table.parties[winner]);
 				}
 
 			} else if(next_election_date(state, n) <= state.current_date) {
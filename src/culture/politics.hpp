@@ -4,6 +4,7 @@
 #include "dcon_generated.hpp"
 #include "system_state.hpp"
 #include <string_view>
+#include <vector>
 
 namespace politics {
 
@@ -44,7 +45,40 @@ void change_government_type(sys::state& state, dcon::nation_id n, dcon::governme
 // this function sets the upper house (for example, as when performing the yearly upper house update)
 void recalculate_upper_house(sys::state& state, dcon::nation_id n);
 
-float party_total_support(sys::state& state, dcon::pop_id pop, dcon::political_party_id par_id, dcon::nation_id nat_id, dcon::province_id prov_id);
+/*
+Support of a pop for a set of rows (parties or ideologies), stored as weights over just the pop demographics keys that some row
+depends on. Evaluating it loads each of those keys once per pop and forms a small dense dot product for every row, instead of
+looking up each party's positions again for every pop.
+*/
+struct support_matrix {
+	std::vector<dcon::pop_demographics_key> keys;
+	std::vector<float> issue_weights; // column major: keys.size() x rows
+	std::vector<float> ideology_weights; // column major: keys.size() x rows
+	uint32_t rows = 0;
+
+	// adds weight x ((1 - ideological_share) x issue-support + ideological_share x ideology-support) into out[0 .. rows - 1]
+	void accumulate(sys::state& state, dcon::pop_id p, float weight, float ideological_share, float* out) const;
+};
+
+// the active parties of a nation along with the support matrix for voting for them
+struct party_support_table {
+	dcon::nation_id nation;
+	std::vector<dcon::political_party_id> parties;
+	support_matrix matrix;
+};
+
+// rebuilds state.ideology_support: one row per ideology, supported by the pop's support for that ideology
+void restore_unsaved_values(sys::state& state);
+
+float pop_vote_weight(sys::state& state, dcon::pop_id p, dcon::nation_id n);
+void make_party_support_table(sys::state& state, dcon::nation_id n, party_support_table& table);
+// working space for accumulate_party_support; each caller (or task) that may run alongside another needs its own
+struct party_vote_scratch {
+	std::vector<float> support;
+	std::vector<float> factors;
+};
+// adds the vote that pop would cast for each party of the table into out (in table order)
+void accumulate_party_support(sys::state& state, party_support_table const& table, dcon::pop_id pop, dcon::province_id prov_id, float* out, party_vote_scratch& scratch);
 void update_elections(sys::state& state);
 void daily_party_loyalty_update(sys::state& state);
 void start_election(sys::state& state, dcon::nation_id n);
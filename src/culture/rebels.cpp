@@ -21,6 +21,26 @@ dcon::movement_id get_movement_by_independence(sys::state& state, dcon::nation_i
 	return dcon::movement_id{};
 }
 
+void update_flashpoint_movements(sys::state& state) {
+	/*
+	Rather than each flashpoint state walking the movements of its owner looking for one with its tag, each independence movement
+	visits the states of the nation it is within and marks those with a matching flashpoint tag. Since movements are compactable,
+	and may be removed by commands at any time, the result is only good until the next movement is removed.
+	*/
+	state.world.execute_serial_over_state_instance([&](auto ids) {
+		state.world.state_instance_set_flashpoint_movement(ids, ve::tagged_vector<dcon::movement_id>());
+	});
+	for(auto m : state.world.in_movement) {
+		auto tag = m.get_associated_independence();
+		if(!tag)
+			continue;
+		for(auto so : m.get_nation_from_movement_within().get_state_ownership()) {
+			if(so.get_state().get_flashpoint_tag() == tag)
+				so.get_state().set_flashpoint_movement(m);
+		}
+	}
+}
+
 dcon::rebel_faction_id get_faction_by_type(sys::state& state, dcon::nation_id n, dcon::rebel_type_id r) {
 	for(auto f : state.world.nation_get_rebellion_within(n)) {
 		if(f.get_rebels().get_type() == r)
@@ -168,113 +188,199 @@ bool movement_is_valid(sys::state& state, dcon::movement_id m) {
 	return false;
 }
 
-void update_pop_movement_membership(sys::state& state) {
-	state.world.for_each_pop([&](dcon::pop_id p) {
-		auto owner = nations::owner_of_pop(state, p);
-		// pops not in a nation can't be in a movement
-		if(!owner)
-			return;
+namespace impl {
+// every owned pop, grouped by the nation that owns it
+struct pops_by_owner {
+	std::vector<dcon::nation_id> owners; // indexed by pop
+	std::vector<uint32_t> offsets; // the pops of nation n are pops[offsets[n]] .. pops[offsets[n + 1] - 1]
+	std::vector<dcon::pop_id> pops;
 
-		// - Slave pops cannot belong to a movement
-		if(state.world.pop_get_poptype(p) == state.culture_definitions.slaves)
-			return;
-		// pops in rebel factions don't join movements
-		if(state.world.pop_get_pop_rebellion_membership(p))
-			return;
+	void rebuild(sys::state& state);
+};
 
-		auto pop_location = state.world.pop_get_province_from_pop_location(p);
-		//pops in colonial provinces don't join movements
-		if(state.world.province_get_is_colonial(pop_location))
-			return;
+void pops_by_owner::rebuild(sys::state& state) {
+	auto const pop_count = state.world.pop_size();
+	auto const nation_count = state.world.nation_size();
 
-		auto existing_movement = state.world.pop_get_pop_movement_membership(p);
-		auto mil = state.world.pop_get_militancy(p);
+	owners.resize(pop_count);
+	concurrency::parallel_for(uint32_t(0), pop_count, [&](uint32_t i) {
+		owners[i] = nations::owner_of_pop(state, dcon::pop_id{ dcon::pop_id::value_base_t(i) });
+	});
 
-		// -Pops with define : MIL_TO_JOIN_REBEL or greater militancy cannot join a movement
-		if(mil >= state.defines.mil_to_join_rebel) {
-			if(existing_movement) {
-				state.world.movement_get_pop_support(state.world.pop_movement_membership_get_movement(existing_movement)) -= state.world.pop_get_size(p);
-				state.world.delete_pop_movement_membership(existing_movement);
+	// counting sort, so that each nation's pops stay in pop order
+	offsets.assign(nation_count + 1, 0);
+	for(auto o : owners) {
+		if(o)
+			++offsets[o.index() + 1];
+	}
+	for(uint32_t i = 0; i < nation_count; ++i)
+		offsets[i + 1] += offsets[i];
+	pops.resize(offsets[nation_count]);
+	std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+	for(uint32_t i = 0; i < pop_count; ++i) {
+		if(owners[i])
+			pops[cursor[owners[i].index()]++] = dcon::pop_id{ dcon::pop_id::value_base_t(i) };
+	}
+}
+
+enum class movement_action : uint8_t { none, leave_with_support, leave, join_issue, join_independence };
+struct movement_decision {
+	dcon::issue_option_id option;
+	dcon::national_identity_id independence;
+	movement_action action = movement_action::none;
+};
+
+void classify_pop_for_movement(sys::state& state, dcon::pop_id p, dcon::nation_id owner, std::vector<dcon::issue_option_id> const& valid_options, movement_decision& d) {
+	// - Slave pops cannot belong to a movement
+	if(state.world.pop_get_poptype(p) == state.culture_definitions.slaves)
+		return;
+	// pops in rebel factions don't join movements
+	if(state.world.pop_get_pop_rebellion_membership(p))
+		return;
+
+	auto pop_location = state.world.pop_get_province_from_pop_location(p);
+	//pops in colonial provinces don't join movements
+	if(state.world.province_get_is_colonial(pop_location))
+		return;
+
+	auto existing_movement = state.world.pop_get_pop_movement_membership(p);
+	auto mil = state.world.pop_get_militancy(p);
+
+	// -Pops with define : MIL_TO_JOIN_REBEL or greater militancy cannot join a movement
+	if(mil >= state.defines.mil_to_join_rebel) {
+		if(existing_movement)
+			d.action = movement_action::leave_with_support;
+		return;
+	}
+	if(existing_movement) {
+		auto i = state.world.movement_get_associated_issue_option(state.world.pop_movement_membership_get_movement(existing_movement));
+		if(i) {
+			auto support = state.world.pop_get_demographics(p, pop_demographics::to_key(state, i));
+			if(support * 100.0f < state.defines.issue_movement_leave_limit) {
+				// If the pop's support of the issue for an issue-based movement drops below define:ISSUE_MOVEMENT_LEAVE_LIMIT the pop will leave the movement.
+				d.action = movement_action::leave;
 			}
-			return;
+		} else if(mil < state.defines.nationalist_movement_mil_cap) {
+			// If the pop's militancy falls below define:NATIONALIST_MOVEMENT_MIL_CAP, the pop will leave an independence movement.
+			d.action = movement_action::leave;
 		}
-		if(existing_movement) {
-			auto i = state.world.movement_get_associated_issue_option(state.world.pop_movement_membership_get_movement(existing_movement));
-			if(i) {
-				auto support = state.world.pop_get_demographics(p, pop_demographics::to_key(state, i));
-				if(support * 100.0f < state.defines.issue_movement_leave_limit) {
-					// If the pop's support of the issue for an issue-based movement drops below define:ISSUE_MOVEMENT_LEAVE_LIMIT the pop will leave the movement. 
-					state.world.delete_pop_movement_membership(existing_movement);
-					return;
-				}
-			} else if(mil < state.defines.nationalist_movement_mil_cap) {
-				// If the pop's militancy falls below define:NATIONALIST_MOVEMENT_MIL_CAP, the pop will leave an independence movement.
-				state.world.delete_pop_movement_membership(existing_movement);
-				return;
+		// otherwise the pop still remains in movement, no more work to do
+		return;
+	}
+
+	auto con = state.world.pop_get_consciousness(p);
+	auto lit = state.world.pop_get_literacy(p);
+
+	// a pop with a consciousness of at least 1.5 or a literacy of at least 0.25 may join a movement
+	if(con >= 1.5 || lit >= 0.25) {
+		/*
+		- If there are one or more issues that the pop supports by at least define:ISSUE_MOVEMENT_JOIN_LIMIT, then the pop has a chance to join an issue-based movement at probability: issue-support x 9 x define:MOVEMENT_LIT_FACTOR x pop-literacy + issue-support x 9 x define:MOVEMENT_CON_FACTOR x pop-consciousness
+		*/
+		dcon::issue_option_id max_option;
+		float max_support = 0;
+		for(auto io : valid_options) {
+			auto sup = state.world.pop_get_demographics(p, pop_demographics::to_key(state, io));
+			if(sup * 100.0f >= state.defines.issue_movement_join_limit && sup > max_support) {
+				max_option = io;
+				max_support = sup;
 			}
-			// pop still remains in movement, no more work to do
-			return;
 		}
 
-		auto con = state.world.pop_get_consciousness(p);
-		auto lit = state.world.pop_get_literacy(p);
+		if(max_option) {
+			d.action = movement_action::join_issue;
+			d.option = max_option;
+			return;
+		}
 
-		// a pop with a consciousness of at least 1.5 or a literacy of at least 0.25 may join a movement
-		if(con >= 1.5 || lit >= 0.25) {
+		if(!state.world.pop_get_is_primary_or_accepted_culture(p) && mil >= state.defines.nationalist_movement_mil_cap) {
 			/*
-			- If there are one or more issues that the pop supports by at least define:ISSUE_MOVEMENT_JOIN_LIMIT, then the pop has a chance to join an issue-based movement at probability: issue-support x 9 x define:MOVEMENT_LIT_FACTOR x pop-literacy + issue-support x 9 x define:MOVEMENT_CON_FACTOR x pop-consciousness
+			- If there are no valid issues, the pop has a militancy of at least define:NATIONALIST_MOVEMENT_MIL_CAP, does not have the primary culture of the nation it is in, and does have the primary culture of some core in its province, then it has a chance (20% ?) of joining an independence movement for such a core.
 			*/
-			dcon::issue_option_id max_option;
-			float max_support = 0;
-			state.world.for_each_issue_option([&](dcon::issue_option_id io) {
-				auto parent = state.world.issue_option_get_parent_issue(io);
-				auto co = state.world.nation_get_issues(owner, parent);
-				auto allow = state.world.issue_option_get_allow(io);
-				if(co != io
-					&& (state.world.issue_get_is_next_step_only(parent) == false || co.id.index() + 1 == io.index() || co.id.index() - 1 == io.index())
-					&& (!allow || trigger::evaluate(state, allow, trigger::to_generic(owner), trigger::to_generic(owner), 0))) {
-					auto sup = state.world.pop_get_demographics(p, pop_demographics::to_key(state, io));
-					if(sup * 100.0f >= state.defines.issue_movement_join_limit && sup > max_support) {
-						max_option = io;
-						max_support = sup;
-					}
+			auto pop_culture = state.world.pop_get_culture(p);
+			for(auto c : state.world.province_get_core(pop_location)) {
+				if(c.get_identity().get_primary_culture() == pop_culture) {
+					d.action = movement_action::join_independence;
+					d.independence = c.get_identity();
+					return;
 				}
-			});
+			}
+		}
+	}
+}
+}
+
+void update_pop_movement_membership(sys::state& state) {
+	/*
+	Decisions are made for every pop in parallel, one nation at a time per task, against the movements as they stand at the start
+	of the update. They are then committed serially in pop order, so a movement created for one pop is found by any later pop
+	of the same nation that wants to join it, exactly as when each pop was handled in turn.
+	*/
+	static impl::pops_by_owner groups;
+	static std::vector<impl::movement_decision> decisions;
+
+	groups.rebuild(state);
+	decisions.assign(state.world.pop_size(), impl::movement_decision{});
+
+	concurrency::parallel_for(uint32_t(0), state.world.nation_size(), [&](uint32_t i) {
+		dcon::nation_id owner{ dcon::nation_id::value_base_t(i) };
+		if(groups.offsets[i] == groups.offsets[i + 1])
+			return;
+
+		// which issue options a movement could form around depends only on the nation
+		std::vector<dcon::issue_option_id> valid_options;
+		state.world.for_each_issue_option([&](dcon::issue_option_id io) {
+			auto parent = state.world.issue_option_get_parent_issue(io);
+			auto co = state.world.nation_get_issues(owner, parent);
+			auto allow = state.world.issue_option_get_allow(io);
+			if(co != io
+				&& (state.world.issue_get_is_next_step_only(parent) == false || co.id.index() + 1 == io.index() || co.id.index() - 1 == io.index())
+				&& (!allow || trigger::evaluate(state, allow, trigger::to_generic(owner), trigger::to_generic(owner), 0))) {
+				valid_options.push_back(io);
+			}
+		});
 
-			if(max_option) {
-				if(auto m = get_movement_by_position(state, owner, max_option); m) {
+		for(uint32_t j = groups.offsets[i]; j < groups.offsets[i + 1]; ++j) {
+			auto p = groups.pops[j];
+			impl::classify_pop_for_movement(state, p, owner, valid_options, decisions[p.index()]);
+		}
+	});
+
+	for(uint32_t i = 0; i < uint32_t(decisions.size()); ++i) {
+		auto const& d = decisions[i];
+		dcon::pop_id p{ dcon::pop_id::value_base_t(i) };
+		auto owner = groups.owners[i];
+
+		switch(d.action) {
+			case impl::movement_action::none:
+				break;
+			case impl::movement_action::leave_with_support:
+				remove_pop_from_movement(state, p);
+				break;
+			case impl::movement_action::leave:
+				state.world.delete_pop_movement_membership(state.world.pop_get_pop_movement_membership(p));
+				break;
+			case impl::movement_action::join_issue:
+				if(auto m = get_movement_by_position(state, owner, d.option); m) {
 					add_pop_to_movement(state, p, m);
-				} else if(issue_is_valid_for_movement(state, owner, max_option)) {
+				} else if(issue_is_valid_for_movement(state, owner, d.option)) {
 					auto new_movement = fatten(state.world, state.world.create_movement());
-					new_movement.set_associated_issue_option(max_option);
+					new_movement.set_associated_issue_option(d.option);
 					state.world.try_create_movement_within(new_movement, owner);
 					add_pop_to_movement(state, p, new_movement);
 				}
-				return;
-			}
-
-			if(!state.world.pop_get_is_primary_or_accepted_culture(p) && mil >= state.defines.nationalist_movement_mil_cap) {
-				/*
-				- If there are no valid issues, the pop has a militancy of at least define:NATIONALIST_MOVEMENT_MIL_CAP, does not have the primary culture of the nation it is in, and does have the primary culture of some core in its province, then it has a chance (20% ?) of joining an independence movement for such a core.
-				*/
-				auto pop_culture = state.world.pop_get_culture(p);
-				for(auto c : state.world.province_get_core(pop_location)) {
-					if(c.get_identity().get_primary_culture() == pop_culture) {
-						auto existing_mov = get_movement_by_independence(state, owner, c.get_identity());
-						if(existing_mov) {
-							state.world.try_create_pop_movement_membership(p, existing_mov);
-						} else {
-							auto new_mov = fatten(state.world, state.world.create_movement());
-							new_mov.set_associated_independence(c.get_identity());
-							state.world.try_create_movement_within(new_mov, owner);
-							state.world.try_create_pop_movement_membership(p, new_mov);
-						}
-						return;
-					}
+				break;
+			case impl::movement_action::join_independence:
+				if(auto existing_mov = get_movement_by_independence(state, owner, d.independence); existing_mov) {
+					state.world.try_create_pop_movement_membership(p, existing_mov);
+				} else {
+					auto new_mov = fatten(state.world, state.world.create_movement());
+					new_mov.set_associated_independence(d.independence);
+					state.world.try_create_movement_within(new_mov, owner);
+					state.world.try_create_pop_movement_membership(p, new_mov);
 				}
-			}
+				break;
 		}
-	});
+	}
 }
 
 void update_movements(sys::state& state) { // updates cached values and then possibly turns movements into rebels
@@ -384,258 +490,277 @@ bool pop_is_compatible_with_rebel_type(sys::state& state, dcon::pop_id p, dcon::
 	return true;
 }
 
-void update_pop_rebel_membership(sys::state& state) {
-	state.world.for_each_pop([&](dcon::pop_id p) {
-		auto owner = nations::owner_of_pop(state, p);
-		// pops not in a nation can't be in a rebel faction
-		if(!owner)
+namespace impl {
+/*
+Fills in the defection target, culture, culture group and religion that a new faction of type rt would have if it were started
+by pop p. Returns false if the pop could not start such a faction.
+*/
+bool configure_faction_for_pop(sys::state& state, dcon::rebel_faction_id f, dcon::rebel_type_id rt, dcon::pop_id p, dcon::national_identity_id ind_tag) {
+	state.world.rebel_faction_set_type(f, rt);
+	state.world.rebel_faction_set_defection_target(f, dcon::national_identity_id{});
+	state.world.rebel_faction_set_primary_culture(f, dcon::culture_id{});
+	state.world.rebel_faction_set_primary_culture_group(f, dcon::culture_group_id{});
+	state.world.rebel_faction_set_religion(f, dcon::religion_id{});
+
+	switch(culture::rebel_defection(state.world.rebel_type_get_defection(rt))) {
+		case culture::rebel_defection::culture:
+			state.world.rebel_faction_set_primary_culture(f, state.world.pop_get_culture(p));
+			state.world.rebel_faction_set_defection_target(f, ind_tag);
+			if(!ind_tag)
+				return false; // no defection possible
+			if(state.world.pop_get_is_primary_or_accepted_culture(p))
+				return false; // can't defect
+			break;
+		case culture::rebel_defection::culture_group:
+			state.world.rebel_faction_set_primary_culture_group(f, state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p)));
+			state.world.rebel_faction_set_defection_target(f, ind_tag);
+			if(!ind_tag)
+				return false; // no defection possible
+			if(state.world.pop_get_is_primary_or_accepted_culture(p))
+				return false; // can't defect
+			break;
+		case culture::rebel_defection::religion:
+			state.world.rebel_faction_set_religion(f, state.world.pop_get_religion(p));
+			state.world.rebel_faction_set_defection_target(f, ind_tag);
+			if(!ind_tag)
+				return false; // no defection possible
+			if(state.world.pop_get_is_primary_or_accepted_culture(p))
+				return false; // can't defect
+			break;
+		case culture::rebel_defection::pan_nationalist:
+		{
+			auto cg = state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p));
+			auto u = state.world.culture_group_get_identity_from_cultural_union_of(cg);
+			if(!u)
+				return false; // no pan nationalist possible
+			state.world.rebel_faction_set_defection_target(f, u);
+			break;
+		}
+		case culture::rebel_defection::any:
+			state.world.rebel_faction_set_defection_target(f, ind_tag);
+			if(!ind_tag)
+				return false; // no defection possible
+			if(state.world.pop_get_is_primary_or_accepted_culture(p))
+				return false; // can't defect
+			break;
+		default:
+			break;
+	}
+
+	switch(culture::rebel_independence(state.world.rebel_type_get_independence(rt))) {
+		case culture::rebel_independence::culture:
+			state.world.rebel_faction_set_primary_culture(f, state.world.pop_get_culture(p));
+			state.world.rebel_faction_set_defection_target(f, ind_tag);
+			if(!ind_tag)
+				return false; // no defection possible
+			if(state.world.pop_get_is_primary_or_accepted_culture(p))
+				return false; // can't defect
+			break;
+		case culture::rebel_independence::culture_group:
+			state.world.rebel_faction_set_primary_culture_group(f, state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p)));
+			state.world.rebel_faction_set_defection_target(f, ind_tag);
+			if(!ind_tag)
+				return false; // no defection possible
+			if(state.world.pop_get_is_primary_or_accepted_culture(p))
+				return false; // can't defect
+			break;
+		case culture::rebel_independence::religion:
+			state.world.rebel_faction_set_religion(f, state.world.pop_get_religion(p));
+			state.world.rebel_faction_set_defection_target(f, ind_tag);
+			if(!ind_tag)
+				return false; // no defection possible
+			if(state.world.pop_get_is_primary_or_accepted_culture(p))
+				return false; // can't defect
+			break;
+		case culture::rebel_independence::pan_nationalist:
+		{
+			auto cg = state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p));
+			auto u = state.world.culture_group_get_identity_from_cultural_union_of(cg);
+			if(!u)
+				return false; // no pan nationalist possible
+			if(state.world.pop_get_is_primary_or_accepted_culture(p))
+				return false; // can't defect
+			state.world.rebel_faction_set_defection_target(f, u);
+			break;
+		}
+		case culture::rebel_independence::any:
+		case culture::rebel_independence::colonial:
+			state.world.rebel_faction_set_defection_target(f, ind_tag);
+			if(!ind_tag)
+				return false; // no defection possible
+			if(state.world.pop_get_is_primary_or_accepted_culture(p))
+				return false; // can't defect
+			break;
+		default:
+			break;
+	}
+	return true;
+}
+
+enum class rebel_action : uint8_t { none, leave, join_existing, join_new };
+struct rebel_decision {
+	dcon::rebel_faction_id faction;
+	dcon::rebel_type_id type;
+	dcon::national_identity_id defection_target;
+	dcon::culture_id primary_culture;
+	dcon::culture_group_id primary_culture_group;
+	dcon::religion_id religion;
+	rebel_action action = rebel_action::none;
+};
+
+void classify_pop_for_rebels(sys::state& state, dcon::pop_id p, dcon::nation_id owner, dcon::rebel_faction_id scratch, rebel_decision& d) {
+	auto mil = state.world.pop_get_militancy(p);
+	auto existing_faction = state.world.pop_get_rebel_faction_from_pop_rebellion_membership(p);
+
+	// - Pops with less than define:MIL_TO_JOIN_REBEL militancy leave their faction
+	if(mil < state.defines.mil_to_join_rebel) {
+		if(existing_faction)
+			d.action = rebel_action::leave;
+		return;
+	}
+	// -Pops with define : MIL_TO_JOIN_REBEL will join a rebel_faction
+	if(existing_faction && !pop_is_compatible_with_rebel_faction(state, p, existing_faction)) {
+		d.action = rebel_action::leave;
+		return;
+	}
+
+	auto prov = state.world.pop_get_province_from_pop_location(p);
+	/*
+	- A pop in a province sieged or controlled by rebels will join that faction, if the pop is compatible with the faction.
+	*/
+	auto occupying_faction = state.world.province_get_rebel_faction_from_province_rebel_control(prov);
+	if(occupying_faction && pop_is_compatible_with_rebel_faction(state, p, occupying_faction)) {
+		d.action = rebel_action::join_existing;
+		d.faction = occupying_faction;
+		return;
+	}
+
+	/*
+	- Otherwise take all the compatible and possible rebel types. Determine the spawn chance for each of them, by taking the *product* of the modifiers. The pop then joins the type with the greatest chance (that's right, it isn't really a *chance* at all). If that type has a defection type, it joins the faction with the national identity most compatible with it and that type (pan-nationalist go to the union tag, everyone else uses the logic I outline below)
+	*/
+	float greatest_chance = 0.0f;
+	bool pick_new = false;
+	for(auto rf : state.world.nation_get_rebellion_within(owner)) {
+		if(pop_is_compatible_with_rebel_faction(state, p, rf.get_rebels())) {
+			auto chance = rf.get_rebels().get_type().get_spawn_chance();
+			auto eval = trigger::evaluate_multiplicative_modifier(state, chance, trigger::to_generic(p), trigger::to_generic(owner), trigger::to_generic(rf.get_rebels().id));
+			if(eval > greatest_chance) {
+				d.faction = rf.get_rebels();
+				greatest_chance = eval;
+			}
+		}
+	}
+
+	dcon::national_identity_id ind_tag = [&]() {
+		for(auto core : state.world.province_get_core(prov)) {
+			if(core.get_identity().get_primary_culture() == state.world.pop_get_culture(p))
+				return core.get_identity().id;
+		}
+		return dcon::national_identity_id{};
+	}();
+
+	state.world.for_each_rebel_type([&](dcon::rebel_type_id rt) {
+		if(!pop_is_compatible_with_rebel_type(state, p, rt))
+			return;
+		if(!configure_faction_for_pop(state, scratch, rt, p, ind_tag))
 			return;
 
-		auto mil = state.world.pop_get_militancy(p);
-		auto existing_faction = state.world.pop_get_rebel_faction_from_pop_rebellion_membership(p);
+		auto chance = state.world.rebel_type_get_spawn_chance(rt);
+		auto eval = trigger::evaluate_multiplicative_modifier(state, chance, trigger::to_generic(p), trigger::to_generic(owner), trigger::to_generic(scratch));
+		if(eval > greatest_chance) {
+			pick_new = true;
+			greatest_chance = eval;
+			d.type = rt;
+			d.defection_target = state.world.rebel_faction_get_defection_target(scratch);
+			d.primary_culture = state.world.rebel_faction_get_primary_culture(scratch);
+			d.primary_culture_group = state.world.rebel_faction_get_primary_culture_group(scratch);
+			d.religion = state.world.rebel_faction_get_religion(scratch);
+		}
+	});
 
-		// -Pops with define : MIL_TO_JOIN_REBEL will join a rebel_faction
-		if(mil >= state.defines.mil_to_join_rebel) {
-			if(existing_faction && !pop_is_compatible_with_rebel_faction(state, p, existing_faction)) {
-				remove_pop_from_rebel_faction(state, p);
-			} else {
-				auto prov = state.world.pop_get_province_from_pop_location(p);
-				/*
-				- A pop in a province sieged or controlled by rebels will join that faction, if the pop is compatible with the faction.
-				*/
-
-				auto occupying_faction = state.world.province_get_rebel_faction_from_province_rebel_control(prov);
-				if(occupying_faction && pop_is_compatible_with_rebel_faction(state, p, occupying_faction)) {
-					add_pop_to_rebel_faction(state, p, occupying_faction);
-				} else {
-					/*
-					- Otherwise take all the compatible and possible rebel types. Determine the spawn chance for each of them, by taking the *product* of the modifiers. The pop then joins the type with the greatest chance (that's right, it isn't really a *chance* at all). If that type has a defection type, it joins the faction with the national identity most compatible with it and that type (pan-nationalist go to the union tag, everyone else uses the logic I outline below)
-					*/
-					float greatest_chance = 0.0f;
-					dcon::rebel_faction_id f;
-					for(auto rf : state.world.nation_get_rebellion_within(owner)) {
-						if(pop_is_compatible_with_rebel_faction(state, p, rf.get_rebels())) {
-							auto chance = rf.get_rebels().get_type().get_spawn_chance();
-							auto eval = trigger::evaluate_multiplicative_modifier(state, chance, trigger::to_generic(p), trigger::to_generic(owner), trigger::to_generic(rf.get_rebels().id));
-							if(eval > greatest_chance) {
-								f = rf.get_rebels();
-								greatest_chance = eval;
-							}
-						}
-					}
+	if(greatest_chance > 0)
+		d.action = pick_new ? rebel_action::join_new : rebel_action::join_existing;
+}
+}
 
-					dcon::rebel_faction_id temp = state.world.create_rebel_faction();
-					dcon::national_identity_id ind_tag = [&]() {
-						auto prov = state.world.pop_get_province_from_pop_location(p);
-						for(auto core : state.world.province_get_core(prov)) {
-							if(core.get_identity().get_primary_culture() == state.world.pop_get_culture(p))
-								return core.get_identity().id;
-						}
-						return dcon::national_identity_id{};
-					}();
-
-					dcon::rebel_type_id max_type;
-
-					state.world.for_each_rebel_type([&](dcon::rebel_type_id rt) {
-						if(pop_is_compatible_with_rebel_type(state, p, rt)) {
-							state.world.rebel_faction_set_type(temp, rt);
-							state.world.rebel_faction_set_defection_target(temp, dcon::national_identity_id{});
-							state.world.rebel_faction_set_primary_culture(temp, dcon::culture_id{});
-							state.world.rebel_faction_set_primary_culture_group(temp, dcon::culture_group_id{});
-							state.world.rebel_faction_set_religion(temp, dcon::religion_id{});
-
-							switch(culture::rebel_defection(state.world.rebel_type_get_defection(rt))) {
-								case culture::rebel_defection::culture:
-									state.world.rebel_faction_set_primary_culture(temp, state.world.pop_get_culture(p));
-									state.world.rebel_faction_set_defection_target(temp, ind_tag);
-									if(!ind_tag)
-										return; // skip -- no defection possible
-									if(state.world.pop_get_is_primary_or_accepted_culture(p))
-										return; // skip -- can't defect
-									break;
-								case culture::rebel_defection::culture_group:
-									state.world.rebel_faction_set_primary_culture_group(temp, state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p)));
-									state.world.rebel_faction_set_defection_target(temp, ind_tag);
-									if(!ind_tag)
-										return; // skip -- no defection possible
-									if(state.world.pop_get_is_primary_or_accepted_culture(p))
-										return; // skip -- can't defect
-									break;
-								case culture::rebel_defection::religion:
-									state.world.rebel_faction_set_religion(temp, state.world.pop_get_religion(p));
-									state.world.rebel_faction_set_defection_target(temp, ind_tag);
-									if(!ind_tag)
-										return; // skip -- no defection possible
-									if(state.world.pop_get_is_primary_or_accepted_culture(p))
-										return; // skip -- can't defect
-									break;
-								case culture::rebel_defection::pan_nationalist:
-								{
-									auto cg = state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p));
-									auto u = state.world.culture_group_get_identity_from_cultural_union_of(cg);
-									if(!u)
-										return; // skip -- no pan nationalist possible
-									state.world.rebel_faction_set_defection_target(temp, u);
-									break;
-								}
-								case culture::rebel_defection::any:
-									state.world.rebel_faction_set_defection_target(temp, ind_tag);
-									if(!ind_tag)
-										return; // skip -- no defection possible
-									if(state.world.pop_get_is_primary_or_accepted_culture(p))
-										return; // skip -- can't defect
-									break;
-								default:
-									break;
-							}
+void update_pop_rebel_membership(sys::state& state) {
+	/*
+	Decisions are made for every pop in parallel, one nation at a time per task, against the factions as they stand at the start
+	of the update. Each task evaluates the spawn chance of prospective factions on its own scratch faction rather than creating
+	and deleting a row per pop. The decisions are then committed serially in pop order; a pop that wants to start a faction
+	identical to one started earlier in the same pass joins that one instead, as it would have when each pop was handled in turn.
+	*/
+	static impl::pops_by_owner groups;
+	static std::vector<impl::rebel_decision> decisions;
+	static std::vector<dcon::rebel_faction_id> scratch;
 
-							switch(culture::rebel_independence(state.world.rebel_type_get_independence(rt))) {
-								case culture::rebel_independence::culture:
-									state.world.rebel_faction_set_primary_culture(temp, state.world.pop_get_culture(p));
-									state.world.rebel_faction_set_defection_target(temp, ind_tag);
-									if(!ind_tag)
-										return; // skip -- no defection possible
-									if(state.world.pop_get_is_primary_or_accepted_culture(p))
-										return; // skip -- can't defect
-									break;
-								case culture::rebel_independence::culture_group:
-									state.world.rebel_faction_set_primary_culture_group(temp, state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p)));
-									state.world.rebel_faction_set_defection_target(temp, ind_tag);
-									if(!ind_tag)
-										return; // skip -- no defection possible
-									if(state.world.pop_get_is_primary_or_accepted_culture(p))
-										return; // skip -- can't defect
-									break;
-								case culture::rebel_independence::religion:
-									state.world.rebel_faction_set_religion(temp, state.world.pop_get_religion(p));
-									state.world.rebel_faction_set_defection_target(temp, ind_tag);
-									if(!ind_tag)
-										return; // skip -- no defection possible
-									if(state.world.pop_get_is_primary_or_accepted_culture(p))
-										return; // skip -- can't defect
-									break;
-								case culture::rebel_independence::pan_nationalist:
-								{
-									auto cg = state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p));
-									auto u = state.world.culture_group_get_identity_from_cultural_union_of(cg);
-									if(!u)
-										return; // skip -- no pan nationalist possible
-									if(state.world.pop_get_is_primary_or_accepted_culture(p))
-										return; // skip -- can't defect
-									state.world.rebel_faction_set_defection_target(temp, u);
-									break;
-								}
-								case culture::rebel_independence::any:
-									state.world.rebel_faction_set_defection_target(temp, ind_tag);
-									if(!ind_tag)
-										return; // skip -- no defection possible
-									if(state.world.pop_get_is_primary_or_accepted_culture(p))
-										return; // skip -- can't defect
-									break;
-								case culture::rebel_independence::colonial:
-									state.world.rebel_faction_set_defection_target(temp, ind_tag);
-									if(!ind_tag)
-										return; // skip -- no defection possible
-									if(state.world.pop_get_is_primary_or_accepted_culture(p))
-										return; // skip -- can't defect
-									break;
-								default:
-									break;
-							}
+	groups.rebuild(state);
+	decisions.assign(state.world.pop_size(), impl::rebel_decision{});
 
-							auto chance = state.world.rebel_type_get_spawn_chance(rt);
-							auto eval = trigger::evaluate_multiplicative_modifier(state, chance, trigger::to_generic(p), trigger::to_generic(owner), trigger::to_generic(temp));
-							if(eval > greatest_chance) {
-								f = temp;
-								max_type = rt;
-								greatest_chance = eval;
-							}
-						}
-					});
-
-
-
-					if(f != temp) {
-						state.world.delete_rebel_faction(temp);
-					} else {
-						auto rt = max_type;
-						state.world.rebel_faction_set_type(temp, rt);
-						state.world.rebel_faction_set_defection_target(temp, dcon::national_identity_id{});
-						state.world.rebel_faction_set_primary_culture(temp, dcon::culture_id{});
-						state.world.rebel_faction_set_primary_culture_group(temp, dcon::culture_group_id{});
-						state.world.rebel_faction_set_religion(temp, dcon::religion_id{});
-
-						switch(culture::rebel_defection(state.world.rebel_type_get_defection(rt))) {
-							case culture::rebel_defection::culture:
-								state.world.rebel_faction_set_primary_culture(temp, state.world.pop_get_culture(p));
-								state.world.rebel_faction_set_defection_target(temp, ind_tag);
-								break;
-							case culture::rebel_defection::culture_group:
-								state.world.rebel_faction_set_primary_culture_group(temp, state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p)));
-								state.world.rebel_faction_set_defection_target(temp, ind_tag);
-								break;
-							case culture::rebel_defection::religion:
-								state.world.rebel_faction_set_religion(temp, state.world.pop_get_religion(p));
-								state.world.rebel_faction_set_defection_target(temp, ind_tag);
-								break;
-							case culture::rebel_defection::pan_nationalist:
-							{
-								auto cg = state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p));
-								auto u = state.world.culture_group_get_identity_from_cultural_union_of(cg);
-								state.world.rebel_faction_set_defection_target(temp, u);
-								break;
-							}
-							case culture::rebel_defection::any:
-								state.world.rebel_faction_set_defection_target(temp, ind_tag);
-								break;
-							default:
-								break;
-						}
+	auto const nation_count = state.world.nation_size();
+	scratch.assign(nation_count, dcon::rebel_faction_id{});
+	for(uint32_t i = 0; i < nation_count; ++i) {
+		if(groups.offsets[i] != groups.offsets[i + 1])
+			scratch[i] = state.world.create_rebel_faction();
+	}
 
-						switch(culture::rebel_independence(state.world.rebel_type_get_independence(rt))) {
-							case culture::rebel_independence::culture:
-								state.world.rebel_faction_set_primary_culture(temp, state.world.pop_get_culture(p));
-								state.world.rebel_faction_set_defection_target(temp, ind_tag);
-								break;
-							case culture::rebel_independence::culture_group:
-								state.world.rebel_faction_set_primary_culture_group(temp, state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p)));
-								state.world.rebel_faction_set_defection_target(temp, ind_tag);
-								break;
-							case culture::rebel_independence::religion:
-								state.world.rebel_faction_set_religion(temp, state.world.pop_get_religion(p));
-								state.world.rebel_faction_set_defection_target(temp, ind_tag);
-								break;
-							case culture::rebel_independence::pan_nationalist:
-							{
-								auto cg = state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p));
-								auto u = state.world.culture_group_get_identity_from_cultural_union_of(cg);
-								state.world.rebel_faction_set_defection_target(temp, u);
-								break;
-							}
-							case culture::rebel_independence::any:
-								state.world.rebel_faction_set_defection_target(temp, ind_tag);
-								break;
-							case culture::rebel_independence::colonial:
-								state.world.rebel_faction_set_defection_target(temp, ind_tag);
-								break;
-							default:
-								break;
-						}
+	concurrency::parallel_for(uint32_t(0), nation_count, [&](uint32_t i) {
+		if(!scratch[i])
+			return;
+		dcon::nation_id owner{ dcon::nation_id::value_base_t(i) };
+		for(uint32_t j = groups.offsets[i]; j < groups.offsets[i + 1]; ++j) {
+			auto p = groups.pops[j];
+			impl::classify_pop_for_rebels(state, p, owner, scratch[i], decisions[p.index()]);
+		}
+	});
 
-						state.world.try_create_rebellion_within(temp, owner);
-					}
+	// scratch factions were created last, so deleting them from the back leaves every other faction where it was
+	for(auto i = nation_count; i-- > 0; ) {
+		if(scratch[i])
+			state.world.delete_rebel_faction(scratch[i]);
+	}
 
-					if(greatest_chance > 0) {
-						add_pop_to_rebel_faction(state, p, f);
+	auto const first_new_faction = state.world.rebel_faction_size();
+	for(uint32_t i = 0; i < uint32_t(decisions.size()); ++i) {
+		auto const& d = decisions[i];
+		dcon::pop_id p{ dcon::pop_id::value_base_t(i) };
+
+		switch(d.action) {
+			case impl::rebel_action::none:
+				break;
+			case impl::rebel_action::leave:
+				remove_pop_from_rebel_faction(state, p);
+				break;
+			case impl::rebel_action::join_existing:
+				add_pop_to_rebel_faction(state, p, d.faction);
+				break;
+			case impl::rebel_action::join_new:
+			{
+				auto owner = groups.owners[i];
+				dcon::rebel_faction_id f;
+				for(auto rf : state.world.nation_get_rebellion_within(owner)) {
+					auto r = rf.get_rebels();
+					if(r.id.index() >= int32_t(first_new_faction) && r.get_type() == d.type && r.get_defection_target() == d.defection_target
+						&& r.get_primary_culture() == d.primary_culture && r.get_primary_culture_group() == d.primary_culture_group
+						&& r.get_religion() == d.religion) {
+						f = r;
+						break;
 					}
 				}
-			}
-		} else { // less than: MIL_TO_JOIN_REBEL will join a rebel_faction -- leave faction
-			if(existing_faction) {
-				remove_pop_from_rebel_faction(state, p);
+				if(!f) {
+					f = state.world.create_rebel_faction();
+					state.world.rebel_faction_set_type(f, d.type);
+					state.world.rebel_faction_set_defection_target(f, d.defection_target);
+					state.world.rebel_faction_set_primary_culture(f, d.primary_culture);
+					state.world.rebel_faction_set_primary_culture_group(f, d.primary_culture_group);
+					state.world.rebel_faction_set_religion(f, d.religion);
+					state.world.try_create_rebellion_within(f, owner);
+				}
+				add_pop_to_rebel_faction(state, p, f);
+				break;
 			}
 		}
-	});
+	}
 }
 
 void delete_faction(sys::state& state, dcon::rebel_faction_id reb) {
@@ -5,6 +5,8 @@ namespace rebel {
 
 dcon::movement_id get_movement_by_position(sys::state& state, dcon::nation_id n, dcon::issue_option_id o);
 dcon::movement_id get_movement_by_independence(sys::state& state, dcon::nation_id n, dcon::national_identity_id i);
+// caches, for each state instance, the independence movement within its owner for its flashpoint tag (if any)
+void update_flashpoint_movements(sys::state& state);
 
 void update_movement_values(sys::state& state); // simply updates cached values
 void turn_movement_into_rebels(sys::state& state, dcon::movement_id m);
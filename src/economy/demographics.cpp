@@ -656,11 +656,83 @@ void execute_staggered_blocks(uint32_t offset, uint32_t divisions, uint32_t max,
 	}
 }
 
+pop_update_scheduler::pop_update_scheduler() {
+	static_assert(uint32_t(pop_update::count) <= 256, "phases are stored as uint8_t");
+	periods.fill(0);
+	costs.fill(0.0f);
+	// the phases that the updates have always used; update/apply pairs of a buffer share a phase
+	for(uint32_t i = 0; i < uint32_t(pop_update::count); ++i)
+		phases[i] = uint8_t(i);
+	phases[uint32_t(pop_update::type_changes)] = 6;
+	phases[uint32_t(pop_update::assimilation)] = 7;
+	phases[uint32_t(pop_update::internal_migration)] = 8;
+	phases[uint32_t(pop_update::colonial_migration)] = 9;
+	phases[uint32_t(pop_update::immigration)] = 10;
+}
+
+void pop_update_scheduler::configure(parsing::defines const& d) {
+	auto set = [&](pop_update u, float days) {
+		set_period(u, uint32_t(std::clamp(days + 0.5f, 0.0f, 255.0f)));
+	};
+	set(pop_update::ideologies, d.pop_update_period_ideologies);
+	set(pop_update::issues, d.pop_update_period_issues);
+	set(pop_update::militancy, d.pop_update_period_militancy);
+	set(pop_update::consciousness, d.pop_update_period_consciousness);
+	set(pop_update::literacy, d.pop_update_period_literacy);
+	set(pop_update::growth, d.pop_update_period_growth);
+	set(pop_update::type_changes, d.pop_update_period_type_changes);
+	set(pop_update::assimilation, d.pop_update_period_assimilation);
+	set(pop_update::internal_migration, d.pop_update_period_internal_migration);
+	set(pop_update::colonial_migration, d.pop_update_period_colonial_migration);
+	set(pop_update::immigration, d.pop_update_period_immigration);
+}
+
+uint32_t pop_update_scheduler::divisions(pop_update u, uint32_t days_in_month) const {
+	auto p = periods[uint32_t(u)];
+	return p != 0 ? uint32_t(p) : days_in_month;
+}
+
+uint32_t pop_update_scheduler::offset(pop_update u, sys::date today, uint32_t day_of_month, uint32_t days_in_month) const {
+	auto p = periods[uint32_t(u)];
+	if(p == 0)
+		return (day_of_month + phases[uint32_t(u)]) % days_in_month;
+	else
+		return (uint32_t(today.value) + phases[uint32_t(u)]) % uint32_t(p);
+}
+
+void pop_update_scheduler::record(pop_update u, float milliseconds) {
+	auto& c = costs[uint32_t(u)];
+	c = (c == 0.0f) ? milliseconds : c * 0.9f + milliseconds * 0.1f;
+}
+
+void pop_update_scheduler::order_by_cost(pop_update* first, pop_update* last) const {
+	std::stable_sort(first, last, [&](pop_update a, pop_update b) {
+		return costs[uint32_t(a)] > costs[uint32_t(b)];
+	});
+}
+
+uint32_t staggered_blocks_per_task(uint32_t block_count) {
+	// a handful of tasks per worker is enough to balance the load; fewer, larger tasks keep each one streaming through memory
+	static uint32_t const target_tasks = std::max(1u, std::thread::hardware_concurrency()) * 4;
+	return std::max(1u, block_count / target_tasks);
+}
+
 template<typename F>
 void pexecute_staggered_blocks(uint32_t offset, uint32_t divisions, uint32_t max, F&& functor) {
-	concurrency::parallel_for(16 * offset, max, 16 * divisions, [&](uint32_t index) {
-		for(uint32_t i = 0; i < executions_per_block; ++i) {
-			functor(ve::contiguous_tags<dcon::pop_id>(index + i * ve::vector_size));
+	auto const first = packed_attraction_buffer::pop_block_size * offset;
+	auto const stride = packed_attraction_buffer::pop_block_size * divisions;
+	if(first >= max)
+		return;
+	auto const block_count = (max - first + stride - 1) / stride;
+	auto const per_task = staggered_blocks_per_task(block_count);
+
+	concurrency::parallel_for(uint32_t(0), (block_count + per_task - 1) / per_task, [&](uint32_t t) {
+		auto const end = std::min(block_count, (t + 1) * per_task);
+		for(uint32_t b = t * per_task; b < end; ++b) {
+			auto const index = first + b * stride;
+			for(uint32_t i = 0; i < executions_per_block; ++i) {
+				functor(ve::contiguous_tags<dcon::pop_id>(index + i * ve::vector_size));
+			}
 		}
 	});
 }
@@ -818,6 +890,62 @@ float get_estimated_con_change(sys::state& state, dcon::nation_id n) {
 
 inline constexpr float ideology_change_rate = 0.10f;
 
+namespace impl {
+template<typename T>
+auto ideology_attraction(sys::state& state, dcon::ideology_id i, T ids) {
+	auto owner = nations::owner_of_pop(state, ids);
+	bool const civilized_only = state.world.ideology_get_is_civilized_only(i);
+
+	return ve::apply([&](dcon::pop_id pid, dcon::pop_type_id ptid, dcon::nation_id o) {
+		if(civilized_only && !state.world.nation_get_is_civilized(o))
+			return 0.0f;
+		auto ptrigger = state.world.pop_type_get_ideology(ptid, i);
+		return trigger::evaluate_multiplicative_modifier(state, ptrigger, trigger::to_generic(pid), trigger::to_generic(o), 0);
+	}, ids, state.world.pop_get_poptype(ids), owner);
+}
+
+template<typename T, typename V>
+void blend_ideology(sys::state& state, dcon::pop_demographics_key i_key, T ids, V attraction, V ttotal) {
+	auto avalue = attraction / ttotal;
+	auto current = state.world.pop_get_demographics(ids, i_key);
+
+	state.world.pop_set_demographics(ids, i_key,
+		ve::select(ttotal > 0.0f, ideology_change_rate * avalue + (1.0f - ideology_change_rate) * current, current));
+}
+
+template<typename F>
+void execute_staggered_pop_blocks(uint32_t offset, uint32_t divisions, uint32_t max, F&& functor) {
+	for(auto block_index = packed_attraction_buffer::pop_block_size * offset; block_index < max; block_index += packed_attraction_buffer::pop_block_size * divisions) {
+		functor(block_index);
+	}
+}
+
+template<typename F>
+void pexecute_staggered_pop_blocks(uint32_t offset, uint32_t divisions, uint32_t max, F&& functor) {
+	auto const first = packed_attraction_buffer::pop_block_size * offset;
+	auto const stride = packed_attraction_buffer::pop_block_size * divisions;
+	if(first >= max)
+		return;
+	auto const block_count = (max - first + stride - 1) / stride;
+	auto const per_task = staggered_blocks_per_task(block_count);
+
+	concurrency::parallel_for(uint32_t(0), (block_count + per_task - 1) / per_task, [&](uint32_t t) {
+		auto const end = std::min(block_count, (t + 1) * per_task);
+		for(uint32_t b = t * per_task; b < end; ++b) {
+			functor(first + b * stride);
+		}
+	});
+}
+
+// reads the lanes of a packed row that line up with ids
+template<typename T>
+auto load_packed(float const* row, uint32_t first_pop, T ids) {
+	return ve::apply([&](dcon::pop_id p) {
+		return row[p.index() - first_pop];
+	}, ids);
+}
+}
+
 void update_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, ideology_buffer& ibuf) {
 	/*
 	For ideologies after their enable date (actual discovery / activation is irrelevant), and not restricted to civs only for pops in an unciv, the attraction modifier is computed *multiplicatively*. Then, these values are collectively normalized.
@@ -835,36 +963,38 @@ void update_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, i
 	// update
 	state.world.for_each_ideology([&](dcon::ideology_id i) {
 		if(state.world.ideology_get_enabled(i)) {
-			auto const i_key = pop_demographics::to_key(state, i);
-			if(state.world.ideology_get_is_civilized_only(i)) {
-				pexecute_staggered_blocks(offset, divisions, new_pop_count, [&](auto ids) {
-					auto owner = nations::owner_of_pop(state, ids);
-
-					auto amount = ve::apply([&](dcon::pop_id pid, dcon::pop_type_id ptid, dcon::nation_id o) {
-						if(state.world.nation_get_is_civilized(o)) {
-							auto ptrigger = state.world.pop_type_get_ideology(ptid, i);
-							return trigger::evaluate_multiplicative_modifier(state, ptrigger, trigger::to_generic(pid), trigger::to_generic(o), 0);
-						} else
-							return 0.0f;
-					}, ids, state.world.pop_get_poptype(ids), owner);
+			pexecute_staggered_blocks(offset, divisions, new_pop_count, [&](auto ids) {
+				auto amount = impl::ideology_attraction(state, i, ids);
+				ibuf.temp_buffers[i].set(ids, amount);
+				ibuf.totals.set(ids, ibuf.totals.get(ids) + amount);
+			});
+		}
+	});
+}
 
-					ibuf.temp_buffers[i].set(ids, amount);
-					ibuf.totals.set(ids, ibuf.totals.get(ids) + amount);
-				});
-			} else {
-				pexecute_staggered_blocks(offset, divisions, new_pop_count, [&](auto ids) {
-					auto owner = nations::owner_of_pop(state, ids);
+void update_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, packed_attraction_buffer& ibuf) {
+	auto new_pop_count = state.world.pop_size();
+	ibuf.update(state.world.ideology_size(), new_pop_count);
 
-					auto amount = ve::apply([&](dcon::pop_id pid, dcon::pop_type_id ptid, dcon::nation_id o) {
-						auto ptrigger = state.world.pop_type_get_ideology(ptid, i);
-						return trigger::evaluate_multiplicative_modifier(state, ptrigger, trigger::to_generic(pid), trigger::to_generic(o), 0);
-					}, ids, state.world.pop_get_poptype(ids), owner);
+	// each task fills in every ideology for one block of pops, so the block stays in cache while it is worked on
+	impl::pexecute_staggered_pop_blocks(offset, divisions, new_pop_count, [&](uint32_t first_pop) {
+		float* totals = ibuf.totals(first_pop);
+		std::fill_n(totals, packed_attraction_buffer::pop_block_size, 0.0f);
 
-					ibuf.temp_buffers[i].set(ids, amount);
-					ibuf.totals.set(ids, ibuf.totals.get(ids) + amount);
-				});
+		state.world.for_each_ideology([&](dcon::ideology_id i) {
+			if(!state.world.ideology_get_enabled(i))
+				return;
+			float* values = ibuf.row(first_pop, uint32_t(i.index()));
+			for(uint32_t j = 0; j < executions_per_block; ++j) {
+				ve::contiguous_tags<dcon::pop_id> ids(first_pop + j * ve::vector_size);
+				auto amount = impl::ideology_attraction(state, i, ids);
+				ve::apply([&](dcon::pop_id p, float v) {
+					values[p.index() - first_pop] = v;
+				}, ids, amount);
 			}
-		}
+			for(uint32_t j = 0; j < packed_attraction_buffer::pop_block_size; ++j)
+				totals[j] += values[j];
+		});
 	});
 }
 
@@ -882,19 +1012,93 @@ void apply_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, id
 			auto const i_key = pop_demographics::to_key(state, i);
 
 			execute_staggered_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](auto ids) {
-				auto ttotal = pbuf.totals.get(ids);
-				auto avalue = pbuf.temp_buffers[i].get(ids) / ttotal;
-				auto current = state.world.pop_get_demographics(ids, i_key);
-
-				state.world.pop_set_demographics(ids, i_key,
-					ve::select(ttotal > 0.0f, ideology_change_rate * avalue + (1.0f - ideology_change_rate) * current, current));
+				impl::blend_ideology(state, i_key, ids, pbuf.temp_buffers[i].get(ids), pbuf.totals.get(ids));
 			});
 		}
 	});
 }
 
+void apply_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, packed_attraction_buffer& pbuf) {
+	impl::execute_staggered_pop_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](uint32_t first_pop) {
+		float const* totals = pbuf.totals(first_pop);
+		state.world.for_each_ideology([&](dcon::ideology_id i) {
+			if(!state.world.ideology_get_enabled(i))
+				return;
+			auto const i_key = pop_demographics::to_key(state, i);
+			float const* values = pbuf.row(first_pop, uint32_t(i.index()));
+			for(uint32_t j = 0; j < executions_per_block; ++j) {
+				ve::contiguous_tags<dcon::pop_id> ids(first_pop + j * ve::vector_size);
+				impl::blend_ideology(state, i_key, ids, impl::load_packed(values, first_pop, ids), impl::load_packed(totals, first_pop, ids));
+			}
+		});
+	});
+}
+
 inline constexpr float issues_change_rate = 0.10f;
 
+namespace impl {
+// the per-option values that do not depend on the pop
+struct issue_attraction_info {
+	dcon::issue_option_id option;
+	dcon::issue_id parent_issue;
+	dcon::trigger_key allow;
+	bool is_party_issue = false;
+	bool has_modifier = false;
+	bool next_step_only = false;
+	dcon::national_modifier_value modifier_key;
+};
+
+issue_attraction_info make_issue_attraction_info(sys::state& state, dcon::issue_option_id iid) {
+	auto opt = fatten(state.world, iid);
+	issue_attraction_info r;
+	r.option = iid;
+	r.allow = opt.get_allow();
+	r.parent_issue = opt.get_parent_issue();
+	r.is_party_issue = state.world.issue_get_issue_type(r.parent_issue) == uint8_t(culture::issue_type::party);
+	auto is_social_issue = state.world.issue_get_issue_type(r.parent_issue) == uint8_t(culture::issue_type::social);
+	auto is_political_issue = state.world.issue_get_issue_type(r.parent_issue) == uint8_t(culture::issue_type::political);
+	r.has_modifier = is_social_issue || is_political_issue;
+	r.next_step_only = state.world.issue_get_is_next_step_only(r.parent_issue);
+	r.modifier_key = is_social_issue ? sys::national_mod_offsets::social_reform_desire : sys::national_mod_offsets::political_reform_desire;
+	return r;
+}
+
+template<typename T>
+auto issue_attraction(sys::state& state, issue_attraction_info const& info, T ids) {
+	auto iid = info.option;
+	auto owner = nations::owner_of_pop(state, ids);
+	auto current_issue_setting = state.world.nation_get_issues(owner, info.parent_issue);
+	auto allowed_by_owner = (state.world.nation_get_is_civilized(owner) || ve::mask_vector(info.is_party_issue))
+		&& (info.allow ? trigger::evaluate(state, info.allow, trigger::to_generic(owner), trigger::to_generic(owner), 0) : ve::mask_vector(true))
+		&& (current_issue_setting != iid || ve::mask_vector(info.is_party_issue))
+		&& (ve::mask_vector(!info.next_step_only)
+			|| (ve::tagged_vector<int32_t>(current_issue_setting) == iid.index() - 1)
+			|| (ve::tagged_vector<int32_t>(current_issue_setting) == iid.index() + 1)
+			);
+	auto owner_modifier = info.has_modifier ? (state.world.nation_get_modifier_values(owner, info.modifier_key) + 1.0f) : ve::fp_vector(1.0f);
+
+	return owner_modifier * ve::select(allowed_by_owner,
+		ve::apply([&](dcon::pop_id pid, dcon::pop_type_id ptid, dcon::nation_id o) {
+			if(auto mtrigger = state.world.pop_type_get_issues(ptid, iid); mtrigger) {
+				return trigger::evaluate_multiplicative_modifier(state, mtrigger, trigger::to_generic(pid), trigger::to_generic(o), 0);
+			} else {
+				return 0.0f;
+			}
+		}, ids, state.world.pop_get_poptype(ids), owner), 0.0f);
+}
+
+template<typename T, typename V>
+void blend_issue(sys::state& state, dcon::pop_demographics_key i_key, T ids, V attraction, V ttotal) {
+	auto avalue = attraction / ttotal;
+	auto current = state.world.pop_get_demographics(ids, i_key);
+	auto owner = nations::owner_of_pop(state, ids);
+	auto owner_rate_modifier = (state.world.nation_get_modifier_values(owner, sys::national_mod_offsets::issue_change_speed) + 1.0f);
+
+	state.world.pop_set_demographics(ids, i_key,
+			ve::select(ttotal > 0.0f, issues_change_rate * owner_rate_modifier * avalue + (1.0f - issues_change_rate * owner_rate_modifier) * current, current));
+}
+}
+
 void update_issues(sys::state& state, uint32_t offset, uint32_t divisions, issues_buffer& ibuf) {
 	/*
 	As with ideologies, the attraction modifier for each issue is computed *multiplicatively* and then are collectively normalized. Then we zero the attraction for any issue that is not currently possible (i.e. its trigger condition is not met or it is not the next/previous step for a next-step type issue, and for uncivs only the party issues are valid here)
@@ -910,43 +1114,44 @@ void update_issues(sys::state& state, uint32_t offset, uint32_t divisions, issue
 
 	// update
 	state.world.for_each_issue_option([&](dcon::issue_option_id iid) {
-		auto opt = fatten(state.world, iid);
-		auto allow = opt.get_allow();
-		auto parent_issue = opt.get_parent_issue();
-		auto const i_key = pop_demographics::to_key(state, iid);
-		auto is_party_issue = state.world.issue_get_issue_type(parent_issue) == uint8_t(culture::issue_type::party);
-		auto is_social_issue = state.world.issue_get_issue_type(parent_issue) == uint8_t(culture::issue_type::social);
-		auto is_political_issue = state.world.issue_get_issue_type(parent_issue) == uint8_t(culture::issue_type::political);
-		auto has_modifier = is_social_issue || is_political_issue;
-		auto modifier_key = is_social_issue ? sys::national_mod_offsets::social_reform_desire : sys::national_mod_offsets::political_reform_desire;
+		auto const info = impl::make_issue_attraction_info(state, iid);
 
 		pexecute_staggered_blocks(offset, divisions, new_pop_count, [&](auto ids) {
-			auto owner = nations::owner_of_pop(state, ids);
-			auto current_issue_setting = state.world.nation_get_issues(owner, parent_issue);
-			auto allowed_by_owner = (state.world.nation_get_is_civilized(owner) || ve::mask_vector(is_party_issue))
-				&& (allow ? trigger::evaluate(state, allow, trigger::to_generic(owner), trigger::to_generic(owner), 0) : ve::mask_vector(true))
-				&& (current_issue_setting != iid || ve::mask_vector(is_party_issue))
-				&& (ve::mask_vector(!state.world.issue_get_is_next_step_only(parent_issue))
-					|| (ve::tagged_vector<int32_t>(current_issue_setting) == iid.index() - 1)
-					|| (ve::tagged_vector<int32_t>(current_issue_setting) == iid.index() + 1)
-					);
-			auto owner_modifier = has_modifier ? (state.world.nation_get_modifier_values(owner, modifier_key) + 1.0f) : ve::fp_vector(1.0f);
-
-			auto amount = owner_modifier * ve::select(allowed_by_owner,
-				ve::apply([&](dcon::pop_id pid, dcon::pop_type_id ptid, dcon::nation_id o) {
-					if(auto mtrigger = state.world.pop_type_get_issues(ptid, iid); mtrigger) {
-						return trigger::evaluate_multiplicative_modifier(state, mtrigger, trigger::to_generic(pid), trigger::to_generic(o), 0);
-					} else {
-						return 0.0f;
-					}
-				}, ids, state.world.pop_get_poptype(ids), owner), 0.0f);
-
+			auto amount = impl::issue_attraction(state, info, ids);
 			ibuf.temp_buffers[iid].set(ids, amount);
 			ibuf.totals.set(ids, ibuf.totals.get(ids) + amount);
 		});
 	});
 }
 
+void update_issues(sys::state& state, uint32_t offset, uint32_t divisions, packed_attraction_buffer& ibuf) {
+	auto new_pop_count = state.world.pop_size();
+	ibuf.update(state.world.issue_option_size(), new_pop_count);
+
+	std::vector<impl::issue_attraction_info> infos;
+	state.world.for_each_issue_option([&](dcon::issue_option_id iid) {
+		infos.push_back(impl::make_issue_attraction_info(state, iid));
+	});
+
+	impl::pexecute_staggered_pop_blocks(offset, divisions, new_pop_count, [&](uint32_t first_pop) {
+		float* totals = ibuf.totals(first_pop);
+		std::fill_n(totals, packed_attraction_buffer::pop_block_size, 0.0f);
+
+		for(auto& info : infos) {
+			float* values = ibuf.row(first_pop, uint32_t(info.option.index()));
+			for(uint32_t j = 0; j < executions_per_block; ++j) {
+				ve::contiguous_tags<dcon::pop_id> ids(first_pop + j * ve::vector_size);
+				auto amount = impl::issue_attraction(state, info, ids);
+				ve::apply([&](dcon::pop_id p, float v) {
+					values[p.index() - first_pop] = v;
+				}, ids, amount);
+			}
+			for(uint32_t j = 0; j < packed_attraction_buffer::pop_block_size; ++j)
+				totals[j] += values[j];
+		}
+	});
+}
+
 void apply_issues(sys::state& state, uint32_t offset, uint32_t divisions, issues_buffer& pbuf) {
 	/*
 	Then, like with ideologies, we check how much the normalized attraction is above and below the current support, with a couple of differences. First, for political or social issues, we multiply the magnitude of the adjustment by (national-political-reform-desire-modifier + 1) or (national-social-reform-desire-modifier + 1) as appropriate. Secondly, the base magnitude of the change is either (national-issue-change-speed-modifier + 1.0) x 0.25 or (national-issue-change-speed-modifier + 1.0) x 0.05 (instead of a fixed 0.05 or 0.25). Finally, there is an additional "bin" at 5x more or less where the adjustment is a flat 1.0.
@@ -956,14 +1161,21 @@ void apply_issues(sys::state& state, uint32_t offset, uint32_t divisions, issues
 		auto const i_key = pop_demographics::to_key(state, i);
 
 		execute_staggered_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](auto ids) {
-			auto ttotal = pbuf.totals.get(ids);
-			auto avalue = pbuf.temp_buffers[i].get(ids) / ttotal;
-			auto current = state.world.pop_get_demographics(ids, i_key);
-			auto owner = nations::owner_of_pop(state, ids);
-			auto owner_rate_modifier = (state.world.nation_get_modifier_values(owner, sys::national_mod_offsets::issue_change_speed) + 1.0f);
-
-			state.world.pop_set_demographics(ids, i_key,
-					ve::select(ttotal > 0.0f, issues_change_rate * owner_rate_modifier * avalue + (1.0f - issues_change_rate * owner_rate_modifier) * current, current));
+			impl::blend_issue(state, i_key, ids, pbuf.temp_buffers[i].get(ids), pbuf.totals.get(ids));
+		});
+	});
+}
+
+void apply_issues(sys::state& state, uint32_t offset, uint32_t divisions, packed_attraction_buffer& pbuf) {
+	impl::execute_staggered_pop_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](uint32_t first_pop) {
+		float const* totals = pbuf.totals(first_pop);
+		state.world.for_each_issue_option([&](dcon::issue_option_id i) {
+			auto const i_key = pop_demographics::to_key(state, i);
+			float const* values = pbuf.row(first_pop, uint32_t(i.index()));
+			for(uint32_t j = 0; j < executions_per_block; ++j) {
+				ve::contiguous_tags<dcon::pop_id> ids(first_pop + j * ve::vector_size);
+				impl::blend_issue(state, i_key, ids, impl::load_packed(values, first_pop, ids), impl::load_packed(totals, first_pop, ids));
+			}
 		});
 	});
 }
@@ -1292,6 +1504,52 @@ dcon::province_id get_colonial_province_target_in_nation(sys::state& state, dcon
 	return dcon::province_id{};
 }
 
+struct immigration_candidates {
+	dcon::nation_id top_nations[3] = { dcon::nation_id {}, dcon::nation_id{}, dcon::nation_id{} };
+	float top_weights[3] = { 0.0f, 0.0f, 0.0f };
+
+	void add(dcon::nation_id inner, float weight) {
+		if(weight > top_weights[2]) {
+			top_weights[2] = weight;
+			top_nations[2] = inner;
+			if(top_weights[2] > top_weights[1]) {
+				std::swap(top_weights[1], top_weights[2]);
+				std::swap(top_nations[1], top_nations[2]);
+			}
+			if(top_weights[1] > top_weights[0]) {
+				std::swap(top_weights[1], top_weights[0]);
+				std::swap(top_nations[1], top_nations[0]);
+			}
+		}
+	}
+	dcon::nation_id pick(sys::state& state, dcon::pop_id p) const {
+		float total_weight = top_weights[0] + top_weights[1] + top_weights[2];
+		if(total_weight <= 0.0f)
+			return dcon::nation_id{};
+
+		auto rvalue = float(rng::get_random(state, (uint32_t(p.index()) << 2) | uint32_t(3)) & 0xFFFF) / float(0xFFFF + 1);
+		for(uint32_t i = 0; i < 3; ++i) {
+			rvalue -= top_weights[i] / total_weight;
+			if(rvalue < 0.0f) {
+				return top_nations[i];
+			}
+		}
+		return dcon::nation_id{};
+	}
+};
+
+bool is_valid_immigration_target(sys::state& state, dcon::nation_id n, dcon::nation_id inner, dcon::modifier_id home_continent) {
+	if(state.world.nation_get_owned_province_count(inner) == 0)
+		return false; // ignore dead nations
+	if(state.world.nation_get_is_civilized(inner) == false)
+		return false; // ignore unciv nations
+	if(state.world.province_get_continent(state.world.nation_get_capital(inner)) == home_continent
+		&& !state.world.get_nation_adjacency_by_nation_adjacency_pair(n, inner)) {
+		return false; // ignore same continent, non-adjacent nations
+	}
+	return true;
+}
+
 dcon::nation_id get_immigration_target(sys::state& state, dcon::nation_id n, dcon::pop_id p) {
 	/*
 	Country targets for external migration: must be a country with its capital on a different continent from the source country *or* an adjacent country (same continent, but non adjacent, countries are not targets). Each country target is then weighted: First, the product of the country migration target modifiers (including the base value) is computed, and any results less than 0.01 are increased to that value. That value is then multiplied by (1.0 + the nations immigrant attractiveness modifier). Assuming that there are valid targets for immigration, the nations with the top three values are selected as the possible targets. The pop (or, rather, the part of the pop that is migrating) then goes to one of those three targets, selected at random according to their relative attractiveness weight. The final provincial destination for the pop is then selected as if doing normal internal migration.
@@ -1301,51 +1559,293 @@ dcon::nation_id get_immigration_target(sys::state& state, dcon::nation_id n, dco
 	if(!modifier)
 		return dcon::nation_id{};
 
-	dcon::nation_id top_nations[3] = { dcon::nation_id {}, dcon::nation_id{}, dcon::nation_id{} };
-	float top_weights[3] = { 0.0f, 0.0f, 0.0f };
-
+	immigration_candidates candidates;
 	auto home_continent = state.world.province_get_continent(state.world.pop_get_province_from_pop_location(p));
 
 	state.world.for_each_nation([&](dcon::nation_id inner) {
-		if(state.world.nation_get_owned_province_count(inner) == 0)
-			return; // ignore dead nations
-		if(state.world.nation_get_is_civilized(inner) == false)
-			return; // ignore unciv nations
-		if(state.world.province_get_continent(state.world.nation_get_capital(inner)) == home_continent
-			&& !state.world.get_nation_adjacency_by_nation_adjacency_pair(n, inner)) {
-			return; // ignore same continent, non-adjacent nations
-		}
+		if(!is_valid_immigration_target(state, n, inner, home_continent))
+			return;
 
 		auto weight = trigger::evaluate_multiplicative_modifier(state, modifier, trigger::to_generic(inner), trigger::to_generic(p), 0)
 			* (state.world.nation_get_modifier_values(inner, sys::national_mod_offsets::global_immigrant_attract) + 1.0f);
 
-		if(weight > top_weights[2]) {
-			top_weights[2] = weight;
-			top_nations[2] = inner;
-			if(top_weights[2] > top_weights[1]) {
-				std::swap(top_weights[1], top_weights[2]);
-				std::swap(top_nations[1], top_nations[2]);
+		candidates.add(inner, weight);
+	});
+
+	return candidates.pick(state, p);
+}
+
+void resolve_immigration_targets(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf) {
+	/*
+	The weight of a target nation only depends on the pop through the country_migration_target modifier, so unless that modifier reads the this slot, the top three targets are the same for all pops with the same source nation, pop type and home continent. Those are computed once for today, with the modifier evaluated once per pop type over all nations, and each pop then just makes its random pick among them (as in get_immigration_target).
+	*/
+	struct pending_pop {
+		dcon::pop_id p;
+		uint32_t group = 0;
+	};
+	struct immigration_group {
+		dcon::nation_id source;
+		dcon::pop_type_id type;
+		dcon::modifier_id home_continent;
+		immigration_candidates candidates;
+	};
+	std::vector<pending_pop> batched;
+	std::vector<dcon::pop_id> individual;
+	std::vector<immigration_group> groups;
+	ankerl::unordered_dense::map<uint64_t, uint32_t> group_indices;
+	std::vector<dcon::pop_type_id> needed_types;
+
+	execute_staggered_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](auto ids) {
+		ve::apply([&](dcon::pop_id p) {
+			if(pbuf.amounts.get(p) <= 0.0f)
+				return;
+			pbuf.target_nations.set(p, dcon::nation_id{});
+
+			auto pt = state.world.pop_get_poptype(p);
+			auto modifier = state.world.pop_type_get_country_migration_target(pt);
+			if(!modifier)
+				return;
+			if(state.value_modifiers[modifier].uses_this_slot) {
+				individual.push_back(p);
+				return;
 			}
-			if(top_weights[1] > top_weights[0]) {
-				std::swap(top_weights[1], top_weights[0]);
-				std::swap(top_nations[1], top_nations[0]);
+
+			auto location = state.world.pop_get_province_from_pop_location(p);
+			auto source = state.world.province_get_nation_from_province_ownership(location);
+			auto home_continent = state.world.province_get_continent(location);
+
+			auto key = (uint64_t(source.index()) << 40) | (uint64_t(pt.index()) << 24) | uint64_t(home_continent.index() + 1);
+			uint32_t group = 0;
+			if(auto it = group_indices.find(key); it != group_indices.end()) {
+				group = it->second;
+			} else {
+				group = uint32_t(groups.size());
+				groups.push_back(immigration_group{ source, pt, home_continent, immigration_candidates{} });
+				group_indices.insert_or_assign(key, group);
+				if(std::find(needed_types.begin(), needed_types.end(), pt) == needed_types.end())
+					needed_types.push_back(pt);
 			}
+			batched.push_back(pending_pop{ p, group });
+		}, ids);
+	});
+
+	if(!batched.empty()) {
+		std::vector<ve::vectorizable_buffer<float, dcon::nation_id>> type_weights;
+		for(uint32_t i = 0; i < state.world.pop_type_size(); ++i) {
+			type_weights.emplace_back(uint32_t(0));
 		}
+		for(auto pt : needed_types) {
+			type_weights[pt.index()] = state.world.nation_make_vectorizable_float_buffer();
+		}
+
+		concurrency::parallel_for(uint32_t(0), uint32_t(needed_types.size()), [&](uint32_t i) {
+			auto pt = needed_types[i];
+			auto modifier = state.world.pop_type_get_country_migration_target(pt);
+			auto& weights = type_weights[pt.index()];
+			ve::execute_serial_fast<dcon::nation_id>(state.world.nation_size(), [&](auto ids) {
+				weights.set(ids, trigger::evaluate_multiplicative_modifier(state, modifier, trigger::to_generic(ids), ve::tagged_vector<int32_t>(), 0)
+					* (state.world.nation_get_modifier_values(ids, sys::national_mod_offsets::global_immigrant_attract) + 1.0f));
+			});
+		});
+
+		concurrency::parallel_for(uint32_t(0), uint32_t(groups.size()), [&](uint32_t i) {
+			auto& g = groups[i];
+			auto& weights = type_weights[g.type.index()];
+			state.world.for_each_nation([&](dcon::nation_id inner) {
+				if(is_valid_immigration_target(state, g.source, inner, g.home_continent))
+					g.candidates.add(inner, weights.get(inner));
+			});
+		});
+
+		concurrency::parallel_for(uint32_t(0), uint32_t(batched.size()), [&](uint32_t i) {
+			auto p = batched[i].p;
+			pbuf.target_nations.set(p, groups[batched[i].group].candidates.pick(state, p));
+		});
+	}
+
+	concurrency::parallel_for(uint32_t(0), uint32_t(individual.size()), [&](uint32_t i) {
+		auto p = individual[i];
+		pbuf.target_nations.set(p, get_immigration_target(state, nations::owner_of_pop(state, p), p));
 	});
+}
 
-	float total_weight = top_weights[0] + top_weights[1] + top_weights[2];
-	if(total_weight <= 0.0f)
-		return dcon::nation_id{};
+/*
+Alias table (Vose's method) over the valid destination provinces of one migration group, so that each migrating pop
+picks its destination in constant time instead of scanning the provinces of the nation.
+*/
+struct province_alias_table {
+	std::vector<dcon::province_id> provinces;
+	std::vector<float> probabilities;
+	std::vector<uint32_t> aliases;
+
+	void build(std::vector<float> const& weights, float total_weight) {
+		auto count = uint32_t(provinces.size());
+		probabilities.resize(count);
+		aliases.resize(count);
+
+		std::vector<uint32_t> small;
+		std::vector<uint32_t> large;
+		for(uint32_t i = 0; i < count; ++i) {
+			probabilities[i] = weights[i] * float(count) / total_weight;
+			aliases[i] = i;
+			if(probabilities[i] < 1.0f)
+				small.push_back(i);
+			else
+				large.push_back(i);
+		}
+		while(!small.empty() && !large.empty()) {
+			auto s = small.back();
+			small.pop_back();
+			auto l = large.back();
+
+			aliases[s] = l;
+			probabilities[l] = (probabilities[l] + probabilities[s]) - 1.0f;
+			if(probabilities[l] < 1.0f) {
+				large.pop_back();
+				small.push_back(l);
+			}
+		}
+		// whatever is left is only off from 1.0 because of rounding
+		for(auto i : large)
+			probabilities[i] = 1.0f;
+		for(auto i : small)
+			probabilities[i] = 1.0f;
+	}
+	dcon::province_id sample(uint64_t random_value) const {
+		if(provinces.empty())
+			return dcon::province_id{};
+		auto slot = uint32_t(((random_value >> 32) * uint64_t(provinces.size())) >> 32);
+		auto coin = float(random_value & 0xFFFFFF) / float(0xFFFFFF + 1);
+		return coin < probabilities[slot] ? provinces[slot] : provinces[aliases[slot]];
+	}
+};
 
-	auto rvalue = float(rng::get_random(state, (uint32_t(p.index()) << 2) | uint32_t(3)) & 0xFFFF) / float(0xFFFF + 1);
-	for(uint32_t i = 0; i < 3; ++i) {
-		rvalue -= top_weights[i] / total_weight;
-		if(rvalue < 0.0f) {
-			return top_nations[i];
+struct migration_group {
+	dcon::nation_id target;
+	dcon::pop_type_id type;
+	dcon::modifier_id continent; // empty when the group is not restricted to a continent
+	province_alias_table table;
+};
+
+void resolve_migration_destinations(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf, bool colonial) {
+	/*
+	Picks destinations for every pop migrating today in one batch. The province weights (see get_province_target_in_nation and get_colonial_province_target_in_nation) only depend on the province and the pop type, unless the migration_target modifier looks at the pop itself through the this slot. So the weights are evaluated once per pop type over all provinces, and pops are grouped by (target nation, pop type, continent restriction) with one alias table per group. Pop types with pop dependent modifiers still go through the per pop functions.
+	*/
+	uint32_t const rng_salt = colonial ? uint32_t(2) : uint32_t(1);
+
+	struct pending_pop {
+		dcon::pop_id p;
+		uint32_t group = 0;
+	};
+	std::vector<pending_pop> batched;
+	std::vector<dcon::pop_id> individual;
+	std::vector<migration_group> groups;
+	ankerl::unordered_dense::map<uint64_t, uint32_t> group_indices;
+	std::vector<dcon::pop_type_id> needed_types;
+
+	execute_staggered_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](auto ids) {
+		ve::apply([&](dcon::pop_id p) {
+			if(pbuf.amounts.get(p) <= 0.0f)
+				return;
+			auto target = pbuf.target_nations.get(p);
+			if(!target)
+				return;
+			auto pt = state.world.pop_get_poptype(p);
+			auto modifier = state.world.pop_type_get_migration_target(pt);
+			if(!modifier)
+				return;
+			if(state.value_modifiers[modifier].uses_this_slot) {
+				individual.push_back(p);
+				return;
+			}
+
+			dcon::modifier_id continent;
+			if(colonial && !state.world.culture_get_group_from_culture_group_membership(state.world.pop_get_culture(p)))
+				continent = state.world.province_get_continent(state.world.pop_get_province_from_pop_location(p));
+
+			auto key = (uint64_t(target.index()) << 40) | (uint64_t(pt.index()) << 24) | uint64_t(continent.index() + 1);
+			uint32_t group = 0;
+			if(auto it = group_indices.find(key); it != group_indices.end()) {
+				group = it->second;
+			} else {
+				group = uint32_t(groups.size());
+				groups.push_back(migration_group{ target, pt, continent, province_alias_table{} });
+				group_indices.insert_or_assign(key, group);
+				if(std::find(needed_types.begin(), needed_types.end(), pt) == needed_types.end())
+					needed_types.push_back(pt);
+			}
+			batched.push_back(pending_pop{ p, group });
+		}, ids);
+	});
+
+	if(!batched.empty()) {
+		auto const land_provinces = uint32_t(state.province_definitions.first_sea_province.index());
+
+		auto attractiveness = state.world.province_make_vectorizable_float_buffer();
+		ve::execute_serial_fast<dcon::province_id>(land_provinces, [&](auto ids) {
+			auto focus_attract = ve::apply([&](dcon::province_id p) {
+				return fatten(state.world, p).get_state_membership().get_owner_focus().get_immigrant_attract();
+			}, ids);
+			attractiveness.set(ids, (state.world.province_get_modifier_values(ids, sys::provincial_mod_offsets::immigrant_attract) + 1.0f) * (focus_attract + 1.0f));
+		});
+
+		std::vector<ve::vectorizable_buffer<float, dcon::province_id>> type_weights;
+		for(uint32_t i = 0; i < state.world.pop_type_size(); ++i) {
+			type_weights.emplace_back(uint32_t(0));
+		}
+		for(auto pt : needed_types) {
+			type_weights[pt.index()] = state.world.province_make_vectorizable_float_buffer();
 		}
+
+		concurrency::parallel_for(uint32_t(0), uint32_t(needed_types.size()), [&](uint32_t i) {
+			auto pt = needed_types[i];
+			auto modifier = state.world.pop_type_get_migration_target(pt);
+			auto& weights = type_weights[pt.index()];
+			ve::execute_serial_fast<dcon::province_id>(land_provinces, [&](auto ids) {
+				weights.set(ids, trigger::evaluate_multiplicative_modifier(state, modifier, trigger::to_generic(ids), ve::tagged_vector<int32_t>(), 0) * attractiveness.get(ids));
+			});
+		});
+
+		concurrency::parallel_for(uint32_t(0), uint32_t(groups.size()), [&](uint32_t i) {
+			auto& g = groups[i];
+			auto& weights = type_weights[g.type.index()];
+			bool limit_to_capitals = state.world.pop_type_get_state_capital_only(g.type);
+
+			std::vector<float> group_weights;
+			float total_weight = 0.0f;
+			for(auto loc : state.world.nation_get_province_ownership(g.target)) {
+				auto prov = loc.get_province();
+				if(prov.get_is_colonial() != colonial)
+					continue;
+				if(g.continent && prov.get_continent() != g.continent)
+					continue;
+				if(limit_to_capitals && prov.get_state_membership().get_capital().id != prov.id)
+					continue;
+				auto weight = weights.get(prov);
+				if(weight > 0.0f) {
+					g.table.provinces.push_back(prov);
+					group_weights.push_back(weight);
+					total_weight += weight;
+				}
+			}
+			if(total_weight > 0.0f)
+				g.table.build(group_weights, total_weight);
+			else
+				g.table.provinces.clear();
+		});
+
+		concurrency::parallel_for(uint32_t(0), uint32_t(batched.size()), [&](uint32_t i) {
+			auto p = batched[i].p;
+			auto rvalue = rng::get_random(state, (uint32_t(p.index()) << 2) | rng_salt);
+			pbuf.destinations.set(p, groups[batched[i].group].table.sample(rvalue));
+		});
 	}
 
-	return dcon::nation_id{};
+	concurrency::parallel_for(uint32_t(0), uint32_t(individual.size()), [&](uint32_t i) {
+		auto p = individual[i];
+		auto target = pbuf.target_nations.get(p);
+		pbuf.destinations.set(p, colonial ? get_colonial_province_target_in_nation(state, target, p) : get_province_target_in_nation(state, target, p));
+	});
 }
 
 }
@@ -1377,12 +1877,13 @@ void update_internal_migration(sys::state& state, uint32_t offset, uint32_t divi
 			auto pop_size = state.world.pop_get_size(p);
 			amount = std::min(pop_size, std::ceil(amount));
 
-			auto dest = impl::get_province_target_in_nation(state, owner, p);
-
-			pbuf.destinations.set(p, dest);
+			pbuf.destinations.set(p, dcon::province_id{});
+			pbuf.target_nations.set(p, owner);
 			pbuf.amounts.set(p, amount);
 		}, ids, loc, owners, amounts);
 	});
+
+	impl::resolve_migration_destinations(state, offset, divisions, pbuf, false);
 }
 
 void update_colonial_migration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf) {
@@ -1422,13 +1923,14 @@ void update_colonial_migration(sys::state& state, uint32_t offset, uint32_t divi
 			auto pop_size = state.world.pop_get_size(p);
 			amount = std::min(pop_size, std::ceil(amount));
 
-			auto dest = impl::get_colonial_province_target_in_nation(state, owner, p);
-
-			pbuf.destinations.set(p, dest);
+			pbuf.destinations.set(p, dcon::province_id{});
+			pbuf.target_nations.set(p, owner);
 			pbuf.amounts.set(p, amount);
 
 		}, ids, loc, owners, amounts);
 	});
+
+	impl::resolve_migration_destinations(state, offset, divisions, pbuf, true);
 }
 
 void update_immigration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf) {
@@ -1469,30 +1971,95 @@ void update_immigration(sys::state& state, uint32_t offset, uint32_t divisions,
 			auto pop_size = state.world.pop_get_size(p);
 			amount = std::min(pop_size, std::ceil(amount));
 
-			auto ndest = impl::get_immigration_target(state, owner, p);
-			auto dest = impl::get_colonial_province_target_in_nation(state, ndest, p);
-
-			pbuf.destinations.set(p, dest);
+			pbuf.destinations.set(p, dcon::province_id{});
 			pbuf.amounts.set(p, amount);
 
 		}, ids, loc, owners, amounts);
 	});
+
+	impl::resolve_immigration_targets(state, offset, divisions, pbuf);
+	impl::resolve_migration_destinations(state, offset, divisions, pbuf, true);
+}
+
+void pop_index::insert_into(std::vector<entry>& table, uint64_t key, dcon::pop_id p) {
+	auto mask = uint32_t(table.size() - 1);
+	for(auto slot = hash_slot(key, mask); ; slot = (slot + 1) & mask) {
+		if(table[slot].key == 0) {
+			table[slot].key = key;
+			table[slot].pop = p;
+			return;
+		}
+		if(table[slot].key == key) {
+			return; // keep the first pop, as a linear search of the province would
+		}
+	}
+}
+
+void pop_index::rebuild(sys::state& state) {
+	tables.resize(state.world.province_size());
+	counts.resize(state.world.province_size());
+	concurrency::parallel_for(uint32_t(0), state.world.province_size(), [&](uint32_t i) {
+		dcon::province_id loc{ dcon::province_id::value_base_t(i) };
+		auto pops = state.world.province_get_pop_location(loc);
+
+		uint32_t count = 0;
+		for(auto pl : pops) {
+			(void)pl;
+			++count;
+		}
+		uint32_t capacity = 8;
+		while(capacity < count * 2)
+			capacity *= 2;
+
+		auto& table = tables[i];
+		table.assign(capacity, entry{});
+		for(auto pl : pops) {
+			auto pop = pl.get_pop();
+			insert_into(table, make_key(pop.get_culture(), pop.get_religion(), pop.get_poptype()), pop);
+		}
+		counts[i] = count;
+	});
+	valid = true;
+}
+
+dcon::pop_id pop_index::find(dcon::province_id loc, dcon::culture_id c, dcon::religion_id r, dcon::pop_type_id t) const {
+	auto& table = tables[loc.index()];
+	auto key = make_key(c, r, t);
+	auto mask = uint32_t(table.size() - 1);
+	for(auto slot = hash_slot(key, mask); ; slot = (slot + 1) & mask) {
+		if(table[slot].key == key)
+			return table[slot].pop;
+		if(table[slot].key == 0)
+			return dcon::pop_id{};
+	}
+}
+
+void pop_index::insert(dcon::province_id loc, dcon::culture_id c, dcon::religion_id r, dcon::pop_type_id t, dcon::pop_id p) {
+	auto& table = tables[loc.index()];
+	if((counts[loc.index()] + 1) * 4 > uint32_t(table.size()) * 3) { // keep the load factor under 3/4
+		std::vector<entry> larger(table.size() * 2);
+		for(auto& e : table) {
+			if(e.key != 0)
+				insert_into(larger, e.key, e.pop);
+		}
+		table = std::move(larger);
+	}
+	insert_into(table, make_key(c, r, t), p);
+	++counts[loc.index()];
 }
 
 namespace impl {
-dcon::pop_id find_or_make_pop(sys::state& state, dcon::province_id loc, dcon::culture_id cid, dcon::religion_id rid, dcon::pop_type_id ptid) {
+dcon::pop_type_id adjusted_pop_type(sys::state& state, dcon::province_id loc, dcon::pop_type_id ptid) {
 	bool is_mine = state.world.commodity_get_is_mine(state.world.province_get_rgo(loc));
 	if(is_mine && ptid == state.culture_definitions.farmers) {
-		ptid = state.culture_definitions.laborers;
+		return state.culture_definitions.laborers;
 	} else if(!is_mine && ptid == state.culture_definitions.laborers) {
-		ptid = state.culture_definitions.farmers;
-	}
-	// TODO: fix state capital only type pops ?
-	for(auto pl : state.world.province_get_pop_location(loc)) {
-		if(pl.get_pop().get_culture() == cid && pl.get_pop().get_religion() == rid && pl.get_pop().get_poptype() == ptid) {
-			return pl.get_pop();
-		}
+		return state.culture_definitions.farmers;
 	}
+	return ptid;
+}
+
+dcon::pop_id make_pop(sys::state& state, dcon::province_id loc, dcon::culture_id cid, dcon::religion_id rid, dcon::pop_type_id ptid) {
 	auto np = fatten(state.world, state.world.create_pop());
 	state.world.force_create_pop_location(np, loc);
 	np.set_culture(cid);
@@ -1585,110 +2152,263 @@ dcon::pop_id find_or_make_pop(sys::state& state, dcon::province_id loc, dcon::cu
 	}
 	return np;
 }
+
+dcon::pop_id find_or_make_pop(sys::state& state, pop_index& index, dcon::province_id loc, dcon::culture_id cid, dcon::religion_id rid, dcon::pop_type_id ptid) {
+	// TODO: fix state capital only type pops ?
+	ptid = adjusted_pop_type(state, loc, ptid);
+	if(auto existing = index.find(loc, cid, rid, ptid); existing)
+		return existing;
+	auto np = make_pop(state, loc, cid, rid, ptid);
+	index.insert(loc, cid, rid, ptid, np);
+	return np;
 }
+}
+
+void resolve_transfer_targets(sys::state& state, pop_index& index, std::vector<pop_transfer>& transfers) {
+	if(!index.is_valid())
+		index.rebuild(state);
 
-void apply_type_changes(sys::state& state, uint32_t offset, uint32_t divisions, promotion_buffer& pbuf) {
+	// lookups only read the index, so they can all happen at once
+	concurrency::parallel_for(uint32_t(0), uint32_t(transfers.size()), [&](uint32_t i) {
+		auto& t = transfers[i];
+		t.type = impl::adjusted_pop_type(state, t.location, t.type);
+		t.target = index.find(t.location, t.culture, t.religion, t.type);
+	});
+	// whatever is still missing is created in order, so that pop ids come out the same as when transfers are applied one by one
+	for(auto& t : transfers) {
+		if(!t.target)
+			t.target = impl::find_or_make_pop(state, index, t.location, t.culture, t.religion, t.type);
+	}
+}
+
+void apply_type_changes(sys::state& state, uint32_t offset, uint32_t divisions, promotion_buffer& pbuf, pop_index& index) {
+	std::vector<pop_transfer> transfers;
 	execute_staggered_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](auto ids) {
 		ve::apply([&](dcon::pop_id p) {
 			if(pbuf.amounts.get(p) > 0.0f && pbuf.types.get(p)) {
-				auto target_pop = impl::find_or_make_pop(state,
+				transfers.push_back(pop_transfer{ p,
 					state.world.pop_get_province_from_pop_location(p),
 					state.world.pop_get_culture(p),
 					state.world.pop_get_religion(p),
-					pbuf.types.get(p));
-				state.world.pop_get_size(p) -= pbuf.amounts.get(p);
-				state.world.pop_get_size(target_pop) += pbuf.amounts.get(p);
+					pbuf.types.get(p),
+					pbuf.amounts.get(p) });
 			}
 		}, ids);
 	});
+
+	resolve_transfer_targets(state, index, transfers);
+	for(auto& t : transfers) {
+		state.world.pop_get_size(t.source) -= t.amount;
+		state.world.pop_get_size(t.target) += t.amount;
+	}
 }
 
-void apply_assimilation(sys::state& state, uint32_t offset, uint32_t divisions, assimilation_buffer& pbuf) {
+void apply_assimilation(sys::state& state, uint32_t offset, uint32_t divisions, assimilation_buffer& pbuf, pop_index& index) {
+	std::vector<pop_transfer> transfers;
 	execute_staggered_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](auto ids) {
 		ve::apply([&](dcon::pop_id p) {
 			if(pbuf.amounts.get(p) > 0.0f) {
 				auto o = nations::owner_of_pop(state, p);
-				auto cul = state.world.nation_get_primary_culture(o);
-				auto rel = state.world.nation_get_religion(o);
 				assert(state.world.pop_get_poptype(p));
-				auto target_pop = impl::find_or_make_pop(state,
+				transfers.push_back(pop_transfer{ p,
 					state.world.pop_get_province_from_pop_location(p),
-					cul,
-					rel,
-					state.world.pop_get_poptype(p));
-				state.world.pop_get_size(p) -= pbuf.amounts.get(p);
-				state.world.pop_get_size(target_pop) += pbuf.amounts.get(p);
+					state.world.nation_get_primary_culture(o),
+					state.world.nation_get_religion(o),
+					state.world.pop_get_poptype(p),
+					pbuf.amounts.get(p) });
 			}
 		}, ids);
 	});
+
+	resolve_transfer_targets(state, index, transfers);
+	for(auto& t : transfers) {
+		state.world.pop_get_size(t.source) -= t.amount;
+		state.world.pop_get_size(t.target) += t.amount;
+	}
 }
 
-void apply_internal_migration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf) {
+namespace impl {
+void gather_migration_transfers(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf, std::vector<pop_transfer>& transfers) {
 	execute_staggered_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](auto ids) {
 		ve::apply([&](dcon::pop_id p) {
 			if(pbuf.amounts.get(p) > 0.0f && pbuf.destinations.get(p)) {
 				assert(state.world.pop_get_poptype(p));
-				auto target_pop = impl::find_or_make_pop(state,
+				transfers.push_back(pop_transfer{ p,
 					pbuf.destinations.get(p),
 					state.world.pop_get_culture(p),
 					state.world.pop_get_religion(p),
-					state.world.pop_get_poptype(p));
-				state.world.pop_get_size(p) -= pbuf.amounts.get(p);
-				state.world.pop_get_size(target_pop) += pbuf.amounts.get(p);
-				state.world.province_get_daily_net_migration(state.world.pop_get_province_from_pop_location(p)) -= pbuf.amounts.get(p);
-				state.world.province_get_daily_net_migration(pbuf.destinations.get(p)) += pbuf.amounts.get(p);
+					state.world.pop_get_poptype(p),
+					pbuf.amounts.get(p) });
 			}
 		}, ids);
 	});
 }
+}
 
-void apply_colonial_migration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf) {
-	execute_staggered_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](auto ids) {
-		ve::apply([&](dcon::pop_id p) {
-			if(pbuf.amounts.get(p) > 0.0f && pbuf.destinations.get(p)) {
-				assert(state.world.pop_get_poptype(p));
-				auto target_pop = impl::find_or_make_pop(state,
-					pbuf.destinations.get(p),
-					state.world.pop_get_culture(p),
-					state.world.pop_get_religion(p),
-					state.world.pop_get_poptype(p));
-				state.world.pop_get_size(p) -= pbuf.amounts.get(p);
-				state.world.pop_get_size(target_pop) += pbuf.amounts.get(p);
-				state.world.province_get_daily_net_migration(state.world.pop_get_province_from_pop_location(p)) -= pbuf.amounts.get(p);
-				state.world.province_get_daily_net_migration(pbuf.destinations.get(p)) += pbuf.amounts.get(p);
-			}
-		}, ids);
-	});
+void apply_internal_migration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf, pop_index& index) {
+	std::vector<pop_transfer> transfers;
+	impl::gather_migration_transfers(state, offset, divisions, pbuf, transfers);
+
+	resolve_transfer_targets(state, index, transfers);
+	for(auto& t : transfers) {
+		state.world.pop_get_size(t.source) -= t.amount;
+		state.world.pop_get_size(t.target) += t.amount;
+		state.world.province_get_daily_net_migration(state.world.pop_get_province_from_pop_location(t.source)) -= t.amount;
+		state.world.province_get_daily_net_migration(t.location) += t.amount;
+	}
 }
 
-void apply_immigration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf) {
-	execute_staggered_blocks(offset, divisions, std::min(state.world.pop_size(), pbuf.size), [&](auto ids) {
-		ve::apply([&](dcon::pop_id p) {
-			if(pbuf.amounts.get(p) > 0.0f && pbuf.destinations.get(p)) {
-				assert(state.world.pop_get_poptype(p));
-				auto target_pop = impl::find_or_make_pop(state,
-					pbuf.destinations.get(p),
-					state.world.pop_get_culture(p),
-					state.world.pop_get_religion(p),
-					state.world.pop_get_poptype(p));
-				state.world.pop_get_size(p) -= pbuf.amounts.get(p);
-				state.world.pop_get_size(target_pop) += pbuf.amounts.get(p);
-				state.world.province_get_daily_net_immigration(state.world.pop_get_province_from_pop_location(p)) -= pbuf.amounts.get(p);
-				state.world.province_get_daily_net_immigration(pbuf.destinations.get(p)) += pbuf.amounts.get(p);
-				state.world.province_set_last_immigration(pbuf.destinations.get(p), state.current_date);
-			}
-		}, ids);
-	});
+void apply_colonial_migration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf, pop_index& index) {
+	std::vector<pop_transfer> transfers;
+	impl::gather_migration_transfers(state, offset, divisions, pbuf, transfers);
+
+	resolve_transfer_targets(state, index, transfers);
+	for(auto& t : transfers) {
+		state.world.pop_get_size(t.source) -= t.amount;
+		state.world.pop_get_size(t.target) += t.amount;
+		state.world.province_get_daily_net_migration(state.world.pop_get_province_from_pop_location(t.source)) -= t.amount;
+		state.world.province_get_daily_net_migration(t.location) += t.amount;
+	}
+}
+
+void apply_immigration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf, pop_index& index) {
+	std::vector<pop_transfer> transfers;
+	impl::gather_migration_transfers(state, offset, divisions, pbuf, transfers);
+
+	resolve_transfer_targets(state, index, transfers);
+	for(auto& t : transfers) {
+		state.world.pop_get_size(t.source) -= t.amount;
+		state.world.pop_get_size(t.target) += t.amount;
+		state.world.province_get_daily_net_immigration(state.world.pop_get_province_from_pop_location(t.source)) -= t.amount;
+		state.world.province_get_daily_net_immigration(t.location) += t.amount;
+		state.world.province_set_last_immigration(t.location, state.current_date);
+	}
 }
 
 
 void remove_size_zero_pops(sys::state& state) {
-	// IMPORTANT: we count down here so that we can delete as we go, compacting from the end
-	for(auto last = state.world.pop_size(); last-- > 0; ) {
-		dcon::pop_id m{ dcon::pop_id::value_base_t(last) };
-		if(state.world.pop_get_size(m) < 1.0f) {
-			state.world.delete_pop(m);
+	/*
+	Rather than deleting pops one at a time (each deletion swaps the last pop into the hole, which reshuffles the pop table every
+	day), the dead pops are marked and the survivors slide down over the holes: each property is copied in one streaming pass,
+	the table is truncated once, and then the relationships of the moved pops are rebuilt. Pops before the first hole keep their
+	ids, the survivors keep their relative order, and so does the list of pops in each province.
+	*/
+	auto const count = state.world.pop_size();
+	uint32_t first = 0;
+	while(first < count && state.world.pop_get_size(dcon::pop_id{ dcon::pop_id::value_base_t(first) }) >= 1.0f)
+		++first;
+	if(first == count)
+		return;
+
+	// new_id[i - first] is where pop i ends up (invalid if it dies); moved_from[k] is the pop that ends up at first + k
+	std::vector<dcon::pop_id> new_id(count - first);
+	std::vector<uint32_t> moved_from;
+	moved_from.reserve(count - first);
+	for(uint32_t i = first; i < count; ++i) {
+		dcon::pop_id p{ dcon::pop_id::value_base_t(i) };
+		if(state.world.pop_get_size(p) < 1.0f) {
+			military::remove_pop_regiment_counts(state, p);
+		} else {
+			new_id[i - first] = dcon::pop_id{ dcon::pop_id::value_base_t(first + moved_from.size()) };
+			moved_from.push_back(i);
+		}
+	}
+	auto remap = [&](dcon::pop_id p) {
+		return uint32_t(p.index()) < first ? p : new_id[uint32_t(p.index()) - first];
+	};
+
+	// take down every relationship that mentions a pop from the first hole onwards, remembering what it was
+	std::vector<bool> province_affected(state.world.province_size(), false);
+	for(uint32_t i = first; i < count; ++i) {
+		if(auto loc = state.world.pop_get_province_from_pop_location(dcon::pop_id{ dcon::pop_id::value_base_t(i) }); loc)
+			province_affected[loc.index()] = true;
+	}
+	std::vector<std::pair<dcon::province_id, dcon::pop_id>> locations; // grouped by province, in the order of each province
+	for(uint32_t i = 0; i < province_affected.size(); ++i) {
+		if(!province_affected[i])
+			continue;
+		dcon::province_id prov{ dcon::province_id::value_base_t(i) };
+		for(auto pl : state.world.province_get_pop_location(prov))
+			locations.emplace_back(prov, pl.get_pop().id);
+	}
+	for(auto& l : locations)
+		state.world.delete_pop_location(state.world.pop_get_pop_location(l.second));
+
+	std::vector<dcon::movement_id> movements(moved_from.size());
+	std::vector<dcon::rebel_faction_id> factions(moved_from.size());
+	for(uint32_t i = first; i < count; ++i) {
+		dcon::pop_id p{ dcon::pop_id::value_base_t(i) };
+		if(auto n = new_id[i - first]; n) {
+			movements[n.index() - first] = state.world.pop_get_movement_from_pop_movement_membership(p);
+			factions[n.index() - first] = state.world.pop_get_rebel_faction_from_pop_rebellion_membership(p);
+		}
+		if(auto m = state.world.pop_get_pop_movement_membership(p); m)
+			state.world.delete_pop_movement_membership(m);
+		if(auto r = state.world.pop_get_pop_rebellion_membership(p); r)
+			state.world.delete_pop_rebellion_membership(r);
+	}
+
+	std::vector<std::pair<dcon::regiment_id, dcon::pop_id>> sources;
+	state.world.for_each_regiment([&](dcon::regiment_id r) {
+		auto p = state.world.regiment_get_pop_from_regiment_source(r);
+		if(p && uint32_t(p.index()) >= first) {
+			sources.emplace_back(r, p);
+			state.world.delete_regiment_source(state.world.regiment_get_regiment_source(r));
 		}
+	});
+
+	// slide the survivors down, one property at a time; a pop only ever moves to a lower slot, so copying forwards is safe
+	auto compact = [&](auto&& get, auto&& set) {
+		for(uint32_t k = 0; k < uint32_t(moved_from.size()); ++k)
+			set(dcon::pop_id{ dcon::pop_id::value_base_t(first + k) }, get(dcon::pop_id{ dcon::pop_id::value_base_t(moved_from[k]) }));
+	};
+#define ALICE_COMPACT_POP_PROPERTY(name) \
+	compact([&](dcon::pop_id p) { return state.world.pop_get_##name(p); }, [&](dcon::pop_id p, auto v) { state.world.pop_set_##name(p, v); })
+	ALICE_COMPACT_POP_PROPERTY(poptype);
+	ALICE_COMPACT_POP_PROPERTY(religion);
+	ALICE_COMPACT_POP_PROPERTY(culture);
+	ALICE_COMPACT_POP_PROPERTY(size);
+	ALICE_COMPACT_POP_PROPERTY(savings);
+	ALICE_COMPACT_POP_PROPERTY(consciousness);
+	ALICE_COMPACT_POP_PROPERTY(militancy);
+	ALICE_COMPACT_POP_PROPERTY(literacy);
+	ALICE_COMPACT_POP_PROPERTY(employment);
+	ALICE_COMPACT_POP_PROPERTY(life_needs_satisfaction);
+	ALICE_COMPACT_POP_PROPERTY(everyday_needs_satisfaction);
+	ALICE_COMPACT_POP_PROPERTY(luxury_needs_satisfaction);
+	ALICE_COMPACT_POP_PROPERTY(political_reform_desire);
+	ALICE_COMPACT_POP_PROPERTY(social_reform_desire);
+	ALICE_COMPACT_POP_PROPERTY(dominant_ideology);
+	ALICE_COMPACT_POP_PROPERTY(dominant_issue_option);
+	ALICE_COMPACT_POP_PROPERTY(is_primary_or_accepted_culture);
+	ALICE_COMPACT_POP_PROPERTY(regiment_capacity);
+	ALICE_COMPACT_POP_PROPERTY(counted_regiments);
+	ALICE_COMPACT_POP_PROPERTY(counted_as_main_culture);
+	ALICE_COMPACT_POP_PROPERTY(main_culture_regiment_capacity);
+#undef ALICE_COMPACT_POP_PROPERTY
+	auto const sz = pop_demographics::size(state);
+	for(uint32_t i = 0; i < sz; ++i) {
+		dcon::pop_demographics_key key{ dcon::pop_demographics_key::value_base_t(i) };
+		compact([&](dcon::pop_id p) { return state.world.pop_get_demographics(p, key); }, [&](dcon::pop_id p, float v) { state.world.pop_set_demographics(p, key, v); });
+	}
+
+	state.world.pop_resize(first + uint32_t(moved_from.size()));
+
+	// and put the relationships back, under the new ids
+	for(auto& l : locations) {
+		if(auto p = remap(l.second); p)
+			state.world.force_create_pop_location(p, l.first);
+	}
+	for(uint32_t k = 0; k < uint32_t(moved_from.size()); ++k) {
+		dcon::pop_id p{ dcon::pop_id::value_base_t(first + k) };
+		if(movements[k])
+			state.world.try_create_pop_movement_membership(p, movements[k]);
+		if(factions[k])
+			state.world.try_create_pop_rebellion_membership(p, factions[k]);
+	}
+	for(auto& s : sources) {
+		if(auto p = remap(s.second); p)
+			state.world.force_create_regiment_source(s.first, p);
 	}
 }
 
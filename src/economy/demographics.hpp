@@ -1,6 +1,12 @@
 #pragma once
 #include "dcon_generated.hpp"
 #include "container_types.hpp"
+#include <array>
+#include <chrono>
+
+namespace parsing {
+struct defines;
+}
 
 namespace pop_demographics {
 
@@ -96,6 +102,35 @@ struct issues_buffer {
 	}
 };
 
+/*
+Pending ideology or issue attraction for pops, packed as an array of structures of arrays. Each block of pop_block_size pops
+(one staggered update block) stores the values of every key for those pops next to each other, followed by their totals, so
+that accumulating, normalizing and applying a block works through one contiguous run of memory instead of touching a separate
+buffer per key. Used in place of ideology_buffer and issues_buffer when built with ALICE_PACKED_POP_DEMOGRAPHICS.
+*/
+struct packed_attraction_buffer {
+	static constexpr uint32_t pop_block_size = 16;
+
+	std::vector<float> values;
+	uint32_t key_count = 0;
+	uint32_t size = 0;
+
+	void update(uint32_t keys, uint32_t s) {
+		if(key_count != keys || size < s) {
+			key_count = keys;
+			size = s;
+			values.resize(size_t((s + pop_block_size - 1) / pop_block_size) * (keys + 1) * pop_block_size);
+		}
+	}
+	// values of key k for the block of pops starting at first_pop, which must be a multiple of pop_block_size
+	float* row(uint32_t first_pop, uint32_t k) {
+		return values.data() + (size_t(first_pop / pop_block_size) * (key_count + 1) + k) * pop_block_size;
+	}
+	float* totals(uint32_t first_pop) {
+		return row(first_pop, key_count);
+	}
+};
+
 struct promotion_buffer {
 	ve::vectorizable_buffer<float, dcon::pop_id> amounts;
 	ve::vectorizable_buffer<dcon::pop_type_id, dcon::pop_id> types;
@@ -131,25 +166,125 @@ struct assimilation_buffer {
 struct migration_buffer {
 	ve::vectorizable_buffer<float, dcon::pop_id> amounts;
 	ve::vectorizable_buffer<dcon::province_id, dcon::pop_id> destinations;
+	ve::vectorizable_buffer<dcon::nation_id, dcon::pop_id> target_nations; // filled by the update functions, used to pick destinations in one batch
 	uint32_t size = 0;
 	uint32_t reserved = 0;
 
-	migration_buffer() : amounts(0), destinations(0), size(0) { }
+	migration_buffer() : amounts(0), destinations(0), target_nations(0), size(0) { }
 	void update(uint32_t s) {
 		size = s;
 		if(reserved < s) {
 			reserved = s;
 			amounts = ve::vectorizable_buffer<float, dcon::pop_id>(s);
 			destinations = ve::vectorizable_buffer<dcon::province_id, dcon::pop_id>(s);
+			target_nations = ve::vectorizable_buffer<dcon::nation_id, dcon::pop_id>(s);
 		}
 	}
 };
 
+/*
+Per province open addressing table from (culture, religion, pop type) to the pop with those values, used to find the
+pop that a promotion, assimilation or migration goes to. It is rebuilt once a day before the sequential apply functions
+and is kept current by the pops they create; anything else that adds, removes, moves or changes pops must invalidate it.
+*/
+class pop_index {
+public:
+	void rebuild(sys::state& state);
+	dcon::pop_id find(dcon::province_id loc, dcon::culture_id c, dcon::religion_id r, dcon::pop_type_id t) const;
+	void insert(dcon::province_id loc, dcon::culture_id c, dcon::religion_id r, dcon::pop_type_id t, dcon::pop_id p);
+	void invalidate() {
+		valid = false;
+	}
+	bool is_valid() const {
+		return valid;
+	}
+
+private:
+	struct entry {
+		uint64_t key = 0; // 0 = empty
+		dcon::pop_id pop;
+	};
+	static uint64_t make_key(dcon::culture_id c, dcon::religion_id r, dcon::pop_type_id t) {
+		return (uint64_t(c.index() + 1) << 32) | (uint64_t(r.index() + 1) << 16) | uint64_t(t.index() + 1);
+	}
+	static uint32_t hash_slot(uint64_t key, uint32_t mask) {
+		auto h = key * 0x9E3779B97F4A7C15ull;
+		return uint32_t(h >> 32) & mask;
+	}
+	static void insert_into(std::vector<entry>& table, uint64_t key, dcon::pop_id p);
+
+	std::vector<std::vector<entry>> tables; // indexed by province, power of two sizes
+	std::vector<uint32_t> counts;
+	bool valid = false;
+};
+
+// a transfer of part of a pop to the pop with the given location, culture, religion and type
+struct pop_transfer {
+	dcon::pop_id source;
+	dcon::province_id location;
+	dcon::culture_id culture;
+	dcon::religion_id religion;
+	dcon::pop_type_id type;
+	float amount = 0.0f;
+	dcon::pop_id target; // set by resolve_transfer_targets
+};
+// finds the target pops of all the transfers in parallel, then creates the missing ones in transfer order
+void resolve_transfer_targets(sys::state& state, pop_index& index, std::vector<pop_transfer>& transfers);
+
+enum class pop_update : uint8_t {
+	ideologies, issues, militancy, consciousness, literacy, growth, type_changes, assimilation, internal_migration, colonial_migration, immigration,
+	count
+};
+
+/*
+Decides which slice of the pop blocks each staggered pop update works on each day. An update with a period of n days visits
+1 / n of the blocks every day (by default n is the length of the month, as before), and its phase keeps paired updates and
+applications of the same buffer on the same slice. The periods come from the pop_update_period_* defines. It also keeps a
+running measurement of what each update costs, so that the day's updates can be started most expensive first.
+*/
+class pop_update_scheduler {
+public:
+	pop_update_scheduler();
+
+	// 0 = once per month
+	void set_period(pop_update u, uint32_t days) {
+		assert(days <= 255);
+		periods[uint32_t(u)] = uint8_t(days);
+	}
+	// takes the periods from the defines, rounded and limited to the range that set_period accepts
+	void configure(parsing::defines const& d);
+	uint32_t divisions(pop_update u, uint32_t days_in_month) const;
+	uint32_t offset(pop_update u, sys::date today, uint32_t day_of_month, uint32_t days_in_month) const;
+
+	template<typename F>
+	void run(pop_update u, F&& f) {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		record(u, std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+	void record(pop_update u, float milliseconds);
+	float cost(pop_update u) const {
+		return costs[uint32_t(u)];
+	}
+	// reorders the updates so that the most expensive (as measured so far) come first
+	void order_by_cost(pop_update* first, pop_update* last) const;
+
+private:
+	std::array<uint8_t, size_t(pop_update::count)> periods;
+	std::array<uint8_t, size_t(pop_update::count)> phases;
+	std::array<float, size_t(pop_update::count)> costs;
+};
+
+// how many 16 pop blocks each task of a parallel staggered update handles
+uint32_t staggered_blocks_per_task(uint32_t block_count);
+
 void update_literacy(sys::state& state, uint32_t offset, uint32_t divisions);
 void update_consciousness(sys::state& state, uint32_t offset, uint32_t divisions);
 void update_militancy(sys::state& state, uint32_t offset, uint32_t divisions);
 void update_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, ideology_buffer& ibuf);
 void update_issues(sys::state& state, uint32_t offset, uint32_t divisions, issues_buffer& ibuf);
+void update_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, packed_attraction_buffer& ibuf);
+void update_issues(sys::state& state, uint32_t offset, uint32_t divisions, packed_attraction_buffer& ibuf);
 void update_growth(sys::state& state, uint32_t offset, uint32_t divisions);
 void update_type_changes(sys::state& state, uint32_t offset, uint32_t divisions, promotion_buffer& pbuf);
 void update_assimilation(sys::state& state, uint32_t offset, uint32_t divisions, assimilation_buffer& pbuf);
@@ -163,11 +298,13 @@ float get_estimated_con_change(sys::state& state, dcon::nation_id n);
 
 void apply_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, ideology_buffer& pbuf);
 void apply_issues(sys::state& state, uint32_t offset, uint32_t divisions, issues_buffer& pbuf);
-void apply_type_changes(sys::state& state, uint32_t offset, uint32_t divisions, promotion_buffer& pbuf);
-void apply_assimilation(sys::state& state, uint32_t offset, uint32_t divisions, assimilation_buffer& pbuf);
-void apply_internal_migration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf);
-void apply_colonial_migration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf);
-void apply_immigration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf);
+void apply_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, packed_attraction_buffer& pbuf);
+void apply_issues(sys::state& state, uint32_t offset, uint32_t divisions, packed_attraction_buffer& pbuf);
+void apply_type_changes(sys::state& state, uint32_t offset, uint32_t divisions, promotion_buffer& pbuf, pop_index& index);
+void apply_assimilation(sys::state& state, uint32_t offset, uint32_t divisions, assimilation_buffer& pbuf, pop_index& index);
+void apply_internal_migration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf, pop_index& index);
+void apply_colonial_migration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf, pop_index& index);
+void apply_immigration(sys::state& state, uint32_t offset, uint32_t divisions, migration_buffer& pbuf, pop_index& index);
 
 void remove_size_zero_pops(sys::state& state);
 
@@ -2873,10 +2873,12 @@ void resolve_constructions(sys::state& state) {
 							auto new_army = fatten(state.world, state.world.create_army());
 							new_army.set_controller_from_army_control(c.get_nation());
 							new_army.set_location_from_army_location(p);
+							military::register_army(state, new_army);
 							return new_army.id;
 						}();
 						state.world.try_create_army_membership(new_reg, a);
 						state.world.try_create_regiment_source(new_reg, free_pop);
+						military::update_pop_regiment_counts(state, free_pop);
 					}
 					state.world.delete_province_land_construction(c);
 				}
@@ -2911,6 +2913,7 @@ void resolve_constructions(sys::state& state) {
 						auto new_navy = fatten(state.world, state.world.create_navy());
 						new_navy.set_controller_from_navy_control(c.get_nation());
 						new_navy.set_location_from_navy_location(p);
+						military::register_navy(state, new_navy);
 						return new_navy.id;
 					}();
 					state.world.try_create_navy_membership(new_ship, a);
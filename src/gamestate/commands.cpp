@@ -2181,19 +2181,17 @@ void respond_to_diplomatic_message(sys::state& state, dcon::nation_id source, dc
 	auto b = state.incoming_commands.try_push(p);
 }
 void execute_respond_to_diplomatic_message(sys::state& state, dcon::nation_id source, dcon::nation_id from, diplomatic_message::type type, bool accept) {
-	for(auto& m : state.pending_messages) {
-		if(m.type == type && m.from == from && m.to == source) {
-
-			if(accept)
-				diplomatic_message::accept_message(state, m);
-			else
-				diplomatic_message::decline_message(state, m);
+	auto slot = state.pending_messages.find(source, from, type);
+	if(slot == -1)
+		return;
 
-			m.type = diplomatic_message::type::none;
+	auto m = state.pending_messages.get(uint32_t(slot));
+	state.pending_messages.remove(uint32_t(slot));
 
-			return;
-		}
-	}
+	if(accept)
+		diplomatic_message::accept_message(state, m);
+	else
+		diplomatic_message::decline_message(state, m);
 }
 
 void cancel_military_access(sys::state& state, dcon::nation_id source, dcon::nation_id target) {
@@ -2461,6 +2459,7 @@ void execute_pending_commands(sys::state& state) {
 	}
 
 	if(command_executed) {
+		diplomatic_message::resolve_ai_messages(state); // the requests the commands just made of ai nations
 		state.game_state_updated.store(true, std::memory_order::release);
 	}
 }
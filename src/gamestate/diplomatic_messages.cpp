@@ -1,6 +1,8 @@
 #include "diplomatic_messages.hpp"
 #include "system_state.hpp"
 #include "commands.hpp"
+#include <algorithm>
+#include <functional>
 
 namespace diplomatic_message {
 
@@ -103,53 +105,172 @@ void accept_message(sys::state& state, message const& m) {
 	}
 }
 
+namespace impl {
+
+struct expiry_order {
+	template<typename T>
+	bool operator()(T const& a, T const& b) const { // std::push_heap keeps the greatest on top, so "greater" makes a min-heap
+		return a.due > b.due || (a.due == b.due && a.slot > b.slot);
+	}
+};
+
+}
+
+uint32_t pending_message_queue::add(message const& m) {
+	uint32_t slot = 0;
+	if(!free_slots.empty()) {
+		std::pop_heap(free_slots.begin(), free_slots.end(), std::greater<uint32_t>{});
+		slot = free_slots.back();
+		free_slots.pop_back();
+	} else {
+		slot = uint32_t(slots.size());
+		slots.emplace_back();
+		generations.push_back(0);
+	}
+	std::memcpy(&slots[slot], &m, sizeof(message));
+
+	auto to = size_t(m.to.index());
+	if(to >= by_recipient.size())
+		by_recipient.resize(to + 1);
+	by_recipient[to].push_back(slot);
+
+	expiries.push_back(expiry{ (m.when + message_expiration_days).value, slot, generations[slot] });
+	std::push_heap(expiries.begin(), expiries.end(), impl::expiry_order{});
+
+	return slot;
+}
+
+void pending_message_queue::remove(uint32_t slot) {
+	auto& list = by_recipient[size_t(slots[slot].to.index())];
+	for(size_t i = 0; i < list.size(); ++i) {
+		if(list[i] == slot) {
+			list[i] = list.back();
+			list.pop_back();
+			break;
+		}
+	}
+	slots[slot].type = type::none;
+	++generations[slot];
+	free_slots.push_back(slot);
+	std::push_heap(free_slots.begin(), free_slots.end(), std::greater<uint32_t>{});
+}
+
+int32_t pending_message_queue::find(dcon::nation_id to, dcon::nation_id from, type_t t) const {
+	auto index = size_t(to.index());
+	if(!to || index >= by_recipient.size())
+		return -1;
+	int32_t result = -1;
+	for(auto slot : by_recipient[index]) { // the lowest matching slot, as with a scan over all of them
+		if(slots[slot].from == from && slots[slot].type == t && (result == -1 || slot < uint32_t(result)))
+			result = int32_t(slot);
+	}
+	return result;
+}
+
+void pending_message_queue::take_expired(sys::date today, std::vector<message>& out) {
+	std::vector<uint32_t> due_slots;
+	while(!expiries.empty() && expiries.front().due <= today.value) {
+		auto e = expiries.front();
+		std::pop_heap(expiries.begin(), expiries.end(), impl::expiry_order{});
+		expiries.pop_back();
+		if(generations[e.slot] == e.generation && slots[e.slot].type != type::none) // otherwise stale: removed already
+			due_slots.push_back(e.slot);
+	}
+	std::sort(due_slots.begin(), due_slots.end());
+	for(auto slot : due_slots) {
+		out.push_back(slots[slot]);
+		remove(slot);
+	}
+}
+
+void pending_message_queue::rebuild_indices() {
+	free_slots.clear();
+	generations.assign(slots.size(), 0);
+	by_recipient.clear();
+	expiries.clear();
+
+	for(uint32_t i = 0; i < uint32_t(slots.size()); ++i) {
+		if(slots[i].type == type::none) {
+			free_slots.push_back(i); // ascending, which is already a valid min-heap
+			continue;
+		}
+		auto to = size_t(slots[i].to.index());
+		if(to >= by_recipient.size())
+			by_recipient.resize(to + 1);
+		by_recipient[to].push_back(i);
+		expiries.push_back(expiry{ (slots[i].when + message_expiration_days).value, i, 0 });
+	}
+	std::make_heap(expiries.begin(), expiries.end(), impl::expiry_order{});
+}
+
 void post_message(sys::state& state, message const& m) {
+	message posted;
+	std::memcpy(&posted, &m, sizeof(message));
+	posted.when = state.current_date;
+
 	if(state.world.nation_get_is_player_controlled(m.to) == false) {
+		state.ai_messages.push_back(posted);
+		return;
+	}
+
+	state.pending_messages.add(posted);
+	if(posted.to == state.local_player_nation) {
+		state.new_requests.push(posted);
+	}
+}
+
+void resolve_ai_messages(sys::state& state) {
+	// answering may post further requests (a refused crisis request asks the next great power), which land at the back
+	for(size_t i = 0; i < state.ai_messages.size(); ++i) {
+		auto m = state.ai_messages[i];
+
+		if(state.world.nation_get_is_player_controlled(m.to)) { // changed hands since it was posted
+			state.pending_messages.add(m);
+			if(m.to == state.local_player_nation) {
+				state.new_requests.push(m);
+			}
+			continue;
+		}
+
 		// TODO : call AI logic to decide responses to requests
 
 		switch(m.type) {
 			case type::none:
 				std::abort();
-				return;
+				break;
 			case type::access_request:
 				accept_message(state, m);
-				return;
+				break;
 			case type::alliance_request:
 				decline_message(state, m);
-				return;
+				break;
 			case type::call_ally_request:
 				decline_message(state, m);
-				return;
+				break;
+			// a nation that has gone to war since it was asked is no longer eligible (see nations::ask_to_defend_in_crisis)
 			case type::be_crisis_primary_defender:
-				nations::add_as_primary_crisis_defender(state, m.to);
-				return;
+				if(state.world.nation_get_is_at_war(m.to))
+					nations::reject_crisis_participation(state);
+				else
+					nations::add_as_primary_crisis_defender(state, m.to);
+				break;
 			case type::be_crisis_primary_attacker:
-				nations::add_as_primary_crisis_attacker(state, m.to);
-				return;
-		}
-	}
-
-	for(auto& i : state.pending_messages) {
-		if(i.type == type::none) {
-			std::memcpy(&i, &m, sizeof(message));
-			i.when = state.current_date;
-
-			if(i.to == state.local_player_nation) {
-				state.new_requests.push(i);
-			}
-
-			return;
+				if(state.world.nation_get_is_at_war(m.to))
+					nations::reject_crisis_participation(state);
+				else
+					nations::add_as_primary_crisis_attacker(state, m.to);
+				break;
 		}
 	}
+	state.ai_messages.clear();
 }
 
 void update_pending_messages(sys::state& state) {
-	for(auto& m : state.pending_messages) {
-		if(m.type != type::none && m.when + 31 <= state.current_date) {
-
-			decline_message(state, m);
-			m.type = type::none;
-		}
+	static std::vector<message> expired;
+	expired.clear();
+	state.pending_messages.take_expired(state.current_date, expired);
+	for(auto& m : expired) {
+		decline_message(state, m);
 	}
 }
 
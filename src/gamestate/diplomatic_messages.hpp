@@ -2,6 +2,7 @@
 
 #include "dcon_generated.hpp"
 #include "container_types.hpp"
+#include <vector>
 
 namespace diplomatic_message {
 
@@ -30,10 +31,53 @@ struct message {
 
 using type = type_t;
 
+inline constexpr int32_t message_expiration_days = 31;
+
+/*
+The requests waiting on a player's answer. Messages live in a growable array of slots, where a type of none marks a free slot
+and the lowest free slot is reused before the array grows. Next to it sit an index of the occupied slots by recipient, which is
+what answering a request searches, and a min-heap of the dates on which the messages expire (message_expiration_days after
+being posted). Removing a message leaves its heap entry behind; a per slot generation count identifies such stale entries when
+they surface. Only the slots are saved, the indices are rebuilt by rebuild_indices after loading.
+*/
+class pending_message_queue {
+public:
+	uint32_t add(message const& m); // returns the slot holding the message
+	void remove(uint32_t slot);
+	int32_t find(dcon::nation_id to, dcon::nation_id from, type_t t) const; // the slot, or -1
+	message const& get(uint32_t slot) const {
+		return slots[slot];
+	}
+	size_t size() const {
+		return slots.size() - free_slots.size();
+	}
+	// moves the messages that are due on or before today out of the queue and into out, in slot order
+	void take_expired(sys::date today, std::vector<message>& out);
+	void rebuild_indices();
+
+	std::vector<message> slots;
+
+private:
+	struct expiry {
+		uint16_t due = 0;
+		uint32_t slot = 0;
+		uint32_t generation = 0;
+	};
+
+	std::vector<uint32_t> free_slots; // a heap, lowest on top
+	std::vector<uint32_t> generations;
+	std::vector<std::vector<uint32_t>> by_recipient; // occupied slots, by recipient nation index
+	std::vector<expiry> expiries; // a heap, earliest due date (then lowest slot) on top
+};
+
 void decline_message(sys::state& state, message const& m);
 void accept_message(sys::state& state, message const& m);
 
+// Requests to AI nations are not answered here; they wait in state.ai_messages until resolve_ai_messages runs, which happens
+// after each batch of commands (so that the AI still answers a player's request at once, even while paused) and once per tick.
 void post_message(sys::state& state, message const& m);
+// Answers every request queued for an AI nation, in the order they were posted, including any posted while doing so.
+void resolve_ai_messages(sys::state& state);
 void update_pending_messages(sys::state& state);
 
 }
@@ -229,6 +229,8 @@ uint8_t const* read_scenario_section(uint8_t const* ptr_in, uint8_t const* secti
 	ptr_in = deserialize(ptr_in, state.value_modifier_segments);
 	ptr_in = deserialize(ptr_in, state.value_modifiers);
 	ptr_in = deserialize(ptr_in, state.text_data);
+	state.unique_text_index.clear();
+	state.unique_text_indexed_size = 0;
 	ptr_in = deserialize(ptr_in, state.text_components);
 	ptr_in = deserialize(ptr_in, state.text_sequences);
 	ptr_in = deserialize(ptr_in, state.key_to_text_sequence);
@@ -611,7 +613,9 @@ uint8_t const* read_save_section(uint8_t const* ptr_in, uint8_t const* section_e
 	ptr_in = deserialize(ptr_in, state.pending_f_n_event);
 	ptr_in = deserialize(ptr_in, state.pending_p_event);
 	ptr_in = deserialize(ptr_in, state.pending_f_p_event);
-	ptr_in = memcpy_deserialize(ptr_in, state.pending_messages);
+	ptr_in = deserialize(ptr_in, state.pending_messages.slots);
+	state.pending_messages.rebuild_indices();
+	ptr_in = deserialize(ptr_in, state.ai_messages);
 	ptr_in = memcpy_deserialize(ptr_in, state.player_data_cache);
 
 	{ // national definitions
@@ -657,7 +661,8 @@ uint8_t* write_save_section(uint8_t* ptr_in, sys::state& state) {
 	ptr_in = serialize(ptr_in, state.pending_f_n_event);
 	ptr_in = serialize(ptr_in, state.pending_p_event);
 	ptr_in = serialize(ptr_in, state.pending_f_p_event);
-	ptr_in = memcpy_serialize(ptr_in, state.pending_messages);
+	ptr_in = serialize(ptr_in, state.pending_messages.slots);
+	ptr_in = serialize(ptr_in, state.ai_messages);
 	ptr_in = memcpy_serialize(ptr_in, state.player_data_cache);
 
 	{ // national definitions
@@ -703,7 +708,8 @@ size_t sizeof_save_section(sys::state& state) {
 	sz += serialize_size(state.pending_f_n_event);
 	sz += serialize_size(state.pending_p_event);
 	sz += serialize_size(state.pending_f_p_event);
-	sz += sizeof(state.pending_messages);
+	sz += serialize_size(state.pending_messages.slots);
+	sz += serialize_size(state.ai_messages);
 	sz += sizeof(state.player_data_cache);
 
 	{ // national definitions
@@ -178,6 +178,7 @@ namespace sys {
 		if(ui_state.last_tooltip != mouse_probe.under_mouse) {
 			ui_state.last_tooltip = mouse_probe.under_mouse;
 			if(mouse_probe.under_mouse) {
+				mouse_probe.under_mouse->on_hover(*this);
 				auto type = ui_state.last_tooltip->has_tooltip(*this);
 				if(type != ui::tooltip_behavior::no_tooltip) {
 
@@ -231,6 +232,8 @@ namespace sys {
 			}
 		}
 
+		ogl::process_texture_uploads(*this);
+
 		glClearColor(0.5, 0.5, 0.5, 1.0);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 		if(bg_gfx_id) {
@@ -272,10 +275,10 @@ namespace sys {
 
 		if(map_state.get_zoom() > 5) {
 			if(map_state.active_map_mode == map_mode::mode::rgo_output) {
-				ui_state.rgos_root->impl_on_update(*this);
+				static_cast<ui::map_icon_layer_base*>(ui_state.rgos_root.get())->update_icons(*this);
 				ui_state.rgos_root->impl_render(*this, 0, 0);
 			} else {
-				ui_state.units_root->impl_on_update(*this);
+				static_cast<ui::map_icon_layer_base*>(ui_state.units_root.get())->update_icons(*this);
 				ui_state.units_root->impl_render(*this, 0, 0);
 			}
 		}
@@ -312,16 +315,8 @@ namespace sys {
 		// Find the object id for the main_bg displayed (so we display it before the map)
 		bg_gfx_id = ui_defs.gui[ui_state.defs_by_name.find("bg_main_menus")->second.definition].data.image.gfx_object;
 
-		world.for_each_province([&](dcon::province_id id) {
-			auto ptr = ui::make_element_by_type<ui::unit_icon_window>(*this, "unit_mapicon");
-			static_cast<ui::unit_icon_window*>(ptr.get())->content = id;
-			ui_state.units_root->add_child_to_front(std::move(ptr));
-		});
-		world.for_each_province([&](dcon::province_id id) {
-			auto ptr = ui::make_element_by_type<ui::rgo_icon>(*this, "alice_rgo_mapicon");
-			static_cast<ui::rgo_icon*>(ptr.get())->content = id;
-			ui_state.rgos_root->add_child_to_front(std::move(ptr));
-		});
+		ui_state.units_root = std::make_unique<ui::map_icon_layer<ui::unit_icon_window>>("unit_mapicon");
+		ui_state.rgos_root = std::make_unique<ui::map_icon_layer<ui::rgo_icon>>("alice_rgo_mapicon");
 
         {
             auto window = ui::make_element_by_type<ui::console_window>(*this, "console_wnd");
@@ -451,16 +446,34 @@ namespace sys {
 	}
 
 	dcon::text_key state::add_unique_to_pool(std::string const& new_text) {
-		if(new_text.length() > 0) {
-			auto search_result = std::search(text_data.data(), text_data.data() + text_data.size(), std::boyer_moore_horspool_searcher(new_text.c_str(), new_text.c_str() + new_text.length() + 1));
-			if(search_result != text_data.data() + text_data.size()) {
-				return dcon::text_key(uint32_t(search_result - text_data.data()));
-			} else {
-				return add_to_pool(new_text);
-			}
-		} else {
+		if(new_text.length() == 0)
 			return dcon::text_key();
+
+		if(unique_text_indexed_size > text_data.size()) { // the pool was replaced, e.g. by loading a scenario
+			unique_text_index.clear();
+			unique_text_indexed_size = 0;
+		}
+		// index every string that has been added since the last call
+		auto pos = unique_text_indexed_size;
+		while(pos < text_data.size()) {
+			auto end = pos;
+			while(end < text_data.size() && text_data[end] != 0)
+				++end;
+			if(end == text_data.size())
+				break;
+			if(end != pos)
+				unique_text_index.insert(dcon::text_key(uint32_t(pos)));
+			pos = end + 1;
 		}
+		unique_text_indexed_size = pos;
+
+		if(auto it = unique_text_index.find(std::string_view(new_text)); it != unique_text_index.end())
+			return *it;
+
+		auto new_key = add_to_pool(new_text);
+		unique_text_index.insert(new_key);
+		unique_text_indexed_size = text_data.size();
+		return new_key;
 	}
 
 	dcon::unit_name_id state::add_unit_name(std::string_view text) {
@@ -1618,6 +1631,7 @@ namespace sys {
 
 		culture::update_all_nations_issue_rules(*this);
 		culture::restore_unsaved_values(*this);
+		politics::restore_unsaved_values(*this);
 		nations::restore_state_instances(*this);
 		demographics::regenerate_from_pop_data(*this);
 
@@ -1626,6 +1640,7 @@ namespace sys {
 		nations::restore_unsaved_values(*this);
 
 		pop_demographics::regenerate_is_primary_or_accepted(*this);
+		military::update_pop_regiment_capacity(*this); // depends on is_primary_or_accepted
 
 		rebel::update_movement_values(*this);
 
@@ -1712,115 +1727,98 @@ namespace sys {
 					auto const days_in_month = uint32_t(sys::days_difference(month_start, next_month_start));
 
 					// pop update:
+#ifdef ALICE_PACKED_POP_DEMOGRAPHICS
+					static demographics::packed_attraction_buffer idbuf;
+					static demographics::packed_attraction_buffer isbuf;
+#else
 					static demographics::ideology_buffer idbuf(*this);
 					static demographics::issues_buffer isbuf(*this);
+#endif
 					static demographics::promotion_buffer pbuf;
 					static demographics::assimilation_buffer abuf;
 					static demographics::migration_buffer mbuf;
 					static demographics::migration_buffer cmbuf;
 					static demographics::migration_buffer imbuf;
+					static demographics::pop_index pindex;
+
+					static demographics::pop_update_scheduler schedule;
+					schedule.configure(defines);
+					auto run = [&](demographics::pop_update u, auto&& f) {
+						schedule.run(u, [&]() {
+							f(schedule.offset(u, current_date, ymd_date.day, days_in_month), schedule.divisions(u, days_in_month));
+						});
+					};
 
 					// calculate complex changes in parallel where we can, but don't actually apply the results
 					// instead, the changes are saved to be applied only after all triggers have been evaluated
+					// the most expensive updates (as measured on previous days) are started first
+					std::array<demographics::pop_update, 7> updates = {
+						demographics::pop_update::ideologies, demographics::pop_update::issues, demographics::pop_update::type_changes,
+						demographics::pop_update::assimilation, demographics::pop_update::internal_migration,
+						demographics::pop_update::colonial_migration, demographics::pop_update::immigration };
+					schedule.order_by_cost(updates.data(), updates.data() + updates.size());
 					concurrency::parallel_for(0, 7, [&](int32_t index) {
-						switch(index) {
-							case 0:
-							{
-								auto o = uint32_t(ymd_date.day);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_ideologies(*this, o, days_in_month, idbuf);
+						switch(updates[index]) {
+							case demographics::pop_update::ideologies:
+								run(updates[index], [&](uint32_t o, uint32_t d) { demographics::update_ideologies(*this, o, d, idbuf); });
 								break;
-							}
-							case 1:
-							{
-								auto o = uint32_t(ymd_date.day + 1);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_issues(*this, o, days_in_month, isbuf);
+							case demographics::pop_update::issues:
+								run(updates[index], [&](uint32_t o, uint32_t d) { demographics::update_issues(*this, o, d, isbuf); });
 								break;
-							}
-							case 2:
-							{
-								auto o = uint32_t(ymd_date.day + 6);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_type_changes(*this, o, days_in_month, pbuf);
+							case demographics::pop_update::type_changes:
+								run(updates[index], [&](uint32_t o, uint32_t d) { demographics::update_type_changes(*this, o, d, pbuf); });
 								break;
-							}
-							case 3:
-							{
-								auto o = uint32_t(ymd_date.day + 7);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_assimilation(*this, o, days_in_month, abuf);
+							case demographics::pop_update::assimilation:
+								run(updates[index], [&](uint32_t o, uint32_t d) { demographics::update_assimilation(*this, o, d, abuf); });
 								break;
-							}
-							case 4:
-							{
-								auto o = uint32_t(ymd_date.day + 8);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_internal_migration(*this, o, days_in_month, mbuf);
+							case demographics::pop_update::internal_migration:
+								run(updates[index], [&](uint32_t o, uint32_t d) { demographics::update_internal_migration(*this, o, d, mbuf); });
 								break;
-							}
-							case 5:
-							{
-								auto o = uint32_t(ymd_date.day + 9);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_colonial_migration(*this, o, days_in_month, cmbuf);
+							case demographics::pop_update::colonial_migration:
+								run(updates[index], [&](uint32_t o, uint32_t d) { demographics::update_colonial_migration(*this, o, d, cmbuf); });
 								break;
-							}
-							case 6:
-							{
-								auto o = uint32_t(ymd_date.day + 10);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_immigration(*this, o, days_in_month, imbuf);
+							case demographics::pop_update::immigration:
+								run(updates[index], [&](uint32_t o, uint32_t d) { demographics::update_immigration(*this, o, d, imbuf); });
+								break;
+							default:
 								break;
-							}
 						}
 					});
 
 					// apply in parallel where we can
-					concurrency::parallel_for(0, 8, [&](int32_t index) {
-						switch(index) {
-							case 0:
-							{
-								auto o = uint32_t(ymd_date.day + 0);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::apply_ideologies(*this, o, days_in_month, idbuf);
-								break;
-							}
-							case 1:
-							{
-								auto o = uint32_t(ymd_date.day + 1);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::apply_issues(*this, o, days_in_month, isbuf);
-								break;
-							}
-							case 2:
-							{
-								auto o = uint32_t(ymd_date.day + 2);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_militancy(*this, o, days_in_month);
-								break;
-							}
-							case 3:
-							{
-								auto o = uint32_t(ymd_date.day + 3);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_consciousness(*this, o, days_in_month);
-								break;
-							}
-							case 4:
-							{
-								auto o = uint32_t(ymd_date.day + 4);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_literacy(*this, o, days_in_month);
-								break;
-							}
-							case 5:
-							{
-								auto o = uint32_t(ymd_date.day + 5);
-								if(o >= days_in_month) o -= days_in_month;
-								demographics::update_growth(*this, o, days_in_month);
-								break;
+					std::array<demographics::pop_update, 6> applies = {
+						demographics::pop_update::ideologies, demographics::pop_update::issues, demographics::pop_update::militancy,
+						demographics::pop_update::consciousness, demographics::pop_update::literacy, demographics::pop_update::growth };
+					schedule.order_by_cost(applies.data(), applies.data() + applies.size());
+					concurrency::parallel_for(0, 9, [&](int32_t index) {
+						if(index < 6) {
+							switch(applies[index]) {
+								case demographics::pop_update::ideologies:
+									demographics::apply_ideologies(*this, schedule.offset(applies[index], current_date, ymd_date.day, days_in_month),
+										schedule.divisions(applies[index], days_in_month), idbuf);
+									break;
+								case demographics::pop_update::issues:
+									demographics::apply_issues(*this, schedule.offset(applies[index], current_date, ymd_date.day, days_in_month),
+										schedule.divisions(applies[index], days_in_month), isbuf);
+									break;
+								case demographics::pop_update::militancy:
+									run(applies[index], [&](uint32_t o, uint32_t d) { demographics::update_militancy(*this, o, d); });
+									break;
+								case demographics::pop_update::consciousness:
+									run(applies[index], [&](uint32_t o, uint32_t d) { demographics::update_consciousness(*this, o, d); });
+									break;
+								case demographics::pop_update::literacy:
+									run(applies[index], [&](uint32_t o, uint32_t d) { demographics::update_literacy(*this, o, d); });
+									break;
+								case demographics::pop_update::growth:
+									run(applies[index], [&](uint32_t o, uint32_t d) { demographics::update_growth(*this, o, d); });
+									break;
+								default:
+									break;
 							}
+							return;
+						}
+						switch(index) {
 							case 6:
 								province::ve_for_each_land_province(*this, [&](auto ids) {
 									world.province_set_daily_net_migration(ids, ve::fp_vector{});
@@ -1831,40 +1829,40 @@ namespace sys {
 									world.province_set_daily_net_immigration(ids, ve::fp_vector{});
 								});
 								break;
+							case 8:
+								pindex.rebuild(*this);
+								break;
 						}
 					});
 
 					// because they may add pops, these changes must be applied sequentially
 					{
-						auto o = uint32_t(ymd_date.day + 6);
-						if(o >= days_in_month) o -= days_in_month;
-						demographics::apply_type_changes(*this, o, days_in_month, pbuf);
+						auto u = demographics::pop_update::type_changes;
+						demographics::apply_type_changes(*this, schedule.offset(u, current_date, ymd_date.day, days_in_month), schedule.divisions(u, days_in_month), pbuf, pindex);
 					}
 					{
-						auto o = uint32_t(ymd_date.day + 7);
-						if(o >= days_in_month) o -= days_in_month;
-						demographics::apply_assimilation(*this, o, days_in_month, abuf);
+						auto u = demographics::pop_update::assimilation;
+						demographics::apply_assimilation(*this, schedule.offset(u, current_date, ymd_date.day, days_in_month), schedule.divisions(u, days_in_month), abuf, pindex);
 					}
 					{
-						auto o = uint32_t(ymd_date.day + 8);
-						if(o >= days_in_month) o -= days_in_month;
-						demographics::apply_internal_migration(*this, o, days_in_month, mbuf);
+						auto u = demographics::pop_update::internal_migration;
+						demographics::apply_internal_migration(*this, schedule.offset(u, current_date, ymd_date.day, days_in_month), schedule.divisions(u, days_in_month), mbuf, pindex);
 					}
 					{
-						auto o = uint32_t(ymd_date.day + 9);
-						if(o >= days_in_month) o -= days_in_month;
-						demographics::apply_colonial_migration(*this, o, days_in_month, cmbuf);
+						auto u = demographics::pop_update::colonial_migration;
+						demographics::apply_colonial_migration(*this, schedule.offset(u, current_date, ymd_date.day, days_in_month), schedule.divisions(u, days_in_month), cmbuf, pindex);
 					}
 					{
-						auto o = uint32_t(ymd_date.day + 10);
-						if(o >= days_in_month) o -= days_in_month;
-						demographics::apply_immigration(*this, o, days_in_month, imbuf);
+						auto u = demographics::pop_update::immigration;
+						demographics::apply_immigration(*this, schedule.offset(u, current_date, ymd_date.day, days_in_month), schedule.divisions(u, days_in_month), imbuf, pindex);
 					}
 
 					demographics::remove_size_zero_pops(*this);
+					pindex.invalidate();
 
 					// basic repopulation of demographics derived values
 					demographics::regenerate_from_pop_data(*this);
+					military::update_pop_regiment_capacity(*this); // depends on pop sizes
 
 					// values updates pass 1 (mostly trivial things, can be done in parallel
 					concurrency::parallel_for(0, 12, [&](int32_t index) {
@@ -1924,6 +1922,7 @@ namespace sys {
 					military::update_cbs(*this); // may add/remove cbs to a nation
 
 					nations::update_crisis(*this);
+					diplomatic_message::resolve_ai_messages(*this); // requests to ai nations posted since the last tick, including by the crisis
 					politics::update_elections(*this);
 
 					// Once per month updates, spread out over the month
@@ -1965,9 +1964,9 @@ namespace sys {
 
 					// yearly update : redo the upper house
 					if(ymd_date.day == 1 && ymd_date.month == 1) {
-						for(auto n : world.in_nation) {
-							politics::recalculate_upper_house(*this, n);
-						}
+						concurrency::parallel_for(uint32_t(0), world.nation_size(), [&](uint32_t i) {
+							politics::recalculate_upper_house(*this, dcon::nation_id{ dcon::nation_id::value_base_t(i) });
+						});
 					}
 
 					/*
@@ -10,6 +10,7 @@
 #include "gui_graphics.hpp"
 #include "simple_fs.hpp"
 #include "text.hpp"
+#include "search_index.hpp"
 #include "opengl_wrapper.hpp"
 #include "fonts.hpp"
 #include "sound.hpp"
@@ -34,6 +35,9 @@
 namespace window {
 	class window_data_impl;
 }
+namespace politics {
+	struct support_matrix;
+}
 
 namespace sys {
 
@@ -125,6 +129,8 @@ namespace sys {
 		std::vector<text::text_component> text_components;
 		tagged_vector<text::text_sequence, dcon::text_sequence_id> text_sequences;
 		ankerl::unordered_dense::map<dcon::text_key, dcon::text_sequence_id, text::vector_backed_hash, text::vector_backed_eq> key_to_text_sequence;
+		ankerl::unordered_dense::set<dcon::text_key, text::vector_backed_hash, text::vector_backed_eq> unique_text_index; // not saved, filled lazily by add_unique_to_pool
+		size_t unique_text_indexed_size = 0;
 
 		bool adjacency_data_out_of_date = true;
 		bool national_cached_values_out_of_date = false;
@@ -134,6 +140,8 @@ namespace sys {
 		std::vector<dcon::nation_id> nations_by_military_score;
 		std::vector<dcon::nation_id> nations_by_prestige_score;
 		std::vector<great_nation> great_nations;
+		culture::invention_candidate_sets invention_candidates; // not saved, see culture::discover_inventions
+		std::unique_ptr<politics::support_matrix> ideology_support; // not saved, see politics::restore_unsaved_values
 
 		//
 		// Crisis data
@@ -156,7 +164,8 @@ namespace sys {
 		// Messages
 		//
 
-		std::array<diplomatic_message::message, 128> pending_messages = {};
+		diplomatic_message::pending_message_queue pending_messages; // waiting on a player's answer
+		std::vector<diplomatic_message::message> ai_messages; // waiting on diplomatic_message::resolve_ai_messages
 
 		//
 		// Event data
@@ -196,6 +205,7 @@ namespace sys {
 		std::unique_ptr<sound::sound_impl> sound_ptr = nullptr; // platform-dependent sound information
 		ui::state ui_state; // transient information for the state of the ui
 		text::font_manager font_collection;
+		text::search_indices search_data; // filled on first use, see text::get_search_indices
 
 		// synchronization data (between main update logic and ui thread)
 		std::atomic<bool> game_state_updated = false; // game state -> ui signal
@@ -261,8 +271,7 @@ namespace sys {
 		dcon::text_key add_to_pool_lowercase(std::string_view text);
 
 		// searches the string pool for any existing string, appends if it is new
-		// use this function sparingly; i.e. only when you think it is likely that
-		// the text has already been added. Searching *all* the text may not be cheap
+		// the first call after other text has been added indexes that text, so the lookup itself is a hash probe
 		dcon::text_key add_unique_to_pool(std::string const& text);
 
 		dcon::unit_name_id add_unit_name(std::string_view text); // returns the newly added text
@@ -271,7 +280,7 @@ namespace sys {
 		dcon::trigger_key commit_trigger_data(std::vector<uint16_t> data);
 		dcon::effect_key commit_effect_data(std::vector<uint16_t> data);
 
-		state() : key_to_text_sequence(0, text::vector_backed_hash(text_data), text::vector_backed_eq(text_data)), incoming_commands(1024), new_n_event(1024), new_f_n_event(1024), new_p_event(1024), new_f_p_event(1024), new_requests(256) {}
+		state() : key_to_text_sequence(0, text::vector_backed_hash(text_data), text::vector_backed_eq(text_data)), unique_text_index(0, text::vector_backed_hash(text_data), text::vector_backed_eq(text_data)), incoming_commands(1024), new_n_event(1024), new_f_n_event(1024), new_p_event(1024), new_f_p_event(1024), new_requests(256) {}
 
 		~state();
 
@@ -138,15 +138,14 @@ static uint32_t levenshtein_tokenized_distance(std::string_view needle, std::str
 }
 
 static bool set_active_tag(sys::state& state, std::string_view tag) noexcept {
+	static std::vector<uint32_t> matches;
+	text::get_search_indices(state).tags.find_exact(tag, matches);
 	bool found = false;
-	state.world.for_each_national_identity([&](dcon::national_identity_id id) {
-		auto curr = nations::int_to_tag(state.world.national_identity_get_identifying_int(id));
-		if(curr == tag) {
-			dcon::national_identity_fat_id fat_id = dcon::fatten(state.world, id);
-			state.local_player_nation = fat_id.get_nation_from_identity_holder().id;
-			found = true;
-		}
-	});
+	for(auto v : matches) {
+		dcon::national_identity_fat_id fat_id = dcon::fatten(state.world, dcon::national_identity_id{ dcon::national_identity_id::value_base_t(v) });
+		state.local_player_nation = fat_id.get_nation_from_identity_holder().id;
+		found = true;
+	}
 	return found;
 }
 
@@ -301,17 +300,17 @@ void ui::console_edit::edit_box_update(sys::state& state, std::string_view s) no
 			// Tag will autofill a country name + indicate it's full name
 			std::pair<uint32_t, dcon::national_identity_id> closest_match{};
 			closest_match.first = std::numeric_limits<uint32_t>::max();
-			state.world.for_each_national_identity([&](dcon::national_identity_id id) {
-				dcon::national_identity_fat_id fat_id = dcon::fatten(state.world, id);
+			static std::vector<uint32_t> matches;
+			text::get_search_indices(state).tags.find_prefix(tag, matches);
+			for(auto v : matches) {
+				dcon::national_identity_id id{ dcon::national_identity_id::value_base_t(v) };
 				std::string name = nations::int_to_tag(state.world.national_identity_get_identifying_int(id));
-				if(name.starts_with(tag)) {
-					uint32_t dist = levenshtein_distance(tag, name);
-					if(dist < closest_match.first) {
-						closest_match.first = dist;
-						closest_match.second = id;
-					}
+				uint32_t dist = levenshtein_distance(tag, name);
+				if(dist < closest_match.first) {
+					closest_match.first = dist;
+					closest_match.second = id;
 				}
-			});
+			}
 			// Now type in a suggestion...
 			dcon::nation_id nid = state.world.identity_holder_get_nation(state.world.national_identity_get_identity_holder(closest_match.second));
 			std::string name = nations::int_to_tag(state.world.national_identity_get_identifying_int(closest_match.second));
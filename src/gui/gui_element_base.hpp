@@ -53,6 +53,7 @@ public:
 		return tooltip_behavior::no_tooltip;
 	}
 	virtual void update_tooltip(sys::state& state, int32_t x, int32_t y, text::columnar_layout& contents) noexcept { }
+	virtual void on_hover(sys::state& state) noexcept { } // called once when the mouse moves onto the element
 
 	// these message handlers can be overridden by basically anyone
 	//        - generally *should not* be called directly
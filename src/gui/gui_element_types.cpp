@@ -193,6 +193,16 @@ void image_element_base::render(sys::state& state, int32_t x, int32_t y) noexcep
 					base_data.get_rotation(),
 					gfx_def.is_vertically_flipped()
 				);
+			} else if(auto region = gfx_def.is_partially_transparent() ? nullptr : ogl::get_atlas_region(state, gfx_def.primary_texture_handle); region) {
+				// textures kept for transparency checks need their own pixel data, so only opaque ones come from the atlas
+				ogl::render_atlas_rect(
+					state,
+					get_color_modification(this == state.ui_state.under_mouse, disabled, interactable),
+					float(x), float(y), float(base_data.size.x), float(base_data.size.y),
+					*region,
+					base_data.get_rotation(),
+					gfx_def.is_vertically_flipped()
+				);
 			} else {
 				ogl::render_textured_rect(
 					state,
@@ -632,10 +642,11 @@ void make_size_from_graphics(sys::state& state, ui::element_data& dat) {
 				dat.size = state.ui_defs.gfx[gfx_handle].size;
 			} else {
 				auto tex_handle = state.ui_defs.gfx[gfx_handle].primary_texture_handle;
-				if(tex_handle) {
-					ogl::get_texture_handle(state, tex_handle, state.ui_defs.gfx[gfx_handle].is_partially_transparent());
-					dat.size.y = int16_t(state.open_gl.asset_textures[tex_handle].size_y);
-					dat.size.x = int16_t(state.open_gl.asset_textures[tex_handle].size_x / state.ui_defs.gfx[gfx_handle].number_of_frames);
+				int32_t size_x = 0;
+				int32_t size_y = 0;
+				if(tex_handle && ogl::get_texture_size(state, tex_handle, size_x, size_y)) {
+					dat.size.y = int16_t(size_y);
+					dat.size.x = int16_t(size_x / state.ui_defs.gfx[gfx_handle].number_of_frames);
 				}
 			}
 			if(scale != 1.0f) {
@@ -1221,7 +1232,8 @@ void flag_button::set_current_nation(sys::state& state, dcon::national_identity_
 		} else {
 			flag_type = culture::get_current_flag_type(state, identity);
 		}
-		flag_texture_handle = ogl::get_flag_handle(state, identity, flag_type);
+		flag_identity = identity;
+		current_flag_type = flag_type;
 	}
 }
 
@@ -1241,21 +1253,45 @@ void flag_button::render(sys::state& state, int32_t x, int32_t y) noexcept {
 	} else if(base_data.get_element_type() == element_type::button) {
 		gid = base_data.data.button.button_image;
 	}
-	if(gid && flag_texture_handle > 0) {
+	if(gid && flag_identity) {
 		auto& gfx_def = state.ui_defs.gfx[gid];
+		// the handle is looked up every frame (which is cheap once loaded) since the flag may still be streaming in
+		auto region = ogl::get_flag_atlas_region(state, flag_identity, current_flag_type);
+		GLuint flag_texture_handle = region ? 0 : ogl::get_flag_handle(state, flag_identity, current_flag_type);
 		if(gfx_def.type_dependent) {
 			auto mask_handle = ogl::get_texture_handle(state, dcon::texture_id(gfx_def.type_dependent - 1), true);
 			auto& mask_tex = state.open_gl.asset_textures[dcon::texture_id(gfx_def.type_dependent - 1)];
-			ogl::render_masked_rect(
+			if(region) {
+				ogl::render_masked_atlas_rect(
+					state,
+					get_color_modification(this == state.ui_state.under_mouse, disabled, interactable),
+					float(x) + float(base_data.size.x - mask_tex.size_x) * 0.5f, float(y) + float(base_data.size.y - mask_tex.size_y) * 0.5f, float(mask_tex.size_x), float(mask_tex.size_y),
+					*region,
+					mask_handle,
+					base_data.get_rotation(),
+					gfx_def.is_vertically_flipped()
+				);
+			} else if(flag_texture_handle > 0) {
+				ogl::render_masked_rect(
+					state,
+					get_color_modification(this == state.ui_state.under_mouse, disabled, interactable),
+					float(x) + float(base_data.size.x - mask_tex.size_x) * 0.5f, float(y) + float(base_data.size.y - mask_tex.size_y) * 0.5f, float(mask_tex.size_x), float(mask_tex.size_y),
+					flag_texture_handle,
+					mask_handle,
+					base_data.get_rotation(),
+					gfx_def.is_vertically_flipped()
+				);
+			}
+		} else if(region) {
+			ogl::render_atlas_rect(
 				state,
 				get_color_modification(this == state.ui_state.under_mouse, disabled, interactable),
-				float(x) + float(base_data.size.x - mask_tex.size_x) * 0.5f, float(y) + float(base_data.size.y - mask_tex.size_y) * 0.5f, float(mask_tex.size_x), float(mask_tex.size_y),
-				flag_texture_handle,
-				mask_handle,
+				float(x), float(y), float(base_data.size.x), float(base_data.size.y),
+				*region,
 				base_data.get_rotation(),
 				gfx_def.is_vertically_flipped()
 			);
-		} else {
+		} else if(flag_texture_handle > 0) {
 			ogl::render_textured_rect(
 				state,
 				get_color_modification(this == state.ui_state.under_mouse, disabled, interactable),
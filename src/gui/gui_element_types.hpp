@@ -296,7 +296,8 @@ public:
 
 class flag_button : public button_element_base {
 protected:
-	GLuint flag_texture_handle = 0;
+	dcon::national_identity_id flag_identity;
+	culture::flag_type current_flag_type = culture::flag_type{};
 
 public:
 	virtual dcon::national_identity_id get_current_nation(sys::state& state) noexcept;
@@ -6,6 +6,7 @@
 #include "province.hpp"
 #include "text.hpp"
 #include <algorithm>
+#include <cmath>
 #include <variant>
 
 namespace ui {
@@ -53,18 +54,134 @@ template<typename T>
 class map_element_base : public T {
 public:
     dcon::province_id content{};
-	void render(sys::state& state, int32_t x, int32_t y) noexcept override {
-		auto mid_point = state.world.province_get_mid_point(content);
-		auto map_pos = state.map_state.normalize_map_coord(mid_point);
+
+	// where the province's mid point falls within the element
+	virtual xy_pair anchor_offset() noexcept {
+		return xy_pair{ int16_t(T::base_data.size.x / 2), int16_t(T::base_data.size.y / 2) };
+	}
+	// whether there is anything to show for the province; provinces without are skipped by the layer
+	virtual bool has_content(sys::state& state, dcon::province_id p) noexcept {
+		return true;
+	}
+};
+
+// Buckets the provinces by the cell of a coarse grid over the (normalized) map that their mid point falls into
+class map_icon_grid {
+public:
+	static constexpr int32_t cells_x = 64;
+	static constexpr int32_t cells_y = 32;
+
+	std::vector<uint32_t> cell_start; // provinces of cell c are [cell_start[c], cell_start[c + 1])
+	std::vector<dcon::province_id> provinces;
+
+	bool empty() const {
+		return cell_start.empty();
+	}
+	void build(sys::state& state) {
+		auto cell_of = [&](dcon::province_id p) {
+			auto map_pos = state.map_state.normalize_map_coord(state.world.province_get_mid_point(p));
+			auto cx = std::clamp(int32_t(map_pos.x * cells_x), 0, cells_x - 1);
+			auto cy = std::clamp(int32_t(map_pos.y * cells_y), 0, cells_y - 1);
+			return uint32_t(cy * cells_x + cx);
+		};
+		cell_start.assign(cells_x * cells_y + 1, 0);
+		state.world.for_each_province([&](dcon::province_id p) {
+			++cell_start[cell_of(p) + 1];
+		});
+		for(size_t i = 1; i < cell_start.size(); ++i)
+			cell_start[i] += cell_start[i - 1];
+		provinces.resize(cell_start.back());
+		std::vector<uint32_t> cursor(cell_start.begin(), cell_start.end() - 1);
+		state.world.for_each_province([&](dcon::province_id p) {
+			provinces[cursor[cell_of(p)]++] = p;
+		});
+	}
+	// visits the provinces in every cell overlapping the region; the map wraps around horizontally
+	template<typename F>
+	void for_each_in(glm::vec2 top_left, glm::vec2 bottom_right, F&& f) const {
+		auto y_first = std::clamp(int32_t(std::floor(top_left.y * cells_y)), 0, cells_y - 1);
+		auto y_last = std::clamp(int32_t(std::floor(bottom_right.y * cells_y)), 0, cells_y - 1);
+		auto x_first = int32_t(std::floor(top_left.x * cells_x));
+		auto x_last = std::min(int32_t(std::floor(bottom_right.x * cells_x)), x_first + cells_x - 1);
+		for(int32_t y = y_first; y <= y_last; ++y) {
+			for(int32_t x = x_first; x <= x_last; ++x) {
+				auto c = uint32_t(y * cells_x + ((x % cells_x) + cells_x) % cells_x);
+				for(uint32_t i = cell_start[c]; i < cell_start[c + 1]; ++i)
+					f(provinces[i]);
+			}
+		}
+	}
+};
+
+class map_icon_layer_base : public container_base {
+public:
+	// rebinds the layer's elements to the provinces that have an icon on screen
+	virtual void update_icons(sys::state& state) noexcept = 0;
+};
+
+/*
+Rather than one element per province, the layer keeps a pool of elements that grows to the largest number of icons that have
+been on screen at once. Each frame the provinces near the visible part of the map are found through the grid, and those with
+something to show are bound to the pooled elements; the rest of the pool is hidden. Since only bound elements are visible,
+updating, rendering and mouse probing the layer only touches the icons on screen.
+*/
+template<typename T>
+class map_icon_layer : public map_icon_layer_base {
+	std::string_view definition_name;
+	map_icon_grid grid;
+	std::unique_ptr<element_base> prototype;
+public:
+	map_icon_layer(std::string_view definition_name) : definition_name(definition_name) { }
+
+	void update_icons(sys::state& state) noexcept override {
+		if(!prototype) {
+			prototype = make_element_by_type<T>(state, definition_name);
+			if(!prototype)
+				return;
+		}
+		if(grid.empty())
+			grid.build(state);
+
+		auto& proto = static_cast<T&>(*prototype);
 		auto screen_size = glm::vec2{ float(state.x_size / state.user_settings.ui_scale), float(state.y_size / state.user_settings.ui_scale) };
-		glm::vec2 screen_pos;
-		if(!state.map_state.map_to_screen(state, map_pos, screen_size, screen_pos))
-			return;
-        auto new_position = xy_pair{ int16_t(screen_pos.x - T::base_data.size.x / 2), int16_t(screen_pos.y - T::base_data.size.y / 2) };
-		auto xdiff = (T::base_data.position.x - new_position.x);
-		auto ydiff = (T::base_data.position.y - new_position.y);
-		T::base_data.position = new_position;
-		T::render(state, x - xdiff, y - ydiff);
+		auto margin = glm::vec2{ float(proto.base_data.size.x), float(proto.base_data.size.y) };
+
+		uint32_t used = 0;
+		auto place = [&](dcon::province_id p) {
+			if(!proto.has_content(state, p))
+				return;
+			glm::vec2 screen_pos;
+			if(!state.map_state.map_to_screen(state, state.map_state.normalize_map_coord(state.world.province_get_mid_point(p)), screen_size, screen_pos))
+				return;
+			if(screen_pos.x < -margin.x || screen_pos.y < -margin.y || screen_pos.x > screen_size.x + margin.x || screen_pos.y > screen_size.y + margin.y)
+				return;
+
+			if(used == children.size()) {
+				auto ptr = make_element_by_type<T>(state, definition_name);
+				add_child_to_back(std::move(ptr));
+			}
+			auto& e = static_cast<T&>(*children[used]);
+			++used;
+			e.content = p;
+			auto offset = e.anchor_offset();
+			e.base_data.position = xy_pair{ int16_t(screen_pos.x - offset.x), int16_t(screen_pos.y - offset.y) };
+			e.flags = uint8_t(e.flags & ~element_base::is_invisible_mask);
+		};
+
+		glm::vec2 top_left;
+		glm::vec2 bottom_right;
+		if(state.map_state.visible_map_region(state, screen_size, margin, top_left, bottom_right)) {
+			grid.for_each_in(top_left, bottom_right, place);
+		} else {
+			// on the globe, every province may be visible; map_to_screen rejects the far side
+			for(auto p : grid.provinces)
+				place(p);
+		}
+		for(uint32_t i = used; i < children.size(); ++i) {
+			children[i]->flags = uint8_t(children[i]->flags | element_base::is_invisible_mask);
+		}
+
+		impl_on_update(state);
 	}
 };
 
@@ -136,18 +253,13 @@ public:
         set_visible(state, has_any);
     }
 
-	void render(sys::state& state, int32_t x, int32_t y) noexcept override {
-		auto mid_point = state.world.province_get_mid_point(content);
-		auto map_pos = state.map_state.normalize_map_coord(mid_point);
-		auto screen_size = glm::vec2{ float(state.x_size / state.user_settings.ui_scale), float(state.y_size / state.user_settings.ui_scale) };
-		glm::vec2 screen_pos;
-		if(!state.map_state.map_to_screen(state, map_pos, screen_size, screen_pos))
-			return;
-		auto new_position = xy_pair{ int16_t(screen_pos.x - 25), int16_t(screen_pos.y - 40) };
-		auto xdiff = (base_data.position.x - new_position.x);
-		auto ydiff = (base_data.position.y - new_position.y);
-		base_data.position = new_position;
-		window_element_base::render(state, x - xdiff, y - ydiff);
+	xy_pair anchor_offset() noexcept override {
+		return xy_pair{ 25, 40 };
+	}
+	bool has_content(sys::state& state, dcon::province_id p) noexcept override {
+		auto armies = state.world.province_get_army_location_as_location(p);
+		auto navies = state.world.province_get_navy_location_as_location(p);
+		return armies.begin() != armies.end() || navies.begin() != navies.end();
 	}
 
     message_result get(sys::state& state, Cyto::Any& payload) noexcept override {
@@ -191,6 +303,9 @@ public:
 
 class rgo_icon : public map_element_base<image_element_base> {
 public:
+	bool has_content(sys::state& state, dcon::province_id p) noexcept override {
+		return bool(state.world.province_get_rgo(p));
+	}
     void on_update(sys::state& state) noexcept override {
         auto cid = state.world.province_get_rgo(content).id;
 	    frame = int32_t(state.world.commodity_get_icon(cid));
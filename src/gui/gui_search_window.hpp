@@ -47,16 +47,30 @@ private:
 
     std::vector<dcon::province_id> search_provinces(sys::state& state, std::string_view search_term) noexcept {
         std::vector<dcon::province_id> results{};
-        std::string search_term_lower = parsers::lowercase_str(search_term);
 
         if(!search_term.empty()) {
-            state.world.for_each_province([&](dcon::province_id prov_id){
-                dcon::province_fat_id fat_id = dcon::fatten(state.world, prov_id);
-                auto name = parsers::lowercase_str(text::produce_simple_string(state, fat_id.get_name()));
-                if(name.starts_with(search_term_lower)) {
-                    results.push_back(prov_id);
+            auto& indices = text::get_search_indices(state);
+            std::vector<uint32_t> matches;
+            indices.provinces.find_prefix(search_term, matches);
+            for(auto v : matches) {
+                results.push_back(dcon::province_id{ dcon::province_id::value_base_t(v) });
+            }
+            // the name of a state finds its provinces, and the name of a nation finds its capital
+            indices.states.find_prefix(search_term, matches);
+            for(auto v : matches) {
+                for(auto m : state.world.state_definition_get_abstract_state_membership(dcon::state_definition_id{ dcon::state_definition_id::value_base_t(v) })) {
+                    results.push_back(m.get_province());
                 }
-            });
+            }
+            indices.nations.find_prefix(search_term, matches);
+            for(auto v : matches) {
+                auto holder = state.world.national_identity_get_nation_from_identity_holder(dcon::national_identity_id{ dcon::national_identity_id::value_base_t(v) });
+                if(holder && state.world.nation_get_capital(holder)) {
+                    results.push_back(state.world.nation_get_capital(holder));
+                }
+            }
+            std::sort(results.begin(), results.end());
+            results.erase(std::unique(results.begin(), results.end()), results.end());
         }
 
         return results;
@@ -853,6 +853,12 @@ public:
 		return state.ui_state.topbar_subwindow == topbar_subwindow && state.ui_state.topbar_subwindow->is_visible();
 	}
 
+	void on_hover(sys::state& state) noexcept override {
+		// start streaming in the textures of the window now, so that it doesn't hitch when it is actually opened
+		if(topbar_subwindow && !topbar_subwindow->is_visible())
+			ogl::prefetch_textures(state, topbar_subwindow->base_data);
+	}
+
 	element_base* topbar_subwindow = nullptr;
 };
 
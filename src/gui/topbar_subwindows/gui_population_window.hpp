@@ -1032,6 +1032,10 @@ public:
 
 template<typename T, bool Multiple>
 class pop_distrobution_piechart : public piechart<T> {
+	politics::party_support_table party_table;
+	std::vector<float> party_support;
+	politics::party_vote_scratch party_scratch;
+
 	float iterate_one_pop(sys::state& state, std::unordered_map<typename T::value_base_t, float>& distrib, dcon::pop_id pop_id) {
 		auto amount = 0.f;
 		const auto weight_fn = [&](auto id) {
@@ -1050,16 +1054,14 @@ class pop_distrobution_piechart : public piechart<T> {
 		} else if constexpr(std::is_same_v<T, dcon::political_party_id>) {
 			auto prov_id = state.world.pop_location_get_province(state.world.pop_get_pop_location_as_pop(pop_id));
 			if(!state.world.province_get_is_colonial(prov_id)) {
-				auto tag = state.world.nation_get_identity_from_identity_holder(state.world.province_get_nation_from_province_ownership(prov_id));
-				auto start = state.world.national_identity_get_political_party_first(tag).id.index();
-				auto end = start + state.world.national_identity_get_political_party_count(tag);
-				for(int32_t i = start; i < end; i++) {
-					auto pid = T(typename T::value_base_t(i));
-					if(politics::political_party_is_active(state, pid)) {
-						auto support = politics::party_total_support(state, pop_id, pid, state.world.province_get_nation_from_province_ownership(prov_id), prov_id);
-						distrib[typename T::value_base_t(pid.index())] += support;
-						amount += support;
-					}
+				auto owner = state.world.province_get_nation_from_province_ownership(prov_id);
+				if(party_table.nation != owner)
+					politics::make_party_support_table(state, owner, party_table);
+				party_support.assign(party_table.parties.size(), 0.0f);
+				politics::accumulate_party_support(state, party_table, pop_id, prov_id, party_support.data(), party_scratch);
+				for(uint32_t i = 0; i < uint32_t(party_table.parties.size()); ++i) {
+					distrib[typename T::value_base_t(party_table.parties[i].index())] += party_support[i];
+					amount += party_support[i];
 				}
 			}
 			return amount;
@@ -1081,6 +1083,7 @@ protected:
 	std::unordered_map<typename T::value_base_t, float> get_distribution(sys::state& state) noexcept override {
 		std::unordered_map<typename T::value_base_t, float> distrib{};
 		if(piechart<T>::parent) {
+			party_table.nation = dcon::nation_id{}; // active parties may have changed since the last update
 			auto total = 0.f;
 			if constexpr(Multiple) {
 				auto& pop_list = get_pop_window_list(state);
@@ -1181,6 +1184,10 @@ public:
 			auto& pop_list = get_pop_window_list(state);
 
 			std::unordered_map<typename T::value_base_t, float> distrib{};
+			politics::party_support_table party_table;
+			std::vector<float> party_support;
+			politics::party_vote_scratch party_scratch;
+	politics::party_vote_scratch party_scratch;
 			for(const auto pop_id : pop_list) {
 				const auto weight_fn = [&](auto id) {
 					auto weight = state.world.pop_get_demographics(pop_id, pop_demographics::to_key(state, id));
@@ -1202,16 +1209,13 @@ public:
 					auto prov_id = state.world.pop_location_get_province(state.world.pop_get_pop_location_as_pop(pop_id));
 					if(state.world.province_get_is_colonial(prov_id))
 						continue;
-					auto tag = state.world.nation_get_identity_from_identity_holder(state.world.province_get_nation_from_province_ownership(prov_id));
-					auto start = state.world.national_identity_get_political_party_first(tag).id.index();
-					auto end = start + state.world.national_identity_get_political_party_count(tag);
-					for(int32_t i = start; i < end; i++) {
-						auto pid = T(typename T::value_base_t(i));
-						if(politics::political_party_is_active(state, pid)) {
-							auto support = politics::party_total_support(state, pop_id, pid, state.world.province_get_nation_from_province_ownership(prov_id), prov_id);
-							distrib[typename T::value_base_t(pid.index())] += support;
-						}
-					}
+					auto owner = state.world.province_get_nation_from_province_ownership(prov_id);
+					if(party_table.nation != owner)
+						politics::make_party_support_table(state, owner, party_table);
+					party_support.assign(party_table.parties.size(), 0.0f);
+					politics::accumulate_party_support(state, party_table, pop_id, prov_id, party_support.data(), party_scratch);
+					for(uint32_t i = 0; i < uint32_t(party_table.parties.size()); ++i)
+						distrib[typename T::value_base_t(party_table.parties[i].index())] += party_support[i];
 				}
 			}
 
@@ -8,6 +8,7 @@
 #include "gui_graphics_parsers.cpp"
 #include "text.cpp"
 #include "fonts.cpp"
+#include "search_index.cpp"
 #include "texture.cpp"
 #include "gui_graphics.cpp"
 #include "gui_element_types.cpp"
@@ -290,50 +290,46 @@ void display_data::load_border_data(parsers::scenario_building_context& context)
             }
         }
     };
-    for (uint32_t y = 0; y < size_y - 1; y++) {
-        for (uint32_t x = 0; x < size_x - 1; x++) {
-            auto prov_id_ul = province_id_map[(x + 0) + (y + 0) * size_x];
-            auto prov_id_ur = province_id_map[(x + 1) + (y + 0) * size_x];
-            auto prov_id_dl = province_id_map[(x + 0) + (y + 1) * size_x];
-            auto prov_id_dr = province_id_map[(x + 1) + (y + 1) * size_x];
-            if (prov_id_ul != prov_id_ur || prov_id_ul != prov_id_dl || prov_id_ul != prov_id_dr) {
-                add_border(x, y, prov_id_ul, prov_id_ur, prov_id_dl, prov_id_dr);
-                if (prov_id_ul != prov_id_ur && prov_id_ur != 0 && prov_id_ul != 0) {
-                    context.state.world.try_create_province_adjacency(province::from_map_id(prov_id_ul), province::from_map_id(prov_id_ur));
-                }
-                if (prov_id_ul != prov_id_dl && prov_id_dl != 0 && prov_id_ul != 0) {
-                    context.state.world.try_create_province_adjacency(province::from_map_id(prov_id_ul), province::from_map_id(prov_id_dl));
-                }
-                if (prov_id_ul != prov_id_dr && prov_id_dr != 0 && prov_id_ul != 0) {
-                    context.state.world.try_create_province_adjacency(province::from_map_id(prov_id_ul), province::from_map_id(prov_id_dr));
-                }
-            }
-        }
-
-		{
-			// handle the international date line
-            auto prov_id_ul = province_id_map[((size_x - 1) + 0) + (y + 0) * size_x];
-            auto prov_id_ur = province_id_map[0 + (y + 0) * size_x];
-            auto prov_id_dl = province_id_map[((size_x - 1) + 0) + (y + 1) * size_x];
-            auto prov_id_dr = province_id_map[0 + (y + 1) * size_x];
-
-            if (prov_id_ul != prov_id_ur || prov_id_ul != prov_id_dl || prov_id_ul != prov_id_dr) {
-                add_border((size_x - 1), y, prov_id_ul, prov_id_ur, prov_id_dl, prov_id_dr);
-
-                if (prov_id_ul != prov_id_ur && prov_id_ur != 0 && prov_id_ul != 0) {
-                    context.state.world.try_create_province_adjacency(province::from_map_id(prov_id_ul), province::from_map_id(prov_id_ur));
-                }
-                if (prov_id_ul != prov_id_dl && prov_id_dl != 0 && prov_id_ul != 0) {
-                    context.state.world.try_create_province_adjacency(province::from_map_id(prov_id_ul), province::from_map_id(prov_id_dl));
-                }
-                if (prov_id_ul != prov_id_dr && prov_id_dr != 0 && prov_id_ul != 0) {
-                    context.state.world.try_create_province_adjacency(province::from_map_id(prov_id_ul), province::from_map_id(prov_id_dr));
-                }
-            }
+	// Finding the pixels that lie on a border is independent for every row, so that scan is done in parallel. Building
+	// the border lines has to be done in order (lines are extended from the previous row and adjacencies are created),
+	// so it then only visits the pixels found by the scan.
+	std::vector<std::vector<uint32_t>> row_border_pixels(size_y > 0 ? size_y - 1 : 0);
+	concurrency::parallel_for(uint32_t(0), uint32_t(row_border_pixels.size()), [&](uint32_t y) {
+		auto& pixels = row_border_pixels[y];
+		for(uint32_t x = 0; x < size_x; x++) {
+			auto x_right = (x + 1 < size_x) ? x + 1 : 0; // the last column wraps around the international date line
+			auto prov_id_ul = province_id_map[x + (y + 0) * size_x];
+			auto prov_id_ur = province_id_map[x_right + (y + 0) * size_x];
+			auto prov_id_dl = province_id_map[x + (y + 1) * size_x];
+			auto prov_id_dr = province_id_map[x_right + (y + 1) * size_x];
+			if(prov_id_ul != prov_id_ur || prov_id_ul != prov_id_dl || prov_id_ul != prov_id_dr) {
+				pixels.push_back(x);
+			}
+		}
+	});
+
+	for(uint32_t y = 0; y < uint32_t(row_border_pixels.size()); y++) {
+		for(auto x : row_border_pixels[y]) {
+			auto x_right = (x + 1 < size_x) ? x + 1 : 0; // handle the international date line
+			auto prov_id_ul = province_id_map[x + (y + 0) * size_x];
+			auto prov_id_ur = province_id_map[x_right + (y + 0) * size_x];
+			auto prov_id_dl = province_id_map[x + (y + 1) * size_x];
+			auto prov_id_dr = province_id_map[x_right + (y + 1) * size_x];
+
+			add_border(x, y, prov_id_ul, prov_id_ur, prov_id_dl, prov_id_dr);
+			if(prov_id_ul != prov_id_ur && prov_id_ur != 0 && prov_id_ul != 0) {
+				context.state.world.try_create_province_adjacency(province::from_map_id(prov_id_ul), province::from_map_id(prov_id_ur));
+			}
+			if(prov_id_ul != prov_id_dl && prov_id_dl != 0 && prov_id_ul != 0) {
+				context.state.world.try_create_province_adjacency(province::from_map_id(prov_id_ul), province::from_map_id(prov_id_dl));
+			}
+			if(prov_id_ul != prov_id_dr && prov_id_dr != 0 && prov_id_ul != 0) {
+				context.state.world.try_create_province_adjacency(province::from_map_id(prov_id_ul), province::from_map_id(prov_id_dr));
+			}
 		}
 		// Move the border_direction rows a step down
 		std::swap(last_row, current_row);
-        std::fill(current_row.begin(), current_row.end(), BorderDirection{});
+		std::fill(current_row.begin(), current_row.end(), BorderDirection{});
 	}
 
 	borders.resize(borders_list_vertices.size());
@@ -818,14 +814,36 @@ void display_data::load_terrain_data(parsers::scenario_building_context& context
 }
 
 void display_data::load_provinces_mid_point(parsers::scenario_building_context& context) {
-	std::vector<glm::ivec2> accumulated_tile_positions(context.state.world.province_size() + 1, glm::vec2(0));
-	std::vector<int> tiles_number(context.state.world.province_size() + 1, 0);
-	for(int i = size_x * size_y - 1; i-- > 0;) {
-		auto prov_id = province_id_map[i];
-		int x = i % size_x;
-		int y = i / size_x;
-		accumulated_tile_positions[prov_id] += glm::vec2(x, y);
-		tiles_number[prov_id]++;
+	// Each stripe of rows accumulates into its own buffers, which are summed afterwards. Since the sums are integral
+	// the result does not depend on how the map is split up.
+	uint32_t const prov_count = context.state.world.province_size() + 1;
+	uint32_t const last_pixel = size_x * size_y - 1; // the bottom-right pixel has never been counted
+	uint32_t const stripe_count = std::max(uint32_t(1), std::min(uint32_t(32), size_y));
+	uint32_t const rows_per_stripe = (size_y + stripe_count - 1) / stripe_count;
+
+	std::vector<std::vector<glm::ivec2>> stripe_positions(stripe_count);
+	std::vector<std::vector<int>> stripe_tiles(stripe_count);
+	concurrency::parallel_for(uint32_t(0), stripe_count, [&](uint32_t stripe) {
+		auto& positions = stripe_positions[stripe];
+		auto& tiles = stripe_tiles[stripe];
+		positions.resize(prov_count, glm::ivec2(0));
+		tiles.resize(prov_count, 0);
+		uint32_t const start = std::min(stripe * rows_per_stripe * size_x, last_pixel);
+		uint32_t const end = std::min((stripe + 1) * rows_per_stripe * size_x, last_pixel);
+		for(uint32_t i = start; i < end; ++i) {
+			auto prov_id = province_id_map[i];
+			positions[prov_id] += glm::ivec2(i % size_x, i / size_x);
+			tiles[prov_id]++;
+		}
+	});
+
+	std::vector<glm::ivec2> accumulated_tile_positions(prov_count, glm::ivec2(0));
+	std::vector<int> tiles_number(prov_count, 0);
+	for(uint32_t stripe = 0; stripe < stripe_count; ++stripe) {
+		for(uint32_t i = 0; i < prov_count; ++i) {
+			accumulated_tile_positions[i] += stripe_positions[stripe][i];
+			tiles_number[i] += stripe_tiles[stripe][i];
+		}
 	}
 	for(int i = context.state.world.province_size(); i-- > 1;) { // map-id province 0 == the invalid province; we don't need to collect data for it
 		glm::ivec2 tile_pos;
@@ -843,23 +861,40 @@ void display_data::load_province_data(parsers::scenario_building_context& contex
 	auto top_free_space = (free_space * 3) / 5;
 
 	province_id_map.resize(imsz);
-	uint32_t i = 0;
-	for(; i < top_free_space * size_x; ++i) { // schombert: fill with nothing until the start of the real data
-		province_id_map[i] = 0;
-	}
 	auto first_actual_map_pixel = top_free_space * size_x; // schombert: where the real data starts
-	for(; i < first_actual_map_pixel + image.size_x * image.size_y; ++i) {
-		uint8_t* ptr = image.data + (i - first_actual_map_pixel) * 4; // schombert: subtract to find our offset in the actual image data
-		auto color = sys::pack_color(ptr[0], ptr[1], ptr[2]);
-		if(auto it = context.map_color_to_province_id.find(color); it != context.map_color_to_province_id.end()) {
-			province_id_map[i] = province::to_map_id(it->second);
-		} else {
-			province_id_map[i] = 0;
+	auto end_actual_map_pixel = std::min(imsz, first_actual_map_pixel + image.size_x * image.size_y);
+
+	// schombert: fill with nothing until the start of the real data, and fill the remainder with nothing
+	std::fill(province_id_map.begin(), province_id_map.begin() + first_actual_map_pixel, uint16_t(0));
+	std::fill(province_id_map.begin() + end_actual_map_pixel, province_id_map.end(), uint16_t(0));
+
+	// The image is resolved in stripes of rows in parallel. Adjacent pixels almost always belong to the same province, so
+	// each stripe remembers the last color it resolved and only goes to the hash table when the color changes.
+	uint32_t const image_rows = uint32_t(image.size_y);
+	uint32_t const stripe_count = std::max(uint32_t(1), std::min(uint32_t(64), image_rows));
+	uint32_t const rows_per_stripe = (image_rows + stripe_count - 1) / stripe_count;
+	concurrency::parallel_for(uint32_t(0), stripe_count, [&](uint32_t stripe) {
+		uint32_t const start = first_actual_map_pixel + std::min(stripe * rows_per_stripe, image_rows) * image.size_x;
+		uint32_t const end = std::min(end_actual_map_pixel, first_actual_map_pixel + std::min((stripe + 1) * rows_per_stripe, image_rows) * image.size_x);
+
+		uint32_t last_color = 0;
+		uint16_t last_id = 0;
+		bool has_last = false;
+		for(uint32_t i = start; i < end; ++i) {
+			uint8_t* ptr = image.data + (i - first_actual_map_pixel) * 4; // schombert: subtract to find our offset in the actual image data
+			auto color = sys::pack_color(ptr[0], ptr[1], ptr[2]);
+			if(!has_last || color != last_color) {
+				if(auto it = context.map_color_to_province_id.find(color); it != context.map_color_to_province_id.end()) {
+					last_id = province::to_map_id(it->second);
+				} else {
+					last_id = 0;
+				}
+				last_color = color;
+				has_last = true;
+			}
+			province_id_map[i] = last_id;
 		}
-	}
-	for(; i < imsz; ++i) { // schombert: fill remainder with nothing
-		province_id_map[i] = 0;
-	}
+	});
 
 	load_provinces_mid_point(context);
 }
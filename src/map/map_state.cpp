@@ -308,6 +308,17 @@ bool map_state::map_to_screen(sys::state& state, glm::vec2 map_pos, glm::vec2 sc
 	}
 }
 
+bool map_state::visible_map_region(sys::state& state, glm::vec2 screen_size, glm::vec2 margin, glm::vec2& top_left, glm::vec2& bottom_right) {
+	if(state.user_settings.map_is_globe)
+		return false;
+	// the inverse of the flat case of map_to_screen
+	auto scale = glm::vec2{ zoom * (float(map_data.size_x) / float(map_data.size_y)) * (screen_size.y / screen_size.x), zoom } * screen_size;
+	auto half_extent = (screen_size * 0.5f + margin) / scale;
+	top_left = pos - half_extent;
+	bottom_right = pos + half_extent;
+	return true;
+}
+
 glm::vec2 map_state::normalize_map_coord(glm::vec2 p) {
 	auto new_pos = p / glm::vec2{ float(map_data.size_x), float(map_data.size_y) };
 	new_pos.y = 1.f - new_pos.y;
@@ -29,6 +29,9 @@ public:
 
 	glm::vec2 normalize_map_coord(glm::vec2 pos);
 	bool map_to_screen(sys::state& state, glm::vec2 map_pos, glm::vec2 screen_size, glm::vec2& screen_pos);
+	// Finds the part of the map (in normalized map coordinates, x may extend beyond [0, 1]) that can appear on a screen of the given
+	// size, widened by margin screen pixels on each side. Returns false when that cannot be bounded (on the globe)
+	bool visible_map_region(sys::state& state, glm::vec2 screen_size, glm::vec2 margin, glm::vec2& top_left, glm::vec2& bottom_right);
 
 
 	// Set the position of camera. Position relative from 0-1
@@ -24,7 +24,27 @@ void apply_base_unit_stat_modifiers(sys::state& state) {
 	}
 }
 
+void update_cb_trigger_dependencies(sys::state& state) {
+	bool reads_progress = false;
+	auto scan = [&](dcon::trigger_key k) {
+		if(!k)
+			return;
+		trigger::recurse_over_triggers(state.trigger_data.data() + k.index(), [&](uint16_t* tval) {
+			if((tval[0] & trigger::code_mask) == trigger::constructing_cb_progress)
+				reads_progress = true;
+		});
+	};
+	for(auto cb : state.world.in_cb_type) {
+		scan(cb.get_can_use());
+		scan(cb.get_allowed_states());
+		scan(cb.get_allowed_countries());
+		scan(cb.get_allowed_substate_regions());
+	}
+	state.military_definitions.cb_triggers_read_fabrication_progress = reads_progress;
+}
+
 void restore_unsaved_values(sys::state& state) {
+	update_cb_trigger_dependencies(state);
 	state.world.for_each_nation([&](dcon::nation_id n) {
 		auto w = state.world.nation_get_war_participant(n);
 		if(w.begin() != w.end()) {
@@ -33,6 +53,7 @@ void restore_unsaved_values(sys::state& state) {
 	});
 	update_all_recruitable_regiments(state);
 	regenerate_total_regiment_counts(state);
+	regenerate_leader_counts(state);
 	update_naval_supply_points(state);
 }
 
@@ -207,14 +228,7 @@ int32_t supply_limit_in_province(sys::state& state, dcon::nation_id n, dcon::pro
 	return int32_t( base_supply_lim * modifier * national_supply_lim );
 }
 int32_t regiments_created_from_province(sys::state& state, dcon::province_id p) {
-	int32_t total = 0;
-	for(auto pop : state.world.province_get_pop_location(p)) {
-		if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers) {
-			auto regs = pop.get_pop().get_regiment_source();
-			total += int32_t(regs.end() - regs.begin());
-		}
-	}
-	return total;
+	return int32_t(state.world.province_get_regiments_created(p));
 }
 int32_t mobilized_regiments_created_from_province(sys::state& state, dcon::province_id p) {
 	/*
@@ -233,98 +247,58 @@ int32_t mobilized_regiments_created_from_province(sys::state& state, dcon::provi
 	return total;
 }
 int32_t regiments_max_possible_from_province(sys::state& state, dcon::province_id p) {
-	/*
-	- A soldier pop must be at least define:POP_MIN_SIZE_FOR_REGIMENT to support any regiments
-	- If it is at least that large, then it can support one regiment per define:POP_SIZE_PER_REGIMENT x define:POP_MIN_SIZE_FOR_REGIMENT_COLONY_MULTIPLIER (if it is located in a colonial province) x define:POP_MIN_SIZE_FOR_REGIMENT_NONCORE_MULTIPLIER (if it is non-colonial but uncored)
-	*/
-	int32_t total = 0;
-	if(state.world.province_get_is_colonial(p)) {
-		float divisor = state.defines.pop_size_per_regiment * state.defines.pop_min_size_for_regiment_colony_multiplier;
-		for(auto pop : state.world.province_get_pop_location(p)) {
-			if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers) {
-				if(pop.get_pop().get_size() >= divisor) {
-					total += int32_t((pop.get_pop().get_size() / divisor)+1);
-				} else if(pop.get_pop().get_size() >= state.defines.pop_min_size_for_regiment) {
-					total++;
-				}
-			}
-		}
-	} else if(!state.world.province_get_is_owner_core(p)) {
-		float divisor = state.defines.pop_size_per_regiment * state.defines.pop_min_size_for_regiment_noncore_multiplier;
-		for(auto pop : state.world.province_get_pop_location(p)) {
-			if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers) {
-				if(pop.get_pop().get_size() >= divisor) {
-					total += int32_t((pop.get_pop().get_size() / divisor)+1);
-				} else if(pop.get_pop().get_size() >= state.defines.pop_min_size_for_regiment) {
-					total++;
-				}
-			}
-		}
-	} else {
-		float divisor = state.defines.pop_size_per_regiment;
-		for(auto pop : state.world.province_get_pop_location(p)) {
-			if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers) {
-				if(pop.get_pop().get_size() >= state.defines.pop_size_per_regiment) {
-					total += int32_t((pop.get_pop().get_size() / divisor)+1);
-				} else if(pop.get_pop().get_size() >= state.defines.pop_min_size_for_regiment) {
-					total++;
-				}
-			}
-		}
-	}
-	return total;
+	return int32_t(state.world.province_get_regiment_capacity(p));
 }
 int32_t main_culture_regiments_created_from_province(sys::state& state, dcon::province_id p) {
-	int32_t total = 0;
-	for(auto pop : state.world.province_get_pop_location(p)) {
-		if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers && pop.get_pop().get_is_primary_or_accepted_culture()) {
-			auto regs = pop.get_pop().get_regiment_source();
-			total += int32_t(regs.end() - regs.begin());
-		}
-	}
-	return total;
+	return int32_t(state.world.province_get_main_culture_regiments_created(p));
 }
 int32_t main_culture_regiments_max_possible_from_province(sys::state& state, dcon::province_id p) {
+	return int32_t(state.world.province_get_main_culture_regiment_capacity(p));
+}
+int32_t regiments_supported_by_pop(sys::state& state, dcon::pop_id p) {
 	/*
 	- A soldier pop must be at least define:POP_MIN_SIZE_FOR_REGIMENT to support any regiments
 	- If it is at least that large, then it can support one regiment per define:POP_SIZE_PER_REGIMENT x define:POP_MIN_SIZE_FOR_REGIMENT_COLONY_MULTIPLIER (if it is located in a colonial province) x define:POP_MIN_SIZE_FOR_REGIMENT_NONCORE_MULTIPLIER (if it is non-colonial but uncored)
 	*/
-	int32_t total = 0;
-	if(state.world.province_get_is_colonial(p)) {
-		float divisor = state.defines.pop_size_per_regiment * state.defines.pop_min_size_for_regiment_colony_multiplier;
-		for(auto pop : state.world.province_get_pop_location(p)) {
-			if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers && pop.get_pop().get_is_primary_or_accepted_culture()) {
-				if(pop.get_pop().get_size() >= divisor) {
-					total += int32_t((pop.get_pop().get_size() / divisor)+1);
-				} else if(pop.get_pop().get_size() >= state.defines.pop_min_size_for_regiment) {
-					total++;
-				}
-			}
-		}
-	} else if(!state.world.province_get_is_owner_core(p)) {
-		float divisor = state.defines.pop_size_per_regiment * state.defines.pop_min_size_for_regiment_noncore_multiplier;
-		for(auto pop : state.world.province_get_pop_location(p)) {
-			if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers && pop.get_pop().get_is_primary_or_accepted_culture()) {
-				if(pop.get_pop().get_size() >= divisor) {
-					total += int32_t(pop.get_pop().get_size() / divisor);
-				} else if(pop.get_pop().get_size() >= state.defines.pop_min_size_for_regiment) {
-					total++;
-				}
-			}
-		}
-	} else {
-		float divisor = state.defines.pop_size_per_regiment;
-		for(auto pop : state.world.province_get_pop_location(p)) {
-			if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers && pop.get_pop().get_is_primary_or_accepted_culture()) {
-				if(pop.get_pop().get_size() >= state.defines.pop_size_per_regiment) {
-					total += int32_t(pop.get_pop().get_size() / divisor);
-				} else if(pop.get_pop().get_size() >= state.defines.pop_min_size_for_regiment) {
-					total++;
-				}
-			}
-		}
-	}
-	return total;
+	if(state.world.pop_get_poptype(p) != state.culture_definitions.soldiers)
+		return 0;
+
+	auto location = state.world.pop_get_province_from_pop_location(p);
+	float divisor = state.defines.pop_size_per_regiment;
+	if(state.world.province_get_is_colonial(location))
+		divisor *= state.defines.pop_min_size_for_regiment_colony_multiplier;
+	else if(!state.world.province_get_is_owner_core(location))
+		divisor *= state.defines.pop_min_size_for_regiment_noncore_multiplier;
+
+	auto size = state.world.pop_get_size(p);
+	if(size >= divisor)
+		return int32_t((size / divisor) + 1);
+	else if(size >= state.defines.pop_min_size_for_regiment)
+		return 1;
+	return 0;
+}
+int32_t main_culture_regiments_supported_by_pop(sys::state& state, dcon::pop_id p) {
+	/*
+	As above, for a pop of a primary or accepted culture, except that outside of colonies a pop large enough for more than one
+	regiment does not get the extra one
+	*/
+	if(state.world.pop_get_poptype(p) != state.culture_definitions.soldiers || !state.world.pop_get_is_primary_or_accepted_culture(p))
+		return 0;
+
+	auto location = state.world.pop_get_province_from_pop_location(p);
+	float divisor = state.defines.pop_size_per_regiment;
+	bool colonial = state.world.province_get_is_colonial(location);
+	if(colonial)
+		divisor *= state.defines.pop_min_size_for_regiment_colony_multiplier;
+	else if(!state.world.province_get_is_owner_core(location))
+		divisor *= state.defines.pop_min_size_for_regiment_noncore_multiplier;
+
+	auto size = state.world.pop_get_size(p);
+	if(size >= divisor)
+		return int32_t(size / divisor) + (colonial ? 1 : 0);
+	else if(size >= state.defines.pop_min_size_for_regiment)
+		return 1;
+	return 0;
 }
 int32_t regiments_under_construction_in_province(sys::state& state, dcon::province_id p) {
 	auto range = state.world.province_get_province_land_construction(p);
@@ -340,88 +314,16 @@ int32_t main_culture_regiments_under_construction_in_province(sys::state& state,
 }
 
 dcon::pop_id find_available_soldier(sys::state& state, dcon::province_id p, bool require_accepted) {
-	if(state.world.province_get_is_colonial(p)) {
-		float divisor = state.defines.pop_size_per_regiment * state.defines.pop_min_size_for_regiment_colony_multiplier;
-		dcon::pop_id non_preferred;
-		for(auto pop : state.world.province_get_pop_location(p)) {
-			if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers) {
-				if(pop.get_pop().get_size() >= divisor) {
-					auto amount = int32_t((pop.get_pop().get_size() / divisor)+1);
-					auto regs = pop.get_pop().get_regiment_source();
-					if(amount > (regs.end() - regs.begin())) {
-						if(require_accepted == pop.get_pop().get_is_primary_or_accepted_culture())
-							return pop.get_pop().id;
-						else
-							non_preferred = pop.get_pop().id;
-					}
-				} else if(pop.get_pop().get_size() >= state.defines.pop_min_size_for_regiment) {
-					auto amount = 1;
-					auto regs = pop.get_pop().get_regiment_source();
-					if(amount > (regs.end() - regs.begin())) {
-						if(require_accepted == pop.get_pop().get_is_primary_or_accepted_culture())
-							return pop.get_pop().id;
-						else
-							non_preferred = pop.get_pop().id;
-					}
-				}
-			}
-		}
-		return non_preferred;
-	} else if(!state.world.province_get_is_owner_core(p)) {
-		float divisor = state.defines.pop_size_per_regiment * state.defines.pop_min_size_for_regiment_noncore_multiplier;
-		dcon::pop_id non_preferred;
-		for(auto pop : state.world.province_get_pop_location(p)) {
-			if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers) {
-				if(pop.get_pop().get_size() >= divisor) {
-					auto amount = int32_t((pop.get_pop().get_size() / divisor)+1);
-					auto regs = pop.get_pop().get_regiment_source();
-					if(amount > (regs.end() - regs.begin())) {
-						if(require_accepted == pop.get_pop().get_is_primary_or_accepted_culture())
-							return pop.get_pop().id;
-						else
-							non_preferred = pop.get_pop().id;
-					}
-				} else if(pop.get_pop().get_size() >= state.defines.pop_min_size_for_regiment) {
-					auto amount = 1;
-					auto regs = pop.get_pop().get_regiment_source();
-					if(amount > (regs.end() - regs.begin())) {
-						if(require_accepted == pop.get_pop().get_is_primary_or_accepted_culture())
-							return pop.get_pop().id;
-						else
-							non_preferred = pop.get_pop().id;
-					}
-				}
-			}
-		}
-		return non_preferred;
-	} else {
-		float divisor = state.defines.pop_size_per_regiment;
-		dcon::pop_id non_preferred;
-		for(auto pop : state.world.province_get_pop_location(p)) {
-			if(pop.get_pop().get_poptype() == state.culture_definitions.soldiers) {
-				if(pop.get_pop().get_size() >= state.defines.pop_size_per_regiment) {
-					auto amount = int32_t((pop.get_pop().get_size() / divisor)+1);
-					auto regs = pop.get_pop().get_regiment_source();
-					if(amount > (regs.end() - regs.begin())) {
-						if(require_accepted == pop.get_pop().get_is_primary_or_accepted_culture())
-							return pop.get_pop().id;
-						else
-							non_preferred = pop.get_pop().id;
-					}
-				} else if(pop.get_pop().get_size() >= state.defines.pop_min_size_for_regiment) {
-					auto amount = 1;
-					auto regs = pop.get_pop().get_regiment_source();
-					if(amount > (regs.end() - regs.begin())) {
-						if(require_accepted == pop.get_pop().get_is_primary_or_accepted_culture())
-							return pop.get_pop().id;
-						else
-							non_preferred = pop.get_pop().id;
-					}
-				}
-			}
+	dcon::pop_id non_preferred;
+	for(auto pop : state.world.province_get_pop_location(p)) {
+		if(pop.get_pop().get_regiment_capacity() > pop.get_pop().get_counted_regiments()) {
+			if(require_accepted == pop.get_pop().get_is_primary_or_accepted_culture())
+				return pop.get_pop().id;
+			else
+				non_preferred = pop.get_pop().id;
 		}
-		return non_preferred;
 	}
+	return non_preferred;
 }
 
 int32_t mobilized_regiments_possible_from_province(sys::state& state, dcon::province_id p) {
@@ -452,21 +354,96 @@ int32_t mobilized_regiments_possible_from_province(sys::state& state, dcon::prov
 	return total;
 }
 
-void update_recruitable_regiments(sys::state& state, dcon::nation_id n) {
-	state.world.nation_set_recruitable_regiments(n, uint16_t(0));
-	for(auto p : state.world.nation_get_province_ownership(n)) {
-		state.world.nation_get_recruitable_regiments(n) += uint16_t(regiments_max_possible_from_province(state, p.get_province()));
+namespace impl {
+
+void adjust_regiment_counts(sys::state& state, dcon::province_id location, int32_t capacity, int32_t main_capacity, int32_t regiments, bool main_culture, int32_t sign) {
+	if(!location)
+		return;
+	auto add = [&](uint16_t& v, int32_t amount) {
+		v = uint16_t(int32_t(v) + sign * amount);
+	};
+	add(state.world.province_get_regiment_capacity(location), capacity);
+	add(state.world.province_get_main_culture_regiment_capacity(location), main_capacity);
+	add(state.world.province_get_regiments_created(location), regiments);
+	if(main_culture)
+		add(state.world.province_get_main_culture_regiments_created(location), regiments);
+}
+
+}
+
+void update_pop_regiment_counts(sys::state& state, dcon::pop_id p) {
+	auto capacity = regiments_supported_by_pop(state, p);
+	auto main_capacity = main_culture_regiments_supported_by_pop(state, p);
+	auto regiments = 0;
+	if(state.world.pop_get_poptype(p) == state.culture_definitions.soldiers) {
+		auto regs = state.world.pop_get_regiment_source(p);
+		regiments = int32_t(regs.end() - regs.begin());
 	}
+	auto main_culture = state.world.pop_get_is_primary_or_accepted_culture(p);
+
+	auto old_capacity = int32_t(state.world.pop_get_regiment_capacity(p));
+	auto old_main_capacity = int32_t(state.world.pop_get_main_culture_regiment_capacity(p));
+	auto old_regiments = int32_t(state.world.pop_get_counted_regiments(p));
+	auto old_main_culture = state.world.pop_get_counted_as_main_culture(p);
+	if(capacity == old_capacity && main_capacity == old_main_capacity && regiments == old_regiments && main_culture == old_main_culture)
+		return;
+
+	auto location = state.world.pop_get_province_from_pop_location(p);
+	impl::adjust_regiment_counts(state, location, old_capacity, old_main_capacity, old_regiments, old_main_culture, -1);
+	impl::adjust_regiment_counts(state, location, capacity, main_capacity, regiments, main_culture, 1);
+
+	state.world.pop_set_regiment_capacity(p, uint16_t(capacity));
+	state.world.pop_set_main_culture_regiment_capacity(p, uint16_t(main_capacity));
+	state.world.pop_set_counted_regiments(p, uint16_t(regiments));
+	state.world.pop_set_counted_as_main_culture(p, main_culture);
+}
+void remove_pop_regiment_counts(sys::state& state, dcon::pop_id p) {
+	impl::adjust_regiment_counts(state, state.world.pop_get_province_from_pop_location(p), int32_t(state.world.pop_get_regiment_capacity(p)),
+		int32_t(state.world.pop_get_main_culture_regiment_capacity(p)), int32_t(state.world.pop_get_counted_regiments(p)),
+		state.world.pop_get_counted_as_main_culture(p), -1);
+
+	state.world.pop_set_regiment_capacity(p, uint16_t(0));
+	state.world.pop_set_main_culture_regiment_capacity(p, uint16_t(0));
+	state.world.pop_set_counted_regiments(p, uint16_t(0));
+	state.world.pop_set_counted_as_main_culture(p, false);
+}
+void delete_regiment(sys::state& state, dcon::regiment_id r) {
+	auto source = state.world.regiment_get_pop_from_regiment_source(r);
+	state.world.delete_regiment(r);
+	if(source)
+		update_pop_regiment_counts(state, source);
+}
+void update_pop_regiment_capacity(sys::state& state) {
+	// only soldier pops support regiments; any other pop still holding counts stopped being soldiers since it was last looked at
+	state.world.execute_serial_over_pop([&](auto ids) {
+		ve::apply([&](dcon::pop_id p, bool is_soldier) {
+			if(is_soldier || state.world.pop_get_regiment_capacity(p) != 0 || state.world.pop_get_counted_regiments(p) != 0)
+				update_pop_regiment_counts(state, p);
+		}, ids, state.world.pop_get_poptype(ids) == state.culture_definitions.soldiers);
+	});
 }
 void update_all_recruitable_regiments(sys::state& state) {
+	state.world.execute_serial_over_province([&](auto ids) {
+		state.world.province_set_regiment_capacity(ids, ve::int_vector(0));
+		state.world.province_set_main_culture_regiment_capacity(ids, ve::int_vector(0));
+		state.world.province_set_regiments_created(ids, ve::int_vector(0));
+		state.world.province_set_main_culture_regiments_created(ids, ve::int_vector(0));
+	});
+	state.world.execute_serial_over_pop([&](auto ids) {
+		state.world.pop_set_regiment_capacity(ids, ve::int_vector(0));
+		state.world.pop_set_counted_regiments(ids, ve::int_vector(0));
+		state.world.pop_set_main_culture_regiment_capacity(ids, ve::int_vector(0));
+		state.world.pop_set_counted_as_main_culture(ids, ve::mask_vector(false));
+	});
+	update_pop_regiment_capacity(state);
+
 	state.world.execute_serial_over_nation([&](auto ids) {
 		state.world.nation_set_recruitable_regiments(ids, ve::int_vector(0));
 	});
 	state.world.for_each_province([&](dcon::province_id p) {
 		auto owner = state.world.province_get_nation_from_province_ownership(p);
-		if(owner) {
-			state.world.nation_get_recruitable_regiments(owner) += uint16_t(regiments_max_possible_from_province(state, p));
-		}
+		if(owner)
+			state.world.nation_get_recruitable_regiments(owner) += state.world.province_get_regiment_capacity(p);
 	});
 }
 void regenerate_total_regiment_counts(sys::state& state) {
@@ -655,68 +632,135 @@ bool cb_conditions_satisfied(sys::state& state, dcon::nation_id actor, dcon::nat
 	return true;
 }
 
-void update_cbs(sys::state& state) {
-	for(auto n : state.world.in_nation) {
-		auto current_cbs = n.get_available_cbs();
-		for(uint32_t i = current_cbs.size(); i-- > 0;) {
-			if(current_cbs[i].expiration && current_cbs[i].expiration <= state.current_date) {
-				current_cbs.remove_at(i);
-			}
-		}
+namespace impl {
 
-		// check for cancellation
-		if(n.get_constructing_cb_type()) {
-			/*
-			CBs that become invalid (the nations involved no longer satisfy the conditions or enter into a war with each other) are canceled (and the player should be notified in this event).
-			*/
-			auto target = n.get_constructing_cb_target();
-			if(military::are_at_war(state, n, target)
-				|| state.world.nation_get_owned_province_count(target) == 0
-				|| !cb_conditions_satisfied(state, n, target, n.get_constructing_cb_type())) {
+// what happens to a nation's cb fabrication today, as decided from the state of the world
+struct cb_update {
+	float new_progress = 0.0f;
+	bool cancel = false;
+	bool advance = false;
+	bool discover = false;
+	bool complete = false;
+};
 
-				// TODO: notify player
+cb_update evaluate_cb_update(sys::state& state, dcon::nation_id id) {
+	cb_update u;
+	auto n = fatten(state.world, id);
 
-				n.set_constructing_cb_is_discovered(false);
-				n.set_constructing_cb_progress(0.0f);
-				n.set_constructing_cb_target(dcon::nation_id{});
-				n.set_constructing_cb_type(dcon::cb_type_id{});
+	// check for cancellation
+	if(n.get_constructing_cb_type()) {
+		/*
+		CBs that become invalid (the nations involved no longer satisfy the conditions or enter into a war with each other) are canceled (and the player should be notified in this event).
+		*/
+		auto target = n.get_constructing_cb_target();
+		if(military::are_at_war(state, n, target)
+			|| state.world.nation_get_owned_province_count(target) == 0
+			|| !cb_conditions_satisfied(state, n, target, n.get_constructing_cb_type())) {
+
+			u.cancel = true;
+			return u;
+		}
+	}
+
+	if(n.get_constructing_cb_type() && !nations::is_involved_in_crisis(state, n)) {
+		/*
+		CB fabrication by a nation is paused while that nation is in a crisis (nor do events related to CB fabrication happen). CB fabrication is advanced by points equal to:
+		define:CB_GENERATION_BASE_SPEED x cb-type-construction-speed x (national-cb-construction-speed-modifiers + technology-cb-construction-speed-modifier + 1).
+		*/
+		u.advance = true;
+		u.new_progress = n.get_constructing_cb_progress() + state.defines.cb_generation_base_speed * n.get_constructing_cb_type().get_construction_speed() * (n.get_modifier_values(sys::national_mod_offsets::cb_generation_speed_modifier) + 1.0f);
+
+		/*
+		Each day, a fabricating CB has a define:CB_DETECTION_CHANCE_BASE out of 1000 chance to be detected. If discovered, the fabricating country gains the infamy for that war goal x the fraction of fabrication remaining. If discovered relations between the two nations are changed by define:ON_CB_DETECTED_RELATION_CHANGE. If discovered, any states with a flashpoint in the target nation will have their tension increase by define:TENSION_ON_CB_DISCOVERED
+		*/
+		if(!n.get_constructing_cb_is_discovered()) {
+			auto val = rng::get_random(state, uint32_t((n.id.index() << 3) + 5)) % 1000;
+			if(val <= uint32_t(state.defines.cb_detection_chance_base)) {
+				u.discover = true;
 			}
 		}
 
-		if(n.get_constructing_cb_type() && !nations::is_involved_in_crisis(state, n)) {
-			/*
-			CB fabrication by a nation is paused while that nation is in a crisis (nor do events related to CB fabrication happen). CB fabrication is advanced by points equal to:
-			define:CB_GENERATION_BASE_SPEED x cb-type-construction-speed x (national-cb-construction-speed-modifiers + technology-cb-construction-speed-modifier + 1).
-			*/
+		// TODO: cb fabrication events
 
-			n.get_constructing_cb_progress() += state.defines.cb_generation_base_speed * n.get_constructing_cb_type().get_construction_speed() * (n.get_modifier_values(sys::national_mod_offsets::cb_generation_speed_modifier) + 1.0f);
+		/*
+		When fabrication progress reaches 100, the CB will remain valid for define:CREATED_CB_VALID_TIME months (so x30 days for us). Note that pending CBs have their target nation fixed, but all other parameters are flexible.
+		*/
+		u.complete = u.new_progress >= 100.0f;
+	}
+	return u;
+}
 
-			/*
-			Each day, a fabricating CB has a define:CB_DETECTION_CHANCE_BASE out of 1000 chance to be detected. If discovered, the fabricating country gains the infamy for that war goal x the fraction of fabrication remaining. If discovered relations between the two nations are changed by define:ON_CB_DETECTED_RELATION_CHANGE. If discovered, any states with a flashpoint in the target nation will have their tension increase by define:TENSION_ON_CB_DISCOVERED
-			*/
-			if(!n.get_constructing_cb_is_discovered()) {
-				auto val = rng::get_random(state, uint32_t((n.id.index() << 3) + 5)) % 1000;
-				if(val <= uint32_t(state.defines.cb_detection_chance_base)) {
-					execute_cb_discovery(state, n);
-					n.set_constructing_cb_is_discovered(true);
-				}
-			}
+// applies the update; returns true if it changed anything that the evaluation of another nation could see
+bool commit_cb_update(sys::state& state, dcon::nation_id id, cb_update const& u) {
+	auto n = fatten(state.world, id);
+	if(u.cancel) {
+		// TODO: notify player
+
+		n.set_constructing_cb_is_discovered(false);
+		n.set_constructing_cb_progress(0.0f);
+		n.set_constructing_cb_target(dcon::nation_id{});
+		n.set_constructing_cb_type(dcon::cb_type_id{});
+		return true;
+	}
+	if(!u.advance)
+		return false;
 
+	n.set_constructing_cb_progress(u.new_progress);
+	if(u.discover) {
+		execute_cb_discovery(state, n);
+		n.set_constructing_cb_is_discovered(true);
+	}
+	if(u.complete) {
+		add_cb(state, n, n.get_constructing_cb_type(), n.get_constructing_cb_target());
+		n.set_constructing_cb_is_discovered(false);
+		n.set_constructing_cb_progress(0.0f);
+		n.set_constructing_cb_target(dcon::nation_id{});
+		n.set_constructing_cb_type(dcon::cb_type_id{});
+	}
+	// the new progress is visible to the evaluation of another nation only through a cb type trigger that tests it
+	return u.discover || u.complete || state.military_definitions.cb_triggers_read_fabrication_progress;
+}
 
-			// TODO: cb fabrication events
+}
 
-			/*
-			When fabrication progress reaches 100, the CB will remain valid for define:CREATED_CB_VALID_TIME months (so x30 days for us). Note that pending CBs have their target nation fixed, but all other parameters are flexible.
-			*/
-			if(n.get_constructing_cb_progress() >= 100.0f) {
-				add_cb(state, n, n.get_constructing_cb_type(), n.get_constructing_cb_target());
-				n.set_constructing_cb_is_discovered(false);
-				n.set_constructing_cb_progress(0.0f);
-				n.set_constructing_cb_target(dcon::nation_id{});
-				n.set_constructing_cb_type(dcon::cb_type_id{});
+void update_cbs(sys::state& state, bool in_parallel) {
+	/*
+	Cbs that have run out are removed first, for every nation, so that no nation's evaluation (which can look at the cbs of
+	other nations through the casus_belli triggers) sees some of the day's expiries and not others.
+
+	Each nation's update is then decided in parallel from the state of the world after those expiries, and applied serially in
+	nation order. Until some nation's update changes something that another nation's evaluation could have seen, those decisions
+	are exactly what the serial version would have made: cancelling or completing a fabrication changes the constructing cb target
+	and the available cbs that triggers may test, a discovery changes infamy, relations and tension, and an advance changes the
+	fabrication progress (which matters only if some cb type trigger tests it, see update_cb_trigger_dependencies). After that
+	point, the remaining nations are re-evaluated as they are applied. With the vanilla cb types only the rare events end the
+	parallel part early, and either way the result is the same as updating the nations one after another.
+	*/
+	for(auto n : state.world.in_nation) {
+		auto current_cbs = n.get_available_cbs();
+		for(uint32_t i = current_cbs.size(); i-- > 0;) {
+			if(current_cbs[i].expiration && current_cbs[i].expiration <= state.current_date) {
+				current_cbs.remove_at(i);
 			}
 		}
 	}
+
+	static std::vector<impl::cb_update> updates;
+	updates.resize(state.world.nation_size());
+	if(in_parallel) {
+		concurrency::parallel_for(uint32_t(0), state.world.nation_size(), [&](uint32_t i) {
+			updates[i] = impl::evaluate_cb_update(state, dcon::nation_id{ dcon::nation_id::value_base_t(i) });
+		});
+	}
+
+	bool speculation_valid = in_parallel;
+	for(auto n : state.world.in_nation) {
+		auto& u = updates[n.id.index()];
+		if(!speculation_valid)
+			u = impl::evaluate_cb_update(state, n);
+		if(impl::commit_cb_update(state, n, u))
+			speculation_valid = false;
+	}
 }
 
 void add_cb(sys::state& state, dcon::nation_id n, dcon::cb_type_id cb, dcon::nation_id target) {
@@ -835,43 +879,138 @@ dcon::leader_id make_new_leader(sys::state& state, dcon::nation_id n, bool is_ge
 	l.set_since(state.current_date);
 
 	state.world.try_create_leader_loyalty(n, l);
+	register_leader(state, l);
 
 	state.world.nation_get_leadership_points(n) -= state.defines.leader_recruit_cost;
 
 	return l;
 }
 
-void kill_leader(sys::state& state, dcon::leader_id l) {
-	// TODO: notify?
-	/*
-	the player only gets leader death messages if the leader is currently assigned to an army or navy (assuming the message setting for it is turned on).
-	*/
+void register_leader(sys::state& state, dcon::leader_id l) {
+	auto n = state.world.leader_get_nation_from_leader_loyalty(l);
+	if(!n)
+		return;
+	if(state.world.leader_get_is_admiral(l))
+		state.world.nation_get_admiral_count(n) += uint16_t(1);
+	else
+		state.world.nation_get_general_count(n) += uint16_t(1);
+}
 
-	state.world.delete_leader(l);
+void register_army(sys::state& state, dcon::army_id a) {
+	auto n = state.world.army_get_controller_from_army_control(a);
+	if(!n)
+		return;
+	state.world.nation_get_army_count(n) += uint16_t(1);
+	if(!state.world.army_get_general_from_army_leadership(a))
+		state.world.nation_get_leaderless_armies(n).push_back(a);
 }
 
-struct leader_counts {
-	int32_t admirals = 0;
-	int32_t generals = 0;
-};
+void register_navy(sys::state& state, dcon::navy_id v) {
+	auto n = state.world.navy_get_controller_from_navy_control(v);
+	if(!n)
+		return;
+	state.world.nation_get_navy_count(n) += uint16_t(1);
+	if(!state.world.navy_get_admiral_from_navy_leadership(v))
+		state.world.nation_get_leaderless_navies(n).push_back(v);
+}
+
+void regenerate_leader_counts(sys::state& state) {
+	state.world.execute_serial_over_nation([&](auto ids) {
+		state.world.nation_set_general_count(ids, ve::int_vector(0));
+		state.world.nation_set_admiral_count(ids, ve::int_vector(0));
+		state.world.nation_set_army_count(ids, ve::int_vector(0));
+		state.world.nation_set_navy_count(ids, ve::int_vector(0));
+	});
+	state.world.for_each_nation([&](dcon::nation_id n) {
+		state.world.nation_get_leaderless_armies(n).clear();
+		state.world.nation_get_leaderless_navies(n).clear();
+	});
 
-leader_counts count_leaders(sys::state& state, dcon::nation_id n) {
-	leader_counts result{};
-	for(auto l : state.world.nation_get_leader_loyalty(n)) {
-		if(l.get_leader().get_is_admiral())
-			++result.admirals;
-		else
-			++result.generals;
+	state.world.for_each_leader([&](dcon::leader_id l) {
+		register_leader(state, l);
+	});
+	// in reverse, so that the free slots are handed out in the order the units are listed
+	for(uint32_t i = state.world.army_size(); i-- > 0;) {
+		dcon::army_id a{ dcon::army_id::value_base_t(i) };
+		if(state.world.army_is_valid(a))
+			register_army(state, a);
+	}
+	for(uint32_t i = state.world.navy_size(); i-- > 0;) {
+		dcon::navy_id v{ dcon::navy_id::value_base_t(i) };
+		if(state.world.navy_is_valid(v))
+			register_navy(state, v);
 	}
-	return result;
 }
-int32_t count_armies(sys::state& state, dcon::nation_id n) {
-	auto x = state.world.nation_get_army_control(n);
-	return int32_t(x.end() - x.begin());
+
+namespace impl {
+
+/*
+The leaderless unit lists are only ever appended to, so an entry may have been given a leader, changed hands, or been deleted
+since it was added. Such entries are simply dropped when they come up.
+*/
+dcon::army_id take_leaderless_army(sys::state& state, dcon::nation_id n) {
+	auto free_slots = state.world.nation_get_leaderless_armies(n);
+	while(free_slots.size() > 0) {
+		auto a = free_slots[free_slots.size() - 1];
+		free_slots.remove_at(free_slots.size() - 1);
+		if(state.world.army_is_valid(a) && state.world.army_get_controller_from_army_control(a) == n && !state.world.army_get_general_from_army_leadership(a))
+			return a;
+	}
+	return dcon::army_id{};
+}
+dcon::navy_id take_leaderless_navy(sys::state& state, dcon::nation_id n) {
+	auto free_slots = state.world.nation_get_leaderless_navies(n);
+	while(free_slots.size() > 0) {
+		auto v = free_slots[free_slots.size() - 1];
+		free_slots.remove_at(free_slots.size() - 1);
+		if(state.world.navy_is_valid(v) && state.world.navy_get_controller_from_navy_control(v) == n && !state.world.navy_get_admiral_from_navy_leadership(v))
+			return v;
+	}
+	return dcon::navy_id{};
+}
+
+}
+
+void kill_leaders(sys::state& state, std::vector<dcon::leader_id> const& leaders) {
+	// TODO: notify?
+	/*
+	the player only gets leader death messages if the leader is currently assigned to an army or navy (assuming the message setting for it is turned on).
+	*/
+
+	for(auto l : leaders) {
+		if(auto n = state.world.leader_get_nation_from_leader_loyalty(l); n) {
+			if(state.world.leader_get_is_admiral(l))
+				state.world.nation_get_admiral_count(n) -= uint16_t(1);
+			else
+				state.world.nation_get_general_count(n) -= uint16_t(1);
+		}
+		if(auto a = state.world.leader_get_army_from_army_leadership(l); a) {
+			if(auto controller = state.world.army_get_controller_from_army_control(a); controller)
+				state.world.nation_get_leaderless_armies(controller).push_back(a);
+		}
+		if(auto v = state.world.leader_get_navy_from_navy_leadership(l); v) {
+			if(auto controller = state.world.navy_get_controller_from_navy_control(v); controller)
+				state.world.nation_get_leaderless_navies(controller).push_back(v);
+		}
+		state.world.delete_leader(l);
+	}
 }
-int32_t count_navies(sys::state& state, dcon::nation_id n) {
-	auto x = state.world.nation_get_navy_control(n);
-	return int32_t(x.end() - x.begin());
+
+void update_leader_combat_status(sys::state& state) {
+	state.world.execute_serial_over_leader([&](auto ids) {
+		state.world.leader_set_in_combat(ids, ve::mask_vector(false));
+	});
+	// only a leader in command of a unit can be in combat
+	state.world.for_each_army_leadership([&](dcon::army_leadership_id al) {
+		auto l = state.world.army_leadership_get_general(al);
+		if(leader_is_in_combat(state, l))
+			state.world.leader_set_in_combat(l, true);
+	});
+	state.world.for_each_navy_leadership([&](dcon::navy_leadership_id nl) {
+		auto l = state.world.navy_leadership_get_admiral(nl);
+		if(leader_is_in_combat(state, l))
+			state.world.leader_set_in_combat(l, true);
+	});
 }
 
 void monthly_leaders_update(sys::state& state) {
@@ -892,34 +1031,26 @@ void monthly_leaders_update(sys::state& state) {
 		if(n.get_leadership_points() > state.defines.leader_recruit_cost * 3.0f) {
 			// automatically make new leader
 			auto new_l = [&]() {
-				auto existing_leaders = count_leaders(state, n);
-				auto army_count = count_armies(state, n);
-				auto navy_count = count_navies(state, n);
-				if(existing_leaders.generals < army_count) {
+				int32_t generals = n.get_general_count();
+				int32_t admirals = n.get_admiral_count();
+				int32_t army_count = n.get_army_count();
+				int32_t navy_count = n.get_navy_count();
+				if(generals < army_count) {
 					return make_new_leader(state, n, true);
-				} else if(existing_leaders.admirals < navy_count) {
+				} else if(admirals < navy_count) {
 					return make_new_leader(state, n, false);
 				} else {
-					auto too_many_generals = (existing_leaders.admirals > 0 && navy_count > 0) ? float(existing_leaders.generals) / float(existing_leaders.admirals) > float(army_count) / float(navy_count) : false;
+					auto too_many_generals = (admirals > 0 && navy_count > 0) ? float(generals) / float(admirals) > float(army_count) / float(navy_count) : false;
 					return make_new_leader(state, n, !too_many_generals);
 				}
 			}();
 			if(state.world.leader_get_is_admiral(new_l)) {
-				for(auto v : state.world.nation_get_navy_control(n)) {
-					if(!v.get_navy().get_admiral_from_navy_leadership()) {
-						state.world.try_create_navy_leadership(v.get_navy(), new_l);
-						break;
-					}
-				}
+				if(auto v = impl::take_leaderless_navy(state, n); v)
+					state.world.try_create_navy_leadership(v, new_l);
 			} else {
-				for(auto a : state.world.nation_get_army_control(n)) {
-					if(!a.get_army().get_general_from_army_leadership()) {
-						state.world.try_create_army_leadership(a.get_army(), new_l);
-						break;
-					}
-				}
+				if(auto a = impl::take_leaderless_army(state, n); a)
+					state.world.try_create_army_leadership(a, new_l);
 			}
-			
 		}
 	}
 }
@@ -928,31 +1059,46 @@ void daily_leaders_update(sys::state& state) {
 	Leaders who are both less than 26 years old and not in combat have no chance of death. Otherwise, we take the age of the leader and divide by define:LEADER_AGE_DEATH_FACTOR. Then we multiply that result by 2 if the leader is currently in combat. That is then the leader's current chance of death out of ... my notes say 11,000 here.
 	*/
 
-	for(uint32_t i = state.world.leader_size(); i-->0; ) {
-		dcon::leader_id l{dcon::leader_id::value_base_t(i) };
-		auto age_in_days = state.world.leader_get_since(l).to_raw_value() * 365;
-		if(age_in_days > 365 * 26) { // assume leaders are created at age 20; no death chance prior to 46
-			float age_in_years = float(age_in_days) / 365.0f;
-			float death_chance = (age_in_years * (leader_is_in_combat(state, l) ? 2.0f : 1.0f) / state.defines.leader_age_death_factor) / 11000.0f;
+	update_leader_combat_status(state);
 
-			/*
-			float live_chance = 1.0f - death_chance;
-			float live_chance_2 = live_chance * live_chance;
-			float live_chance_4 = live_chance_2 * live_chance_2;
-			float live_chance_8 = live_chance_4 * live_chance_4;
-			float live_chance_16 = live_chance_8 * live_chance_8;
-			float live_chance_32 = live_chance_16 * live_chance_16;
-
-			float monthly_chance = 1.0f - (live_chance_32 / live_chance_2);
-			*/
+	static std::vector<dcon::leader_id> dead_leaders;
+	dead_leaders.clear();
 
-			auto int_chance = uint32_t(death_chance * float(0xFFFFFFFF));
-			auto rvalue = uint32_t(rng::get_random(state, uint32_t(l.index())) & 0xFFFFFFFF);
+	state.world.execute_serial_over_leader([&](auto ids) {
+		auto age_in_days = ve::apply([&](dcon::leader_id l) {
+			return state.world.leader_is_valid(l) ? state.world.leader_get_since(l).to_raw_value() * 365 : 0;
+		}, ids);
+		auto may_die = age_in_days > 365 * 26; // assume leaders are created at age 20; no death chance prior to 46
+		if(ve::compress_mask(may_die).v == 0)
+			return;
 
-			if(rvalue < int_chance)
-				kill_leader(state, l);
-		}
-	}
+		auto age_in_years = ve::to_float(age_in_days) / 365.0f;
+		auto death_chance = (age_in_years * ve::select(state.world.leader_get_in_combat(ids), ve::fp_vector{ 2.0f }, 1.0f) / state.defines.leader_age_death_factor) / 11000.0f;
+
+		/*
+		float live_chance = 1.0f - death_chance;
+		float live_chance_2 = live_chance * live_chance;
+		float live_chance_4 = live_chance_2 * live_chance_2;
+		float live_chance_8 = live_chance_4 * live_chance_4;
+		float live_chance_16 = live_chance_8 * live_chance_8;
+		float live_chance_32 = live_chance_16 * live_chance_16;
+
+		float monthly_chance = 1.0f - (live_chance_32 / live_chance_2);
+		*/
+
+		ve::apply([&](dcon::leader_id l, float chance, bool candidate) {
+			if(candidate) {
+				auto int_chance = uint32_t(chance * float(0xFFFFFFFF));
+				auto rvalue = uint32_t(rng::get_random(state, uint32_t(l.index())) & 0xFFFFFFFF);
+				if(rvalue < int_chance)
+					dead_leaders.push_back(l);
+			}
+		}, ids, death_chance, may_die);
+	});
+
+	// all at once, after the rolls; the order matches the old reverse walk over the table
+	std::reverse(dead_leaders.begin(), dead_leaders.end());
+	kill_leaders(state, dead_leaders);
 }
 
 bool has_truce_with(sys::state const& state, dcon::nation_id attacker, dcon::nation_id target) {
@@ -79,6 +79,8 @@ struct global_military_state {
 
 	dcon::cb_type_id standard_civil_war;
 	dcon::cb_type_id standard_great_war;
+
+	bool cb_triggers_read_fabrication_progress = false; // not saved, see update_cb_trigger_dependencies
 };
 
 struct available_cb {
@@ -90,6 +92,8 @@ struct available_cb {
 void reset_unit_stats(sys::state& state);
 void apply_base_unit_stat_modifiers(sys::state& state);
 void restore_unsaved_values(sys::state& state); // must run after determining connectivity
+// notes whether any cb type trigger tests the progress of a cb fabrication, which decides how much of update_cbs can run in parallel
+void update_cb_trigger_dependencies(sys::state& state);
 
 bool are_at_war(sys::state const& state, dcon::nation_id a, dcon::nation_id b);
 bool are_allied_in_war(sys::state const& state, dcon::nation_id a, dcon::nation_id b);
@@ -116,10 +120,13 @@ float recruited_pop_fraction(sys::state const& state, dcon::nation_id n);
 bool state_has_naval_base(sys::state const& state, dcon::state_instance_id di);
 
 int32_t supply_limit_in_province(sys::state& state, dcon::nation_id n, dcon::province_id p);
+// the regiment counts and capacities by province are kept up to date as pops change (see update_pop_regiment_counts), so these are just lookups
 int32_t regiments_created_from_province(sys::state& state, dcon::province_id p); // does not include mobilized regiments
 int32_t regiments_max_possible_from_province(sys::state& state, dcon::province_id p);
 int32_t main_culture_regiments_created_from_province(sys::state& state, dcon::province_id p);
 int32_t main_culture_regiments_max_possible_from_province(sys::state& state, dcon::province_id p);
+int32_t regiments_supported_by_pop(sys::state& state, dcon::pop_id p); // computed from the pop's current size and location
+int32_t main_culture_regiments_supported_by_pop(sys::state& state, dcon::pop_id p); // likewise, as counted toward the main culture totals
 int32_t regiments_under_construction_in_province(sys::state& state, dcon::province_id p);
 int32_t main_culture_regiments_under_construction_in_province(sys::state& state, dcon::province_id p);
 int32_t mobilized_regiments_created_from_province(sys::state& state, dcon::province_id p);
@@ -129,9 +136,24 @@ dcon::pop_id find_available_soldier(sys::state& state, dcon::province_id p, bool
 dcon::regiment_id create_new_regiment(sys::state& state, dcon::nation_id n, dcon::unit_type_id t);
 dcon::ship_id create_new_ship(sys::state& state, dcon::nation_id n, dcon::unit_type_id t);
 
-void update_recruitable_regiments(sys::state& state, dcon::nation_id n);
+// Each pop remembers the regiment capacities and regiment count it last contributed to its province, so that a change is
+// applied as a difference. Call update_pop_regiment_counts after giving a pop a regiment or changing its type,
+// delete regiments through delete_regiment, and call remove_pop_regiment_counts before a pop leaves its province or is deleted
+// (and update_pop_regiment_counts once it has arrived). Changes in size, culture and province status are only picked up by
+// update_pop_regiment_capacity, once a day, so capacities lag those by up to a day.
+void update_pop_regiment_counts(sys::state& state, dcon::pop_id p);
+void remove_pop_regiment_counts(sys::state& state, dcon::pop_id p);
+void delete_regiment(sys::state& state, dcon::regiment_id r);
+void update_pop_regiment_capacity(sys::state& state);
+// rebuilds all of the above from scratch, and sets each nation's recruitable regiments, which are only worked out here, on load
 void update_all_recruitable_regiments(sys::state& state);
 void regenerate_total_regiment_counts(sys::state& state);
+void regenerate_leader_counts(sys::state& state); // per-nation leader and unit counts, and the lists of units without a leader
+
+// call these when a leader, army or navy is created outside of this file, after its owner or controller has been set
+void register_leader(sys::state& state, dcon::leader_id l);
+void register_army(sys::state& state, dcon::army_id a);
+void register_navy(sys::state& state, dcon::navy_id v);
 
 void regenerate_land_unit_average(sys::state& state);
 void regenerate_ship_scores(sys::state& state);
@@ -143,9 +165,12 @@ float mobilization_size(sys::state const& state, dcon::nation_id n);
 float mobilization_impact(sys::state const& state, dcon::nation_id n);
 
 void update_naval_supply_points(sys::state& state); // must run after determining connectivity
-void update_cbs(sys::state& state);
+void update_cbs(sys::state& state, bool in_parallel = true); // in_parallel = false decides each nation in turn (the reference behavior)
 void monthly_leaders_update(sys::state& state);
 void daily_leaders_update(sys::state& state);
+void update_leader_combat_status(sys::state& state);
+dcon::leader_id make_new_leader(sys::state& state, dcon::nation_id n, bool is_general);
+void kill_leaders(sys::state& state, std::vector<dcon::leader_id> const& leaders);
 
 bool cb_conditions_satisfied(sys::state& state, dcon::nation_id actor, dcon::nation_id target, dcon::cb_type_id cb);
 void add_cb(sys::state& state, dcon::nation_id n, dcon::cb_type_id cb, dcon::nation_id target); // do not call this function directly unless you know what you are doing
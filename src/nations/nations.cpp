@@ -363,98 +363,124 @@ float prestige_score(sys::state const& state, dcon::nation_id n) {
 	return state.world.nation_get_prestige(n) + state.world.nation_get_modifier_values(n, sys::national_mod_offsets::permanent_prestige);
 }
 
+namespace ranking {
+
+void radix_sort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch) {
+	if(keys.empty())
+		return;
+	scratch.resize(keys.size());
+	for(uint32_t shift = 0; shift < 64; shift += 8) {
+		uint32_t counts[256] = { 0 };
+		for(auto k : keys)
+			++counts[(k >> shift) & 0xFF];
+		if(counts[(keys[0] >> shift) & 0xFF] == keys.size())
+			continue; // every key has the same digit here, so this pass would not move anything
+
+		uint32_t total = 0;
+		for(auto& c : counts) {
+			auto v = c;
+			c = total;
+			total += v;
+		}
+		for(auto k : keys)
+			scratch[counts[(k >> shift) & 0xFF]++] = k;
+		keys.swap(scratch);
+	}
+}
+
+}
+
+namespace impl {
+
+// whether a previous, null terminated, ranking is still exactly the order of the keys: same nations, strictly ascending keys
+bool ranking_is_current(std::vector<dcon::nation_id> const& order, std::vector<uint64_t> const& keys, uint32_t ranked_count) {
+	uint32_t i = 0;
+	uint64_t last = 0;
+	for(; i < order.size() && order[i]; ++i) {
+		auto k = keys[order[i].index()];
+		if(k == 0 || k <= last)
+			return false;
+		last = k;
+	}
+	return i == ranked_count;
+}
+
+void rank_by_keys(std::vector<dcon::nation_id>& order, std::vector<uint64_t> const& keys) {
+	static std::vector<uint64_t> sorted;
+	static std::vector<uint64_t> scratch;
+	sorted.clear();
+	for(auto k : keys) {
+		if(k != 0)
+			sorted.push_back(k);
+	}
+	auto ranked_count = uint32_t(sorted.size());
+	if(!ranking_is_current(order, keys, ranked_count)) {
+		ranking::radix_sort(sorted, scratch);
+		for(uint32_t i = 0; i < ranked_count; ++i)
+			order[i] = ranking::key_to_nation(sorted[i]);
+		if(ranked_count < order.size())
+			order[ranked_count] = dcon::nation_id{};
+	}
+}
+
+}
+
 void update_rankings(sys::state& state) {
-	uint32_t to_sort_count = 0;
-	state.world.for_each_nation([&](dcon::nation_id n) {
-		state.nations_by_rank[to_sort_count] = n;
-		++to_sort_count;
-	});
-	std::sort(state.nations_by_rank.begin(), state.nations_by_rank.begin() + to_sort_count, [&](dcon::nation_id a, dcon::nation_id b) {
-		auto fa = fatten(state.world, a);
-		auto fb = fatten(state.world, b);
-		if((fa.get_owned_province_count() != 0) != (fb.get_owned_province_count() != 0)) {
-			return (fa.get_owned_province_count() != 0);
-		}
-		if(fa.get_is_civilized() != fb.get_is_civilized())
-			return fa.get_is_civilized();
-		if(bool(fa.get_overlord_as_subject()) != bool(fa.get_overlord_as_subject()))
-			return !bool(fa.get_overlord_as_subject());
-		auto a_score = fa.get_military_score() + fa.get_industrial_score() + prestige_score(state, a);
-		auto b_score = fb.get_military_score() + fb.get_industrial_score() + prestige_score(state, b);
-		if(a_score != b_score)
-			return a_score > b_score;
-		return a.index() > b.index(); // create a total order
+	/*
+	Nations with provinces come first, then civilized nations, and then in order of military + industrial + prestige score.
+	*/
+	static std::vector<uint64_t> keys;
+	keys.assign(state.world.nation_size(), 0);
+
+	state.world.execute_serial_over_nation([&](auto ids) {
+		auto has_provinces = state.world.nation_get_owned_province_count(ids) != 0;
+		auto civilized = state.world.nation_get_is_civilized(ids);
+		auto score = (ve::to_float(state.world.nation_get_military_score(ids)) + ve::to_float(state.world.nation_get_industrial_score(ids)))
+			+ (state.world.nation_get_prestige(ids) + state.world.nation_get_modifier_values(ids, sys::national_mod_offsets::permanent_prestige));
+		ve::apply([&](dcon::nation_id n, bool p, bool c, float v) {
+			if(uint32_t(n.index()) < keys.size() && state.world.nation_is_valid(n))
+				keys[n.index()] = ranking::make_key((p ? 2 : 0) | (c ? 1 : 0), v, n);
+		}, ids, has_provinces, civilized, score);
 	});
-	if(to_sort_count < state.nations_by_rank.size()) {
-		state.nations_by_rank[to_sort_count] = dcon::nation_id{};
-	}
-	for(uint32_t i = 0; i < to_sort_count; ++i) {
+
+	impl::rank_by_keys(state.nations_by_rank, keys);
+
+	for(uint32_t i = 0; i < state.nations_by_rank.size() && state.nations_by_rank[i]; ++i) {
 		state.world.nation_set_rank(state.nations_by_rank[i], uint16_t(i + 1));
 	}
 }
 
 void update_ui_rankings(sys::state& state) {
-	uint32_t to_sort_count = 0;
-	state.world.for_each_nation([&](dcon::nation_id n) {
-		if(state.world.nation_get_owned_province_count(n) != 0) {
-			state.nations_by_industrial_score[to_sort_count] = n;
-			state.nations_by_military_score[to_sort_count] = n;
-			state.nations_by_prestige_score[to_sort_count] = n;
-			++to_sort_count;
-		}
-	});
-	std::sort(state.nations_by_industrial_score.begin(), state.nations_by_industrial_score.begin() + to_sort_count, [&](dcon::nation_id a, dcon::nation_id b) {
-		auto fa = fatten(state.world, a);
-		auto fb = fatten(state.world, b);
-		if(fa.get_is_civilized() && !fb.get_is_civilized())
-			return true;
-		if(!fa.get_is_civilized() && fb.get_is_civilized())
-			return false;
-		if(bool(fa.get_overlord_as_subject()) && !bool(fa.get_overlord_as_subject()))
-			return false;
-		if(!bool(fa.get_overlord_as_subject()) && bool(fa.get_overlord_as_subject()))
-			return true;
-		auto a_score = fa.get_industrial_score();
-		auto b_score = fb.get_industrial_score();
-		if(a_score != b_score)
-			return a_score > b_score;
-		return a.index() > b.index();
-	});
-	std::sort(state.nations_by_military_score.begin(), state.nations_by_military_score.begin() + to_sort_count, [&](dcon::nation_id a, dcon::nation_id b) {
-		auto fa = fatten(state.world, a);
-		auto fb = fatten(state.world, b);
-		if(fa.get_is_civilized() && !fb.get_is_civilized())
-			return true;
-		if(!fa.get_is_civilized() && fb.get_is_civilized())
-			return false;
-		if(bool(fa.get_overlord_as_subject()) && !bool(fa.get_overlord_as_subject()))
-			return false;
-		if(!bool(fa.get_overlord_as_subject()) && bool(fa.get_overlord_as_subject()))
-			return true;
-		auto a_score = fa.get_military_score();
-		auto b_score = fb.get_military_score();
-		if(a_score != b_score)
-			return a_score > b_score;
-		return a.index() > b.index();
-	});
-	std::sort(state.nations_by_prestige_score.begin(), state.nations_by_prestige_score.begin() + to_sort_count, [&](dcon::nation_id a, dcon::nation_id b) {
-		auto fa = fatten(state.world, a);
-		auto fb = fatten(state.world, b);
-		if(fa.get_is_civilized() && !fb.get_is_civilized())
-			return true;
-		if(!fa.get_is_civilized() && fb.get_is_civilized())
-			return false;
-		if(bool(fa.get_overlord_as_subject()) && !bool(fa.get_overlord_as_subject()))
-			return false;
-		if(!bool(fa.get_overlord_as_subject()) && bool(fa.get_overlord_as_subject()))
-			return true;
-		auto a_score = prestige_score(state, a);
-		auto b_score = prestige_score(state, b);
-		if(a_score != b_score)
-			return a_score > b_score;
-		return a.index() > b.index();
+	/*
+	Only nations with provinces are ranked, civilized nations first, and then in order of the score.
+	*/
+	static std::vector<uint64_t> industrial_keys;
+	static std::vector<uint64_t> military_keys;
+	static std::vector<uint64_t> prestige_keys;
+	industrial_keys.assign(state.world.nation_size(), 0);
+	military_keys.assign(state.world.nation_size(), 0);
+	prestige_keys.assign(state.world.nation_size(), 0);
+
+	state.world.execute_serial_over_nation([&](auto ids) {
+		auto has_provinces = state.world.nation_get_owned_province_count(ids) != 0;
+		auto civilized = state.world.nation_get_is_civilized(ids);
+		auto industrial = ve::to_float(state.world.nation_get_industrial_score(ids));
+		auto military = ve::to_float(state.world.nation_get_military_score(ids));
+		auto prestige = state.world.nation_get_prestige(ids) + state.world.nation_get_modifier_values(ids, sys::national_mod_offsets::permanent_prestige);
+		ve::apply([&](dcon::nation_id n, bool p, bool c, float i, float m, float v) {
+			if(p && uint32_t(n.index()) < industrial_keys.size() && state.world.nation_is_valid(n)) {
+				industrial_keys[n.index()] = ranking::make_key(c ? 1 : 0, i, n);
+				military_keys[n.index()] = ranking::make_key(c ? 1 : 0, m, n);
+				prestige_keys[n.index()] = ranking::make_key(c ? 1 : 0, v, n);
+			}
+		}, ids, has_provinces, civilized, industrial, military, prestige);
 	});
-	for(uint32_t i = 0; i < to_sort_count; ++i) {
+
+	impl::rank_by_keys(state.nations_by_industrial_score, industrial_keys);
+	impl::rank_by_keys(state.nations_by_military_score, military_keys);
+	impl::rank_by_keys(state.nations_by_prestige_score, prestige_keys);
+
+	for(uint32_t i = 0; i < state.nations_by_industrial_score.size() && state.nations_by_industrial_score[i]; ++i) {
 		state.world.nation_set_industrial_rank(state.nations_by_industrial_score[i], uint16_t(i + 1));
 		state.world.nation_set_military_rank(state.nations_by_military_score[i], uint16_t(i + 1));
 		state.world.nation_set_prestige_rank(state.nations_by_prestige_score[i], uint16_t(i + 1));
@@ -866,38 +892,98 @@ void update_monthly_points(sys::state& state) {
 	- Monthly relations adjustment = +0.25 for subjects/overlords, -0.01 for being at war, +0.05 if adjacent and both are at peace, +0.025 for having military access, -0.15 for being able to use a CB against each other (-0.30 if it goes both ways)
 	- Once relations are at 100, monthly increases cannot take them higher
 	*/
-	for(auto so : state.world.in_overlord) {
-		monthly_adjust_relationship(state, so.get_ruler(), so.get_subject(), 0.25f);
-	}
-	for(auto an : state.world.in_nation_adjacency) {
-		if(an.get_connected_nations(0).get_is_at_war() == false && an.get_connected_nations(1).get_is_at_war() == false)
-			monthly_adjust_relationship(state, an.get_connected_nations(0), an.get_connected_nations(1), 0.05f);
-		if(military::can_use_cb_against(state, an.get_connected_nations(0), an.get_connected_nations(1))) {
-			monthly_adjust_relationship(state, an.get_connected_nations(0), an.get_connected_nations(1), -0.15f);
-		}
-		if(military::can_use_cb_against(state, an.get_connected_nations(1), an.get_connected_nations(0))) {
-			monthly_adjust_relationship(state, an.get_connected_nations(0), an.get_connected_nations(1), -0.15f);
-		}
-	}
-	for(auto i : state.world.in_unilateral_relationship) {
-		if(i.get_military_access()) {
-			monthly_adjust_relationship(state, i.get_source(), i.get_target(), 0.025f);
+	/*
+	Each source of relation changes gets its own range of a flat buffer of contributions, which is filled in parallel (the
+	cb checks between neighbors are the expensive part). The contributions are then summed by pair and applied once each.
+	*/
+	static std::vector<relation_delta> deltas;
+	static std::vector<uint32_t> war_offsets;
+
+	uint32_t const overlord_start = 0;
+	uint32_t const adjacency_start = overlord_start + state.world.overlord_size();
+	uint32_t const unilateral_start = adjacency_start + state.world.nation_adjacency_size();
+	uint32_t const war_start = unilateral_start + state.world.unilateral_relationship_size();
+
+	war_offsets.resize(state.world.war_size() + 1);
+	war_offsets[0] = war_start;
+	for(uint32_t i = 0; i < state.world.war_size(); ++i) {
+		dcon::war_id w{ dcon::war_id::value_base_t(i) };
+		uint32_t attackers = 0;
+		uint32_t defenders = 0;
+		if(state.world.war_is_valid(w)) {
+			for(auto p : state.world.war_get_war_participant(w)) {
+				if(p.get_is_attacker())
+					++attackers;
+				else
+					++defenders;
+			}
 		}
+		war_offsets[i + 1] = war_offsets[i] + attackers * defenders;
 	}
-	for(auto w : state.world.in_war) {
-		for(auto n : w.get_war_participant()) {
-			for(auto m : w.get_war_participant()) {
-				if(n.get_is_attacker() != m.get_is_attacker()) {
-					monthly_adjust_relationship(state, n.get_nation(), m.get_nation(), -0.005f);
+
+	deltas.clear();
+	deltas.resize(war_offsets.back());
+
+	concurrency::parallel_for(uint32_t(0), state.world.overlord_size(), [&](uint32_t i) {
+		dcon::overlord_id so{ dcon::overlord_id::value_base_t(i) };
+		if(state.world.overlord_is_valid(so))
+			deltas[overlord_start + i] = make_relation_delta(state.world.overlord_get_ruler(so), state.world.overlord_get_subject(so), 0.25f);
+	});
+	concurrency::parallel_for(uint32_t(0), state.world.nation_adjacency_size(), [&](uint32_t i) {
+		dcon::nation_adjacency_id an{ dcon::nation_adjacency_id::value_base_t(i) };
+		if(!state.world.nation_adjacency_is_valid(an))
+			return;
+		auto a = state.world.nation_adjacency_get_connected_nations(an, 0);
+		auto b = state.world.nation_adjacency_get_connected_nations(an, 1);
+		float delta = 0.0f;
+		bool changed = false;
+		if(state.world.nation_get_is_at_war(a) == false && state.world.nation_get_is_at_war(b) == false) {
+			delta += 0.05f;
+			changed = true;
+		}
+		if(military::can_use_cb_against(state, a, b)) {
+			delta += -0.15f;
+			changed = true;
+		}
+		if(military::can_use_cb_against(state, b, a)) {
+			delta += -0.15f;
+			changed = true;
+		}
+		if(changed)
+			deltas[adjacency_start + i] = make_relation_delta(a, b, delta);
+	});
+	concurrency::parallel_for(uint32_t(0), state.world.unilateral_relationship_size(), [&](uint32_t i) {
+		dcon::unilateral_relationship_id ur{ dcon::unilateral_relationship_id::value_base_t(i) };
+		if(state.world.unilateral_relationship_is_valid(ur) && state.world.unilateral_relationship_get_military_access(ur))
+			deltas[unilateral_start + i] = make_relation_delta(state.world.unilateral_relationship_get_source(ur), state.world.unilateral_relationship_get_target(ur), 0.025f);
+	});
+	concurrency::parallel_for(uint32_t(0), state.world.war_size(), [&](uint32_t i) {
+		dcon::war_id w{ dcon::war_id::value_base_t(i) };
+		if(war_offsets[i] == war_offsets[i + 1])
+			return;
+		auto out = war_offsets[i];
+		for(auto n : state.world.war_get_war_participant(w)) {
+			if(!n.get_is_attacker())
+				continue;
+			for(auto m : state.world.war_get_war_participant(w)) {
+				if(!m.get_is_attacker()) {
+					// -0.005 from each side of the pair
+					deltas[out] = make_relation_delta(n.get_nation(), m.get_nation(), -0.01f);
+					++out;
 				}
 			}
 		}
-	}
+	});
+
+	apply_relation_deltas(state, deltas);
 
 	/*
 	- revanchism: you get one point per unowned core if your primary culture is the dominant culture (culture with the most population) in the province, 0.25 points if it is not the dominant culture, and then that total is divided by the total number of your cores to get your revanchism percentage
 	*/
-	for(auto n : state.world.in_nation) {
+	concurrency::parallel_for(uint32_t(0), state.world.nation_size(), [&](uint32_t i) {
+		auto n = fatten(state.world, dcon::nation_id{ dcon::nation_id::value_base_t(i) });
+		if(!n.is_valid())
+			return;
 		auto owned = n.get_province_ownership();
 		if(owned.begin() != owned.end()) {
 			auto pc = n.get_primary_culture();
@@ -918,6 +1004,23 @@ void update_monthly_points(sys::state& state) {
 				n.set_revanchism(0.0f);
 			}
 		}
+	});
+}
+
+void apply_relation_deltas(sys::state& state, std::vector<relation_delta>& deltas) {
+	// stable, so that the contributions to a pair are always summed in the same order
+	std::stable_sort(deltas.begin(), deltas.end(), [](relation_delta const& a, relation_delta const& b) { return a.pair < b.pair; });
+
+	size_t i = 0;
+	while(i < deltas.size() && deltas[i].pair != relation_delta::none) {
+		auto pair = deltas[i].pair;
+		float total = 0.0f;
+		for(; i < deltas.size() && deltas[i].pair == pair; ++i) {
+			total += deltas[i].delta;
+		}
+		dcon::nation_id a{ dcon::nation_id::value_base_t(pair >> 32) };
+		dcon::nation_id b{ dcon::nation_id::value_base_t(pair & 0xFFFFFFFF) };
+		monthly_adjust_relationship(state, a, b, total);
 	}
 }
 
@@ -981,6 +1084,7 @@ void create_nation_based_on_template(sys::state& state, dcon::nation_id n, dcon:
 	state.world.for_each_invention([&](dcon::invention_id t) {
 		state.world.nation_set_active_inventions(n, t, state.world.nation_get_active_inventions(base, t));
 	});
+	state.invention_candidates.update_nation(state, n);
 	state.world.for_each_issue([&](dcon::issue_id t) {
 		state.world.nation_set_issues(n, t, state.world.nation_get_issues(base, t));
 	});
@@ -1216,28 +1320,52 @@ void update_influence(sys::state& state) {
 		}
 	}
 
+	/*
+	The influence gain of every relationship is computed in passes over the whole gp_relationship table: first the shares and the
+	factors that depend on looking up the pair of nations, then the neighbour bits from one walk over the nation adjacencies, and
+	then the remaining factors as a vector pass. Only applying the gains, which may spill over into the influence of other great
+	powers, is done serially, in the same order as before.
+	*/
+	state.world.execute_serial_over_gp_relationship([&](auto ids) {
+		state.world.gp_relationship_set_influence_shares(ids, ve::fp_vector{});
+		state.world.gp_relationship_set_pair_influence_factor(ids, ve::fp_vector{});
+		state.world.gp_relationship_set_target_is_adjacent(ids, ve::mask_vector(false));
+		state.world.gp_relationship_set_sphere_is_adjacent(ids, ve::mask_vector(false));
+	});
+
+	static std::vector<float> total_foreign_investment;
+	total_foreign_investment.assign(state.world.nation_size(), 0.0f);
+	for(auto ur : state.world.in_unilateral_relationship) {
+		if(auto t = ur.get_target(); t)
+			total_foreign_investment[t.id.index()] += ur.get_foreign_investment();
+	}
+
 	for(auto& grn : state.great_nations) {
 		dcon::nation_fat_id n = fatten(state.world, grn.nation);
 		if(!is_great_power(state, n))
 			continue; // skip
 
+		auto share_count = [](uint8_t status) {
+			switch(status & influence::priority_mask) {
+				case influence::priority_one:
+					return 1;
+				case influence::priority_two:
+					return 2;
+				case influence::priority_three:
+					return 3;
+				default:
+				case influence::priority_zero:
+					return 0;
+			}
+		};
+
 		int32_t total_influence_shares = 0;
 		for(auto rel : n.get_gp_relationship_as_great_power()) {
 			if(can_accumulate_influence_with(state, n, rel.get_influence_target(), rel)) {
-				switch(rel.get_status() & influence::priority_mask) {
-					case influence::priority_one:
-						total_influence_shares += 1;
-						break;
-					case influence::priority_two:
-						total_influence_shares += 2;
-						break;
-					case influence::priority_three:
-						total_influence_shares += 3;
-						break;
-					default:
-					case influence::priority_zero:
-						break;
-				}
+				auto shares = share_count(rel.get_status());
+				total_influence_shares += shares;
+				// marks the relationship as accumulating; the actual share is filled in below
+				rel.set_influence_shares(float(shares));
 			}
 		}
 
@@ -1247,86 +1375,114 @@ void update_influence(sys::state& state) {
 			*/
 			float total_gain = state.defines.base_greatpower_daily_influence * (1.0f + n.get_modifier_values(sys::national_mod_offsets::influence_modifier))* (1.0f + n.get_modifier_values(sys::national_mod_offsets::influence));
 
-			/*
-			This influence value does not translate directly into influence with the target nation. Instead it is first multiplied by the following factor:
-			1 + define:DISCREDIT_INFLUENCE_GAIN_FACTOR (if discredited) + define:NEIGHBOUR_BONUS_INFLUENCE_PERCENT (if the nations are adjacent) + define:SPHERE_NEIGHBOUR_BONUS_INFLUENCE_PERCENT (if some member of the influencing nation's sphere is adjacent but not the influencing nation itself) + define:OTHER_CONTINENT_BONUS_INFLUENCE_PERCENT (if the influencing nation and the target have capitals on different continents) + define:PUPPET_BONUS_INFLUENCE_PERCENT (if the target is a vassal of the influencer) + relation-value / define:RELATION_INFLUENCE_MODIFIER + define:INVESTMENT_INFLUENCE_DEFENCE x fraction-of-influencer's-foreign-investment-out-of-total-foreign-investment + define:LARGE_POPULATION_INFLUENCE_PENALTY x target-population / define:LARGE_POPULATION_INFLUENCE_PENALTY_CHUNK (if the target nation has population greater than define:LARGE_POPULATION_LIMIT) + (1 - target-score / influencer-score)^0
-			*/
+			for(auto rel : n.get_gp_relationship_as_great_power()) {
+				if(rel.get_influence_shares() <= 0.0f)
+					continue; // skip calculations for priority zero nations
+
+				rel.set_influence_shares(rel.get_influence_shares() * total_gain / float(total_influence_shares));
 
-			float gp_score = n.get_industrial_score() + n.get_military_score() + prestige_score(state, n);
+				auto target = rel.get_influence_target();
+				auto gp_invest = state.world.unilateral_relationship_get_foreign_investment(state.world.get_unilateral_relationship_by_unilateral_pair(target, n));
+				auto total_fi = total_foreign_investment[target.id.index()];
 
+				float discredit_factor = (rel.get_status() & influence::is_discredited) != 0 ? state.defines.discredit_influence_gain_factor : 0.0f;
+				float relationship_factor = state.world.diplomatic_relation_get_value(state.world.get_diplomatic_relation_by_diplomatic_pair(n, target)) / state.defines.relation_influence_modifier;
+				float investment_factor = total_fi > 0.0f ? state.defines.investment_influence_defense * gp_invest / total_fi : 0.0f;
+
+				rel.set_pair_influence_factor(discredit_factor + relationship_factor + investment_factor);
+			}
+		} else {
 			for(auto rel : n.get_gp_relationship_as_great_power()) {
-				if(can_accumulate_influence_with(state, n, rel.get_influence_target(), rel)) {
-					float base_shares = [&]() {
-						switch(rel.get_status() & influence::priority_mask) {
-							case influence::priority_one:
-								return total_gain / float(total_influence_shares);
-							case influence::priority_two:
-								return 2.0f * total_gain / float(total_influence_shares);
-							case influence::priority_three:
-								return 3.0f * total_gain / float(total_influence_shares);
-							default:
-							case influence::priority_zero:
-								return 0.0f;
-						}
-					}();
+				rel.set_influence_shares(0.0f);
+			}
+		}
+	}
 
-					if(base_shares <= 0.0f)
-						continue; // skip calculations for priority zero nations
+	// adjacency to the target, and adjacency of a sphere member to the target
+	for(auto adj : state.world.in_nation_adjacency) {
+		auto a = adj.get_connected_nations(0);
+		auto b = adj.get_connected_nations(1);
+		if(a == b)
+			continue;
+		if(auto rel = state.world.get_gp_relationship_by_gp_influence_pair(b, a); rel)
+			state.world.gp_relationship_set_target_is_adjacent(rel, true);
+		if(auto rel = state.world.get_gp_relationship_by_gp_influence_pair(a, b); rel)
+			state.world.gp_relationship_set_target_is_adjacent(rel, true);
+		if(auto sa = a.get_in_sphere_of(); sa) {
+			if(auto rel = state.world.get_gp_relationship_by_gp_influence_pair(b, sa); rel)
+				state.world.gp_relationship_set_sphere_is_adjacent(rel, true);
+		}
+		if(auto sb = b.get_in_sphere_of(); sb) {
+			if(auto rel = state.world.get_gp_relationship_by_gp_influence_pair(a, sb); rel)
+				state.world.gp_relationship_set_sphere_is_adjacent(rel, true);
+		}
+	}
 
-					bool has_sphere_neighbor = [&]() {
-						for(auto g : rel.get_influence_target().get_nation_adjacency()) {
-							if(g.get_connected_nations(0) != rel.get_influence_target() && g.get_connected_nations(0).get_in_sphere_of() == n)
-								return true;
-							if(g.get_connected_nations(1) != rel.get_influence_target() && g.get_connected_nations(1).get_in_sphere_of() == n)
-								return true;
-						}
-						return false;
-					}();
+	/*
+	This influence value does not translate directly into influence with the target nation. Instead it is first multiplied by the following factor:
+	1 + define:DISCREDIT_INFLUENCE_GAIN_FACTOR (if discredited) + define:NEIGHBOUR_BONUS_INFLUENCE_PERCENT (if the nations are adjacent) + define:SPHERE_NEIGHBOUR_BONUS_INFLUENCE_PERCENT (if some member of the influencing nation's sphere is adjacent but not the influencing nation itself) + define:OTHER_CONTINENT_BONUS_INFLUENCE_PERCENT (if the influencing nation and the target have capitals on different continents) + define:PUPPET_BONUS_INFLUENCE_PERCENT (if the target is a vassal of the influencer) + relation-value / define:RELATION_INFLUENCE_MODIFIER + define:INVESTMENT_INFLUENCE_DEFENCE x fraction-of-influencer's-foreign-investment-out-of-total-foreign-investment + define:LARGE_POPULATION_INFLUENCE_PENALTY x target-population / define:LARGE_POPULATION_INFLUENCE_PENALTY_CHUNK (if the target nation has population greater than define:LARGE_POPULATION_LIMIT) + (1 - target-score / influencer-score)^0
+	*/
+	state.world.execute_serial_over_gp_relationship([&](auto ids) {
+		auto shares = state.world.gp_relationship_get_influence_shares(ids);
+		if(ve::compress_mask(shares > 0.0f).v == 0) {
+			state.world.gp_relationship_set_influence_gain(ids, ve::fp_vector{});
+			return;
+		}
 
-					float total_fi = 0.0f;
-					for(auto i : rel.get_influence_target().get_unilateral_relationship_as_target()) {
-						total_fi += i.get_foreign_investment();
-					}
-					auto gp_invest = state.world.unilateral_relationship_get_foreign_investment(state.world.get_unilateral_relationship_by_unilateral_pair(rel.get_influence_target(), n));
-
-					float discredit_factor = (rel.get_status() & influence::is_discredited) != 0 ? state.defines.discredit_influence_gain_factor : 0.0f;
-					float neighbor_factor = bool(state.world.get_nation_adjacency_by_nation_adjacency_pair(n, rel.get_influence_target())) ? state.defines.neighbour_bonus_influence_percent : 0.0f;
-					float sphere_neighbor_factor = has_sphere_neighbor ? state.defines.sphere_neighbour_bonus_influence_percent : 0.0f;
-					float continent_factor = n.get_capital().get_continent() != rel.get_influence_target().get_capital().get_continent() ? state.defines.other_continent_bonus_influence_percent : 0.0f;
-					float puppet_factor = rel.get_influence_target().get_overlord_as_subject().get_ruler() == n ? state.defines.puppet_bonus_influence_percent : 0.0f;
-					float relationship_factor = state.world.diplomatic_relation_get_value(state.world.get_diplomatic_relation_by_diplomatic_pair(n, rel.get_influence_target())) / state.defines.relation_influence_modifier;
-					float investment_factor = total_fi > 0.0f ? state.defines.investment_influence_defense * gp_invest / total_fi : 0.0f;
-					float pop_factor = rel.get_influence_target().get_demographics(demographics::total) > state.defines.large_population_limit ? state.defines.large_population_influence_penalty * rel.get_influence_target().get_demographics(demographics::total) / state.defines.large_population_influence_penalty_chunk : 0.0f;
-					float score_factor = gp_score > 0.0f ? std::max(1.0f - (rel.get_influence_target().get_industrial_score() + rel.get_influence_target().get_military_score() + prestige_score(state, rel.get_influence_target())) / gp_score, 0.0f) : 0.0f;
-
-					float total_multiplier = 1.0f + discredit_factor + neighbor_factor + sphere_neighbor_factor + continent_factor + puppet_factor + relationship_factor + investment_factor + pop_factor + score_factor;
-
-					auto gain_amount = base_shares * total_multiplier;
-
-					/*
-					Any influence that accumulates beyond the max (define:MAX_INFLUENCE) will be subtracted from the influence of the great power with the most influence (other than the influencing nation).
-					*/
-
-					rel.get_influence() += gain_amount;
-					if(rel.get_influence() > state.defines.max_influence) {
-						auto overflow = rel.get_influence() - state.defines.max_influence;
-						rel.get_influence() = state.defines.max_influence;
-
-						dcon::gp_relationship_id other_rel;
-						for(auto orel : rel.get_influence_target().get_gp_relationship_as_influence_target()) {
-							if(orel != rel) {
-								if(orel.get_influence() > state.world.gp_relationship_get_influence(other_rel)) {
-									other_rel = orel;
-								}
-							}
-						}
+		auto gp = state.world.gp_relationship_get_great_power(ids);
+		auto target = state.world.gp_relationship_get_influence_target(ids);
+
+		auto neighbor_factor = ve::select(state.world.gp_relationship_get_target_is_adjacent(ids), ve::fp_vector{ state.defines.neighbour_bonus_influence_percent }, 0.0f);
+		auto sphere_neighbor_factor = ve::select(state.world.gp_relationship_get_sphere_is_adjacent(ids), ve::fp_vector{ state.defines.sphere_neighbour_bonus_influence_percent }, 0.0f);
+		auto continent_factor = ve::select(state.world.province_get_continent(state.world.nation_get_capital(gp)) != state.world.province_get_continent(state.world.nation_get_capital(target)), ve::fp_vector{ state.defines.other_continent_bonus_influence_percent }, 0.0f);
+		auto puppet_factor = ve::select(state.world.overlord_get_ruler(state.world.nation_get_overlord_as_subject(target)) == gp, ve::fp_vector{ state.defines.puppet_bonus_influence_percent }, 0.0f);
+		auto target_pop = state.world.nation_get_demographics(target, demographics::total);
+		auto pop_factor = ve::select(target_pop > state.defines.large_population_limit, state.defines.large_population_influence_penalty * target_pop / state.defines.large_population_influence_penalty_chunk, 0.0f);
+
+		auto score = [&](dcon::nation_id n) {
+			return float(state.world.nation_get_industrial_score(n)) + float(state.world.nation_get_military_score(n)) + prestige_score(state, n);
+		};
+		auto gp_score = ve::apply(score, gp);
+		auto target_score = ve::apply(score, target);
+		auto score_factor = ve::select(gp_score > 0.0f, ve::max(1.0f - target_score / gp_score, 0.0f), 0.0f);
+
+		auto total_multiplier = 1.0f + state.world.gp_relationship_get_pair_influence_factor(ids) + (neighbor_factor + sphere_neighbor_factor) + (continent_factor + puppet_factor) + (pop_factor + score_factor);
 
-						if(other_rel) {
-							auto& orl_i = state.world.gp_relationship_get_influence(other_rel);
-							orl_i = std::max(0.0f, orl_i - overflow);
+		state.world.gp_relationship_set_influence_gain(ids, ve::select(shares > 0.0f, shares * total_multiplier, 0.0f));
+	});
+
+	for(auto& grn : state.great_nations) {
+		dcon::nation_fat_id n = fatten(state.world, grn.nation);
+		if(!is_great_power(state, n))
+			continue; // skip
+
+		for(auto rel : n.get_gp_relationship_as_great_power()) {
+			auto gain_amount = rel.get_influence_gain();
+			if(gain_amount == 0.0f)
+				continue;
+
+			/*
+			Any influence that accumulates beyond the max (define:MAX_INFLUENCE) will be subtracted from the influence of the great power with the most influence (other than the influencing nation).
+			*/
+
+			rel.get_influence() += gain_amount;
+			if(rel.get_influence() > state.defines.max_influence) {
+				auto overflow = rel.get_influence() - state.defines.max_influence;
+				rel.get_influence() = state.defines.max_influence;
+
+				dcon::gp_relationship_id other_rel;
+				for(auto orel : rel.get_influence_target().get_gp_relationship_as_influence_target()) {
+					if(orel != rel) {
+						if(orel.get_influence() > state.world.gp_relationship_get_influence(other_rel)) {
+							other_rel = orel;
 						}
 					}
 				}
+
+				if(other_rel) {
+					auto& orl_i = state.world.gp_relationship_get_influence(other_rel);
+					orl_i = std::max(0.0f, orl_i - overflow);
+				}
 			}
 		}
 	}
@@ -1366,7 +1522,12 @@ void monthly_flashpoint_update(sys::state& state) {
 	/*
 	Whether a state contains a flashpoint depends on: whether a province in the state contains a core other than that of its owner and of a tag that is marked as releasable (i.e. not a cultural union core), and which has a primary culture that is not the primary culture or an accepted culture of its owner. If any core qualifies, the state is considered to be a flashpoint, and its default flashpoint tag will be the qualifying core whose culture has the greatest population in the state.
 	*/
-	for(auto si : state.world.in_state_instance) {
+	// the states are independent of each other; only removing a lapsed focus touches a relationship, so that is left for afterwards
+	std::vector<uint8_t> lapsed_focus(state.world.state_instance_size(), uint8_t(0));
+	concurrency::parallel_for(uint32_t(0), state.world.state_instance_size(), [&](uint32_t i) {
+		auto si = fatten(state.world, dcon::state_instance_id{ dcon::state_instance_id::value_base_t(i) });
+		if(!si.is_valid())
+			return;
 		[&]() {
 			auto owner = si.get_nation_from_state_ownership();
 			auto owner_tag = owner.get_identity_from_identity_holder();
@@ -1382,7 +1543,7 @@ void monthly_flashpoint_update(sys::state& state) {
 					return; // done, skip remainder
 				} else {
 					// remove focus
-					si.set_nation_from_flashpoint_focus(dcon::nation_id{});
+					lapsed_focus[i] = uint8_t(1);
 				}
 			}
 
@@ -1403,6 +1564,10 @@ void monthly_flashpoint_update(sys::state& state) {
 
 			si.set_flashpoint_tag(qualifying_tag);
 		}();
+	});
+	for(uint32_t i = 0; i < lapsed_focus.size(); ++i) {
+		if(lapsed_focus[i])
+			state.world.state_instance_set_nation_from_flashpoint_focus(dcon::state_instance_id{ dcon::state_instance_id::value_base_t(i) }, dcon::nation_id{});
 	}
 
 	// set which nations contain such states
@@ -1437,87 +1602,89 @@ void monthly_flashpoint_update(sys::state& state) {
 }
 
 void daily_update_flashpoint_tension(sys::state& state) {
-	for(auto si : state.world.in_state_instance) {
-		if(si.get_flashpoint_tag()) {
-			float total_increase = 0.0f;
-			/*
-			- If at least one nation has a CB on the owner of a flashpoint state, the tension increases by define:TENSION_FROM_CB per day.
-			*/
-			if(si.get_nation_from_state_ownership().get_is_target_of_some_cb()) {
-				total_increase += state.defines.tension_from_cb;
-			}
-			/*
-			- If there is an independence movement within the nation owning the state for the independence tag, the tension will increase by movement-radicalism x define:TENSION_FROM_MOVEMENT x fraction-of-population-in-state-with-same-culture-as-independence-tag x movement-support / 4000, up to a maximum of define:TENSION_FROM_MOVEMENT_MAX per day.
-			*/
-			auto mov = rebel::get_movement_by_independence(state, si.get_nation_from_state_ownership(), si.get_flashpoint_tag());
-			if(mov) {
-				auto radicalism = state.world.movement_get_radicalism(mov);
-				auto support = state.world.movement_get_pop_support(mov);
-				auto state_pop = si.get_demographics(demographics::total);
-				auto pop_of_culture = si.get_demographics(demographics::to_key(state, si.get_flashpoint_tag().get_primary_culture()));
-				if(state_pop > 0) {
-					total_increase += std::min(state.defines.tension_from_movement_max, state.defines.tension_from_movement * radicalism * pop_of_culture * support / state_pop);
-				}
-			}
+	rebel::update_flashpoint_movements(state);
 
-			/*
-			- Any flashpoint focus increases the tension by the amount listed in it per day.
-			*/
-			if(si.get_nation_from_flashpoint_focus()) {
-				total_increase += state.national_definitions.flashpoint_amount;
-			}
+	/*
+	- Tension increases by define:TENSION_DECAY per day (this is negative, so this is actually a daily decrease).
+	- Tension increased by define:TENSION_WHILE_CRISIS per day while a crisis is ongoing.
+	*/
+	float const base_increase = state.defines.tension_decay + (state.current_crisis != sys::crisis_type::none ? state.defines.tension_while_crisis : 0.0f);
+
+	float const rank_amounts[8] = {
+		state.defines.rank_1_tension_decay,
+		state.defines.rank_2_tension_decay,
+		state.defines.rank_3_tension_decay,
+		state.defines.rank_4_tension_decay,
+		state.defines.rank_5_tension_decay,
+		state.defines.rank_6_tension_decay,
+		state.defines.rank_7_tension_decay,
+		state.defines.rank_8_tension_decay };
+	auto const ranked_gps = uint16_t(std::min(int32_t(state.defines.great_nations_count), 8));
+
+	// the continents with a great power at war or disarmed on them
+	std::vector<dcon::modifier_id> troubled_continents;
+	for(auto& gp : state.great_nations) {
+		if(state.world.nation_get_is_at_war(gp.nation) || (state.world.nation_get_disarmed_until(gp.nation) && state.current_date <= state.world.nation_get_disarmed_until(gp.nation))) {
+			troubled_continents.push_back(state.world.province_get_continent(state.world.nation_get_capital(gp.nation)));
+		}
+	}
 
-			/*
-			- Tension increases by define:TENSION_DECAY per day (this is negative, so this is actually a daily decrease).
-			*/
-			total_increase += state.defines.tension_decay;
+	state.world.execute_serial_over_state_instance([&](auto ids) {
+		auto tag = state.world.state_instance_get_flashpoint_tag(ids);
+		auto owner = state.world.state_instance_get_nation_from_state_ownership(ids);
 
-			/*
-			- Tension increased by define:TENSION_WHILE_CRISIS per day while a crisis is ongoing.
-			*/
-			if(state.current_crisis != sys::crisis_type::none) {
-				total_increase += state.defines.tension_while_crisis;
-			}
+		/*
+		- If at least one nation has a CB on the owner of a flashpoint state, the tension increases by define:TENSION_FROM_CB per day.
+		*/
+		auto total_increase = ve::select(state.world.nation_get_is_target_of_some_cb(owner), ve::fp_vector{ base_increase + state.defines.tension_from_cb }, base_increase);
 
-			/*
-			- If the state is owned by a great power, tension is increased by define:RANK_X_TENSION_DECAY per day
-			*/
-			if(auto rank = si.get_nation_from_state_ownership().get_rank(); uint16_t(1) <= rank && rank <= uint16_t(int32_t(state.defines.great_nations_count))) {
-				static float rank_amounts[8] = {
-					state.defines.rank_1_tension_decay,
-					state.defines.rank_2_tension_decay,
-					state.defines.rank_3_tension_decay,
-					state.defines.rank_4_tension_decay,
-					state.defines.rank_5_tension_decay,
-					state.defines.rank_6_tension_decay,
-					state.defines.rank_7_tension_decay,
-					state.defines.rank_8_tension_decay };
-
-				total_increase += rank_amounts[rank - 1];
-			}
+		/*
+		- If there is an independence movement within the nation owning the state for the independence tag, the tension will increase by movement-radicalism x define:TENSION_FROM_MOVEMENT x fraction-of-population-in-state-with-same-culture-as-independence-tag x movement-support / 4000, up to a maximum of define:TENSION_FROM_MOVEMENT_MAX per day.
+		*/
+		auto mov = state.world.state_instance_get_flashpoint_movement(ids);
+		auto radicalism = state.world.movement_get_radicalism(mov);
+		auto support = state.world.movement_get_pop_support(mov);
+		auto state_pop = state.world.state_instance_get_demographics(ids, demographics::total);
+		auto pop_of_culture = ve::apply([&](dcon::state_instance_id s, dcon::movement_id m, dcon::national_identity_id t) {
+			return m ? state.world.state_instance_get_demographics(s, demographics::to_key(state, state.world.national_identity_get_primary_culture(t))) : 0.0f;
+		}, ids, mov, tag);
+		total_increase = total_increase + ve::select(state_pop > 0.0f,
+			ve::min(state.defines.tension_from_movement_max, state.defines.tension_from_movement * radicalism * pop_of_culture * support / state_pop),
+			0.0f);
 
-			/*
-			- For each great power at war or disarmed on the same continent as either the owner or the state, tension is increased by define:AT_WAR_TENSION_DECAY per day.
-			*/
-			for(auto& gp : state.great_nations) {
-				if(state.world.nation_get_is_at_war(gp.nation) || (state.world.nation_get_disarmed_until(gp.nation) && state.current_date <= state.world.nation_get_disarmed_until(gp.nation))) {
-					auto continent = state.world.province_get_continent(state.world.nation_get_capital(gp.nation));
-					if(si.get_capital().get_continent() == continent || si.get_nation_from_state_ownership().get_capital().get_continent() == continent) {
-						total_increase += state.defines.at_war_tension_decay;
+		/*
+		- Any flashpoint focus increases the tension by the amount listed in it per day.
+		*/
+		total_increase = total_increase + ve::select(state.world.state_instance_get_nation_from_flashpoint_focus(ids) != dcon::nation_id{}, ve::fp_vector{ state.national_definitions.flashpoint_amount }, 0.0f);
+
+		/*
+		- If the state is owned by a great power, tension is increased by define:RANK_X_TENSION_DECAY per day
+		- For each great power at war or disarmed on the same continent as either the owner or the state, tension is increased by define:AT_WAR_TENSION_DECAY per day.
+		*/
+		total_increase = total_increase + ve::apply([&](dcon::state_instance_id s, dcon::nation_id o) {
+			float amount = 0.0f;
+			if(auto rank = state.world.nation_get_rank(o); uint16_t(1) <= rank && rank <= ranked_gps) {
+				amount += rank_amounts[rank - 1];
+			}
+			if(!troubled_continents.empty()) {
+				auto state_continent = state.world.province_get_continent(state.world.state_instance_get_capital(s));
+				auto owner_continent = state.world.province_get_continent(state.world.nation_get_capital(o));
+				for(auto c : troubled_continents) {
+					if(c == state_continent || c == owner_continent) {
+						amount += state.defines.at_war_tension_decay;
 						break;
 					}
 				}
 			}
+			return amount;
+		}, ids, owner);
 
-
-			/*
-			- Tension ranges between 0 and 100
-			*/
-			si.get_flashpoint_tension() = std::clamp(si.get_flashpoint_tension() + total_increase, 0.0f, 100.0f);
-		} else {
-			si.set_flashpoint_tension(0.0f);
-		}
-	}
+		/*
+		- Tension ranges between 0 and 100
+		*/
+		auto old_tension = state.world.state_instance_get_flashpoint_tension(ids);
+		state.world.state_instance_set_flashpoint_tension(ids, ve::select(tag != dcon::national_identity_id{}, ve::min(ve::max(old_tension + total_increase, 0.0f), 100.0f), 0.0f));
+	});
 }
 
 void cleanup_crisis(sys::state& state) {
@@ -1630,12 +1797,21 @@ void update_crisis(sys::state& state) {
 		When a crisis becomes possible, we first check each of the three states with the highest tension > 50 where neither the owner of the state nor the nation associated with the flashpoint (if any) is at war. I believe the probability of a crisis happening in any of those states is 0.001 x define:CRISIS_BASE_CHANCE x state-tension / 100. If this turns into a crisis, the tension in the state is immediately zeroed.
 		*/
 		std::vector<dcon::state_instance_id> most_likely_states;
-		for(auto si : state.world.in_state_instance) {
-			if(si.get_nation_from_state_ownership().get_is_at_war() == false && si.get_flashpoint_tag() && si.get_flashpoint_tension() > 50.0f && si.get_flashpoint_tag().get_nation_from_identity_holder().get_is_at_war() == false) {
-				most_likely_states.push_back(si);
+		state.world.execute_serial_over_state_instance([&](auto ids) {
+			auto tag = state.world.state_instance_get_flashpoint_tag(ids);
+			auto candidate = (tag != dcon::national_identity_id{})
+				&& (state.world.state_instance_get_flashpoint_tension(ids) > 50.0f)
+				&& !state.world.nation_get_is_at_war(state.world.state_instance_get_nation_from_state_ownership(ids))
+				&& !state.world.nation_get_is_at_war(state.world.national_identity_get_nation_from_identity_holder(tag));
+			if(ve::compress_mask(candidate).v != 0) {
+				ve::apply([&](dcon::state_instance_id s, bool c) {
+					if(c && state.world.state_instance_is_valid(s))
+						most_likely_states.push_back(s);
+				}, ids, candidate);
 			}
-		}
-		std::sort(most_likely_states.begin(), most_likely_states.end(), [&](dcon::state_instance_id a, dcon::state_instance_id b) {
+		});
+		auto likely_end = most_likely_states.begin() + std::min(most_likely_states.size(), size_t(3));
+		std::partial_sort(most_likely_states.begin(), likely_end, most_likely_states.end(), [&](dcon::state_instance_id a, dcon::state_instance_id b) {
 			auto tension_diff = state.world.state_instance_get_flashpoint_tension(a) - state.world.state_instance_get_flashpoint_tension(b);
 			if(tension_diff != 0.0f) {
 				return tension_diff > 0.0f;
@@ -2,6 +2,8 @@
 #include <stdint.h>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <cstring>
 #include "culture.hpp"
 #include "dcon_generated.hpp"
 
@@ -217,6 +219,30 @@ int32_t get_level(sys::state& state, dcon::nation_id gp, dcon::nation_id target)
 
 }
 
+namespace ranking {
+
+/*
+The rankings are sorted by 64 bit keys that sort ascending in ranking order. From the most to the least significant bits, a key
+holds a tier (nations in a higher tier always go first), the score, and the nation index, which breaks ties. All three are stored
+inverted, since a ranking is descending in each of them. Keys are never zero, so zero can mark a nation that is not ranked.
+*/
+inline uint32_t ordered_score_bits(float score) { // unsigned order matches float order, with -0 equal to 0
+	score = score + 0.0f;
+	uint32_t bits = 0;
+	std::memcpy(&bits, &score, sizeof(float));
+	return (bits & 0x80000000) != 0 ? ~bits : (bits | 0x80000000);
+}
+inline uint64_t make_key(uint32_t tier, float score, dcon::nation_id n) {
+	assert(tier < 4 && uint32_t(n.index()) < 0x10000);
+	return ~((uint64_t(tier) << 48) | (uint64_t(ordered_score_bits(score)) << 16) | uint64_t(n.index()));
+}
+inline dcon::nation_id key_to_nation(uint64_t key) {
+	return dcon::nation_id{ dcon::nation_id::value_base_t(~key & 0xFFFF) };
+}
+void radix_sort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch); // ascending; scratch is working space
+
+}
+
 dcon::nation_id get_nth_great_power(sys::state const& state, uint16_t n);
 
 // returns whether a culture is on the accepted list OR is the primary culture
@@ -296,6 +322,20 @@ void update_monthly_points(sys::state& state);
 
 // may create a relationship DO NOT call in a context where two or more such functions may run in parallel
 void adjust_relationship(sys::state& state, dcon::nation_id a, dcon::nation_id b, float delta);
+
+// a change to the relation between two nations, for applying many of them at once
+struct relation_delta {
+	static constexpr uint64_t none = ~uint64_t(0);
+	uint64_t pair = none; // the lower nation index in the high bits; none for an unused entry
+	float delta = 0.0f;
+};
+inline relation_delta make_relation_delta(dcon::nation_id a, dcon::nation_id b, float delta) {
+	auto lo = uint64_t(std::min(a.index(), b.index()));
+	auto hi = uint64_t(std::max(a.index(), b.index()));
+	return relation_delta{ (lo << 32) | hi, delta };
+}
+// sums the changes by pair and applies each sum once, with the monthly rule that increases cannot take relations above 100; reorders deltas
+void apply_relation_deltas(sys::state& state, std::vector<relation_delta>& deltas);
 // used for creating a "new" nation when it is released
 void create_nation_based_on_template(sys::state& state, dcon::nation_id n, dcon::nation_id base);
 // call after a nation loses its last province
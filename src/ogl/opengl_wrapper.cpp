@@ -70,6 +70,8 @@ void initialize_opengl(sys::state& state) {
 
 	// Allocate textures for the flags
 	state.open_gl.asset_textures.resize(state.ui_defs.textures.size() + (state.world.national_identity_size() + 1) * state.flag_types.size());
+	build_texture_atlas(state);
+	start_texture_streaming(state);
 
 	state.map_state.load_map(state);
 
@@ -408,6 +410,52 @@ void render_masked_rect(sys::state const& state, color_modification enabled, flo
 	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 }
 
+void set_atlas_subrect(sys::state const& state, atlas_region const& region) {
+	// inset by half a texel so that linear filtering never reaches into the neighbouring textures
+	float const layer_size = float(texture_atlas::layer_size);
+	glUniform4f(parameters::subrect,
+		(float(region.x) + 0.5f) / layer_size /* x offset */,
+		(float(region.width) - 1.0f) / layer_size /* x width */,
+		(float(region.y) + 0.5f) / layer_size /* y offset */,
+		(float(region.height) - 1.0f) / layer_size /* y height */
+	);
+	glUniform1f(parameters::atlas_layer, float(region.layer));
+
+	glActiveTexture(GL_TEXTURE2);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, state.open_gl.atlas.handle);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+void render_atlas_rect(sys::state const& state, color_modification enabled, float x, float y, float width, float height, atlas_region const& region, ui::rotation r, bool flipped) {
+	glBindVertexArray(state.open_gl.global_square_vao);
+
+	bind_vertices_by_rotation(state, r, flipped);
+
+	glUniform4f(parameters::drawing_rectangle, x, y, width, height);
+	set_atlas_subrect(state, region);
+
+	GLuint subroutines[2] = { map_color_modification_to_index(enabled), parameters::atlas_sprite };
+	glUniformSubroutinesuiv(GL_FRAGMENT_SHADER, 2, subroutines); // must set all subroutines in one call
+
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+}
+
+void render_masked_atlas_rect(sys::state const& state, color_modification enabled, float x, float y, float width, float height, atlas_region const& region, GLuint mask_texture_handle, ui::rotation r, bool flipped) {
+	glBindVertexArray(state.open_gl.global_square_vao);
+
+	bind_vertices_by_rotation(state, r, flipped);
+
+	glUniform4f(parameters::drawing_rectangle, x, y, width, height);
+	set_atlas_subrect(state, region);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, mask_texture_handle);
+
+	GLuint subroutines[2] = { map_color_modification_to_index(enabled), parameters::atlas_mask };
+	glUniformSubroutinesuiv(GL_FRAGMENT_SHADER, 2, subroutines); // must set all subroutines in one call
+
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+}
+
 void render_progress_bar(sys::state const& state, color_modification enabled, float progress, float x, float y, float width, float height, GLuint left_texture_handle, GLuint right_texture_handle, ui::rotation r, bool flipped) {
 	glBindVertexArray(state.open_gl.global_square_vao);
 
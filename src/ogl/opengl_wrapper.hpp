@@ -23,6 +23,7 @@ inline constexpr GLuint drawing_rectangle = 2;
 inline constexpr GLuint border_size = 6;
 inline constexpr GLuint inner_color = 7;
 inline constexpr GLuint subrect = 10;
+inline constexpr GLuint atlas_layer = 11;
 
 inline constexpr GLuint enabled = 4;
 inline constexpr GLuint disabled = 3;
@@ -40,6 +41,8 @@ inline constexpr GLuint tint = 12;
 inline constexpr GLuint interactable = 13;
 inline constexpr GLuint interactable_disabled = 14;
 inline constexpr GLuint subsprite_b = 15;
+inline constexpr GLuint atlas_sprite = 16;
+inline constexpr GLuint atlas_mask = 17;
 }
 
 enum class color_modification {
@@ -132,6 +135,8 @@ struct color3f {
 
 	struct data {
 		tagged_vector<texture, dcon::texture_id> asset_textures;
+		texture_streamer texture_stream;
+		texture_atlas atlas;
 
 		void* context = nullptr;
 		GLuint ui_shader_program = 0;
@@ -202,6 +207,8 @@ struct color3f {
 	void render_piechart(sys::state const& state, color_modification enabled, float x, float y, float size, data_texture& t);
 	void render_bordered_rect(sys::state const& state, color_modification enabled, float border_size, float x, float y, float width, float height, GLuint texture_handle, ui::rotation r, bool flipped);
 	void render_masked_rect(sys::state const& state, color_modification enabled, float x, float y, float width, float height, GLuint texture_handle, GLuint mask_texture_handle, ui::rotation r, bool flipped);
+	void render_atlas_rect(sys::state const& state, color_modification enabled, float x, float y, float width, float height, atlas_region const& region, ui::rotation r, bool flipped);
+	void render_masked_atlas_rect(sys::state const& state, color_modification enabled, float x, float y, float width, float height, atlas_region const& region, GLuint mask_texture_handle, ui::rotation r, bool flipped);
 	void render_progress_bar(sys::state const& state, color_modification enabled, float progress, float x, float y, float width, float height, GLuint left_texture_handle, GLuint right_texture_handle, ui::rotation r, bool flipped);
 	void render_tinted_textured_rect(sys::state const& state, float x, float y, float width, float height, float r, float g, float b, GLuint texture_handle, ui::rotation rot, bool flipped);
 	void render_subsprite(sys::state const& state, color_modification enabled, int frame, int total_frames, float x, float y, float width, float height, GLuint texture_handle, ui::rotation r, bool flipped);
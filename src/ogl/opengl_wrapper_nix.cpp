@@ -23,5 +23,6 @@ namespace ogl {
 	}
 
 	void shutdown_opengl(sys::state& state) {
+		stop_texture_streaming(state);
 	}
 }
@@ -81,6 +81,7 @@ namespace ogl {
 
 	void shutdown_opengl(sys::state& state) {
 		assert(state.win_ptr && state.win_ptr->hwnd && state.open_gl.context);
+		stop_texture_streaming(state);
 		wglMakeCurrent(state.win_ptr->opengl_window_dc, nullptr);
 		wglDeleteContext(HGLRC(state.open_gl.context));
 		state.open_gl.context = nullptr;
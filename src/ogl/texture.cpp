@@ -89,46 +89,36 @@ typedef struct {
 }
 DDS_header;
 
-unsigned int SOIL_direct_load_DDS_from_memory(
+bool SOIL_parse_DDS_from_memory(
 		const unsigned char* const buffer,
 		unsigned int buffer_length,
-		unsigned int& width,
-		unsigned int& height,
-		int flags) {
+		dds_image& image) {
 	/*	variables	*/
 	DDS_header header;
 	unsigned int buffer_index = 0;
-	unsigned int tex_ID = 0;
 	/*	file reading variables	*/
-	unsigned int S3TC_type = 0;
-	unsigned char* DDS_data;
-	unsigned int DDS_main_size;
-	unsigned int DDS_full_size;
-	int mipmaps, cubemap, uncompressed, block_size = 16;
 	unsigned int flag;
-	unsigned int cf_target, ogl_target_start, ogl_target_end;
-	unsigned int opengl_texture_type;
 	int i;
 
 	if(buffer_length < sizeof(DDS_header)) {
-		return 0;
+		return false;
 	}
 	/*	try reading in the header	*/
 	memcpy((void*)(&header), (const void*)buffer, sizeof(DDS_header));
 	buffer_index = sizeof(DDS_header);
 
-	/*	validate the header (warning, "goto"'s ahead, shield your eyes!!)	*/
+	/*	validate the header	*/
 	flag = ('D' << 0) | ('D' << 8) | ('S' << 16) | (' ' << 24);
 	if(header.dwMagic != flag) {
-		goto quick_exit;
+		return false;
 	}
 	if(header.dwSize != 124) {
-		goto quick_exit;
+		return false;
 	}
 	/*	I need all of these	*/
 	flag = ALICE_DDSD_CAPS | ALICE_DDSD_HEIGHT | ALICE_DDSD_WIDTH | ALICE_DDSD_PIXELFORMAT;
 	if((header.dwFlags & flag) != flag) {
-		goto quick_exit;
+		return false;
 	}
 	/*	According to the MSDN spec, the dwFlags should contain
 		ALICE_DDSD_LINEARSIZE if it's compressed, or ALICE_DDSD_PITCH if
@@ -137,13 +127,13 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 		/*	I need one of these	*/
 	flag = ALICE_DDPF_FOURCC | ALICE_DDPF_RGB;
 	if((header.sPixelFormat.dwFlags & flag) == 0) {
-		goto quick_exit;
+		return false;
 	}
 	if(header.sPixelFormat.dwSize != 32) {
-		goto quick_exit;
+		return false;
 	}
 	if((header.sCaps.dwCaps1 & ALICE_DDSCAPS_TEXTURE) == 0) {
-		goto quick_exit;
+		return false;
 	}
 	/*	make sure it is a type we can upload	*/
 	if((header.sPixelFormat.dwFlags & ALICE_DDPF_FOURCC) &&
@@ -152,21 +142,24 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 			(header.sPixelFormat.dwFourCC == (('D' << 0) | ('X' << 8) | ('T' << 16) | ('3' << 24))) ||
 			(header.sPixelFormat.dwFourCC == (('D' << 0) | ('X' << 8) | ('T' << 16) | ('5' << 24)))
 			)) {
-		goto quick_exit;
+		return false;
+	}
+	/*	cube maps are not supported	*/
+	if((header.sCaps.dwCaps2 & ALICE_DDSCAPS2_CUBEMAP) != 0) {
+		return false;
 	}
 	/*	OK, validated the header, let's load the image data	*/
-	width = header.dwWidth;
-	height = header.dwHeight;
-	uncompressed = 1 - (header.sPixelFormat.dwFlags & ALICE_DDPF_FOURCC) / ALICE_DDPF_FOURCC;
-	cubemap = (header.sCaps.dwCaps2 & ALICE_DDSCAPS2_CUBEMAP) / ALICE_DDSCAPS2_CUBEMAP;
-	if(uncompressed) {
-		S3TC_type = GL_RGB;
-		block_size = 3;
+	image.width = header.dwWidth;
+	image.height = header.dwHeight;
+	image.uncompressed = (header.sPixelFormat.dwFlags & ALICE_DDPF_FOURCC) == 0;
+	if(image.uncompressed) {
+		image.format = GL_RGB;
+		image.block_size = 3;
 		if(header.sPixelFormat.dwFlags & ALICE_DDPF_ALPHAPIXELS) {
-			S3TC_type = GL_RGBA;
-			block_size = 4;
+			image.format = GL_RGBA;
+			image.block_size = 4;
 		}
-		DDS_main_size = width * height * block_size;
+		image.main_size = image.width * image.height * image.block_size;
 	} else {
 		/*	can we even handle direct uploading to OpenGL DXT compressed images?	*/
 		//
@@ -179,149 +172,159 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 		/*	well, we know it is DXT1/3/5, because we checked above	*/
 		switch((header.sPixelFormat.dwFourCC >> 24) - '0') {
 			case 1:
-				S3TC_type = SOIL_RGBA_S3TC_DXT1;
-				block_size = 8;
+				image.format = SOIL_RGBA_S3TC_DXT1;
+				image.block_size = 8;
 				break;
 			case 3:
-				S3TC_type = SOIL_RGBA_S3TC_DXT3;
-				block_size = 16;
+				image.format = SOIL_RGBA_S3TC_DXT3;
+				image.block_size = 16;
 				break;
 			case 5:
-				S3TC_type = SOIL_RGBA_S3TC_DXT5;
-				block_size = 16;
+				image.format = SOIL_RGBA_S3TC_DXT5;
+				image.block_size = 16;
 				break;
 		}
-		DDS_main_size = ((width + 3) >> 2) * ((height + 3) >> 2) * block_size;
-	}
-	if(cubemap) {
-		return 0;
-	} else {
-		ogl_target_start = GL_TEXTURE_2D;
-		ogl_target_end = GL_TEXTURE_2D;
-		opengl_texture_type = GL_TEXTURE_2D;
+		image.main_size = ((image.width + 3) >> 2) * ((image.height + 3) >> 2) * image.block_size;
 	}
 	if((header.sCaps.dwCaps1 & ALICE_DDSCAPS_MIPMAP) != 0 && (header.dwMipMapCount > 1)) {
-		mipmaps = header.dwMipMapCount - 1;
-		DDS_full_size = DDS_main_size;
-		for(i = 1; i <= mipmaps; ++i) {
+		image.mipmaps = header.dwMipMapCount - 1;
+		image.full_size = image.main_size;
+		for(i = 1; i <= image.mipmaps; ++i) {
 			int w, h;
-			w = width >> i;
-			h = height >> i;
+			w = image.width >> i;
+			h = image.height >> i;
 			if(w < 1) {
 				w = 1;
 			}
 			if(h < 1) {
 				h = 1;
 			}
-			if(uncompressed) {
+			if(image.uncompressed) {
 				/*	uncompressed DDS, simple MIPmap size calculation	*/
-				DDS_full_size += w * h * block_size;
+				image.full_size += w * h * image.block_size;
 			} else {
 				/*	compressed DDS, MIPmap size calculation is block based	*/
-				DDS_full_size += ((w + 3) / 4) * ((h + 3) / 4) * block_size;
+				image.full_size += ((w + 3) / 4) * ((h + 3) / 4) * image.block_size;
 			}
 		}
 	} else {
-		mipmaps = 0;
-		DDS_full_size = DDS_main_size;
+		image.mipmaps = 0;
+		image.full_size = image.main_size;
+	}
+	if(buffer_index + image.full_size > (unsigned int)buffer_length) {
+		return false;
 	}
-	DDS_data = (unsigned char*)malloc(DDS_full_size);
-	/*	got the image data RAM, create or use an existing OpenGL texture handle	*/
 
+	image.data = (unsigned char*)malloc(image.full_size);
+	memcpy((void*)image.data, (const void*)(&buffer[buffer_index]), image.full_size);
+	if(image.uncompressed) {
+		/*	and remember, DXT uncompressed uses BGR(A),
+			so swap to RGB(A) for ALL MIPmap levels	*/
+		for(i = 0; i < (int)image.full_size; i += image.block_size) {
+			unsigned char temp = image.data[i];
+			image.data[i] = image.data[i + 2];
+			image.data[i + 2] = temp;
+		}
+	}
+	return true;
+}
+
+unsigned int SOIL_upload_DDS(dds_image const& image, unsigned char const* pixels, int flags) {
+	unsigned int tex_ID = 0;
+	unsigned int const opengl_texture_type = GL_TEXTURE_2D;
+
+	/*	create an OpenGL texture handle	*/
 	glGenTextures(1, &tex_ID);
+	if(!tex_ID) {
+		return 0;
+	}
 	/*  bind an OpenGL texture ID	*/
 	glBindTexture(opengl_texture_type, tex_ID);
-	if(tex_ID) {
-		/*	did I have MIPmaps?	*/
-		if(mipmaps > 0 || (flags & SOIL_FLAG_MIPMAPS)) {
-			/*	instruct OpenGL to use the MIPmaps	*/
-			glTexParameteri(opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			glTexParameteri(opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
-		} else {
-			/*	instruct OpenGL _NOT_ to use the MIPmaps	*/
-			glTexParameteri(opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			glTexParameteri(opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		}
-		/*	does the user want clamping, or wrapping?	*/
-		if(flags & SOIL_FLAG_TEXTURE_REPEATS) {
-			glTexParameteri(opengl_texture_type, GL_TEXTURE_WRAP_S, GL_REPEAT);
-			glTexParameteri(opengl_texture_type, GL_TEXTURE_WRAP_T, GL_REPEAT);
-			glTexParameteri(opengl_texture_type, SOIL_TEXTURE_WRAP_R, GL_REPEAT);
-		} else {
-			unsigned int clamp_mode = SOIL_CLAMP_TO_EDGE;
-			/* unsigned int clamp_mode = GL_CLAMP; */
-			glTexParameteri(opengl_texture_type, GL_TEXTURE_WRAP_S, clamp_mode);
-			glTexParameteri(opengl_texture_type, GL_TEXTURE_WRAP_T, clamp_mode);
-			glTexParameteri(opengl_texture_type, SOIL_TEXTURE_WRAP_R, clamp_mode);
-		}
+	/*	did I have MIPmaps?	*/
+	if(image.mipmaps > 0 || (flags & SOIL_FLAG_MIPMAPS)) {
+		/*	instruct OpenGL to use the MIPmaps	*/
+		glTexParameteri(opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+	} else {
+		/*	instruct OpenGL _NOT_ to use the MIPmaps	*/
+		glTexParameteri(opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	}
+	/*	does the user want clamping, or wrapping?	*/
+	if(flags & SOIL_FLAG_TEXTURE_REPEATS) {
+		glTexParameteri(opengl_texture_type, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(opengl_texture_type, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(opengl_texture_type, SOIL_TEXTURE_WRAP_R, GL_REPEAT);
+	} else {
+		unsigned int clamp_mode = SOIL_CLAMP_TO_EDGE;
+		/* unsigned int clamp_mode = GL_CLAMP; */
+		glTexParameteri(opengl_texture_type, GL_TEXTURE_WRAP_S, clamp_mode);
+		glTexParameteri(opengl_texture_type, GL_TEXTURE_WRAP_T, clamp_mode);
+		glTexParameteri(opengl_texture_type, SOIL_TEXTURE_WRAP_R, clamp_mode);
 	}
 
-	/*	do this for each face of the cubemap!	*/
-	for(cf_target = ogl_target_start; cf_target <= ogl_target_end; ++cf_target) {
-		if(buffer_index + DDS_full_size <= (unsigned int)buffer_length) {
-			unsigned int byte_offset = DDS_main_size;
-			memcpy((void*)DDS_data, (const void*)(&buffer[buffer_index]), DDS_full_size);
-			buffer_index += DDS_full_size;
-			/*	upload the main chunk	*/
-			if(uncompressed) {
-				/*	and remember, DXT uncompressed uses BGR(A),
-					so swap to RGB(A) for ALL MIPmap levels	*/
-				for(i = 0; i < (int)DDS_full_size; i += block_size) {
-					unsigned char temp = DDS_data[i];
-					DDS_data[i] = DDS_data[i + 2];
-					DDS_data[i + 2] = temp;
-				}
-				glTexImage2D(
-					cf_target, 0,
-					S3TC_type, width, height, 0,
-					S3TC_type, GL_UNSIGNED_BYTE, DDS_data);
-			} else {
-				glCompressedTexImage2D(
-					cf_target, 0,
-					S3TC_type, width, height, 0,
-					DDS_main_size, DDS_data);
-			}
-			/*	upload the mipmaps, if we have them	*/
-			for(i = 1; i <= mipmaps; ++i) {
-				int w, h, mip_size;
-				w = width >> i;
-				h = height >> i;
-				if(w < 1) {
-					w = 1;
-				}
-				if(h < 1) {
-					h = 1;
-				}
-				/*	upload this mipmap	*/
-				if(uncompressed) {
-					mip_size = w * h * block_size;
-					glTexImage2D(
-						cf_target, i,
-						S3TC_type, w, h, 0,
-						S3TC_type, GL_UNSIGNED_BYTE, &DDS_data[byte_offset]);
-				} else {
-					mip_size = ((w + 3) / 4) * ((h + 3) / 4) * block_size;
-					glCompressedTexImage2D(
-						cf_target, i,
-						S3TC_type, w, h, 0,
-						mip_size, &DDS_data[byte_offset]);
-				}
-				/*	and move to the next mipmap	*/
-				byte_offset += mip_size;
-			}
+	/*	upload the main chunk	*/
+	unsigned int byte_offset = image.main_size;
+	if(image.uncompressed) {
+		glTexImage2D(
+			opengl_texture_type, 0,
+			image.format, image.width, image.height, 0,
+			image.format, GL_UNSIGNED_BYTE, pixels);
+	} else {
+		glCompressedTexImage2D(
+			opengl_texture_type, 0,
+			image.format, image.width, image.height, 0,
+			image.main_size, pixels);
+	}
+	/*	upload the mipmaps, if we have them	*/
+	for(int i = 1; i <= image.mipmaps; ++i) {
+		int w, h, mip_size;
+		w = image.width >> i;
+		h = image.height >> i;
+		if(w < 1) {
+			w = 1;
+		}
+		if(h < 1) {
+			h = 1;
+		}
+		/*	upload this mipmap	*/
+		if(image.uncompressed) {
+			mip_size = w * h * image.block_size;
+			glTexImage2D(
+				opengl_texture_type, i,
+				image.format, w, h, 0,
+				image.format, GL_UNSIGNED_BYTE, pixels + byte_offset);
 		} else {
-			glDeleteTextures(1, &tex_ID);
-			tex_ID = 0;
-			cf_target = ogl_target_end + 1;
+			mip_size = ((w + 3) / 4) * ((h + 3) / 4) * image.block_size;
+			glCompressedTexImage2D(
+				opengl_texture_type, i,
+				image.format, w, h, 0,
+				mip_size, pixels + byte_offset);
 		}
-	}/* end reading each face */
-	free(DDS_data);
+		/*	and move to the next mipmap	*/
+		byte_offset += mip_size;
+	}
 
 	if(flags & SOIL_FLAG_MIPMAPS)
 		glGenerateMipmap(opengl_texture_type);
 
-quick_exit:
-	/*	report success or failure	*/
+	return tex_ID;
+}
+
+unsigned int SOIL_direct_load_DDS_from_memory(
+		const unsigned char* const buffer,
+		unsigned int buffer_length,
+		unsigned int& width,
+		unsigned int& height,
+		int flags) {
+	dds_image image;
+	if(!SOIL_parse_DDS_from_memory(buffer, buffer_length, image)) {
+		return 0;
+	}
+	width = image.width;
+	height = image.height;
+	auto tex_ID = SOIL_upload_DDS(image, image.data, flags);
+	free(image.data);
 	return tex_ID;
 }
 
@@ -332,6 +335,9 @@ texture::~texture() {
 texture::texture(texture&& other) noexcept {
 	channels = other.channels;
 	loaded = other.loaded;
+	streaming = other.streaming;
+	atlas_loaded = other.atlas_loaded;
+	atlas_streaming = other.atlas_streaming;
 	size_x = other.size_x;
 	size_y = other.size_y;
 	data = other.data;
@@ -342,6 +348,9 @@ texture::texture(texture&& other) noexcept {
 texture& texture::operator=(texture&& other) noexcept {
 	channels = other.channels;
 	loaded = other.loaded;
+	streaming = other.streaming;
+	atlas_loaded = other.atlas_loaded;
+	atlas_streaming = other.atlas_streaming;
 	size_x = other.size_x;
 	size_y = other.size_y;
 	data = other.data;
@@ -424,104 +433,733 @@ GLuint load_file_and_return_handle(native_string const& native_name, simple_fs::
 	return 0;
 }
 
-GLuint get_flag_handle(sys::state& state, dcon::national_identity_id nat_id, culture::flag_type type) {
+GLuint request_texture_load(sys::state& state, dcon::texture_id id, native_string&& file_name, bool to_atlas = false);
+
+dcon::texture_id get_flag_texture_id(sys::state& state, dcon::national_identity_id nat_id, culture::flag_type type) {
 	const auto offset = culture::get_remapped_flag_type(state, type);
-	dcon::texture_id id = dcon::texture_id{ dcon::texture_id::value_base_t(state.ui_defs.textures.size() + (1 + nat_id.index()) * state.flag_types.size() + offset) };
+	return dcon::texture_id{ dcon::texture_id::value_base_t(state.ui_defs.textures.size() + (1 + nat_id.index()) * state.flag_types.size() + offset) };
+}
+
+native_string get_flag_file_name(sys::state& state, dcon::national_identity_id nat_id, culture::flag_type type) {
+	native_string file_str;
+	file_str += NATIVE("gfx");
+	file_str += NATIVE_DIR_SEPARATOR;
+	file_str += NATIVE("flags");
+	file_str += NATIVE_DIR_SEPARATOR;
+	file_str += simple_fs::win1250_to_native(nations::int_to_tag(state.world.national_identity_get_identifying_int(nat_id)));
+	switch(type) {
+		case culture::flag_type::communist:
+			file_str += NATIVE("_communist"); break;
+		case culture::flag_type::count:
+		case culture::flag_type::default_flag:
+			break;
+		case culture::flag_type::fascist:
+			file_str += NATIVE("_fascist"); break;
+		case culture::flag_type::monarchy:
+			file_str += NATIVE("_monarchy"); break;
+		case culture::flag_type::republic:
+			file_str += NATIVE("_republic"); break;
+		// Non-vanilla
+		case culture::flag_type::theocracy:
+			file_str += NATIVE("_theocracy"); break;
+		case culture::flag_type::special:
+			file_str += NATIVE("_special"); break;
+		case culture::flag_type::spare:
+			file_str += NATIVE("_spare"); break;
+		case culture::flag_type::populist:
+			file_str += NATIVE("_populist"); break;
+		case culture::flag_type::realm:
+			file_str += NATIVE("_realm"); break;
+		case culture::flag_type::other:
+			file_str += NATIVE("_other"); break;
+		case culture::flag_type::monarchy2:
+			file_str += NATIVE("_monarchy2"); break;
+		case culture::flag_type::monarchy3:
+			file_str += NATIVE("_monarchy3"); break;
+		case culture::flag_type::republic2:
+			file_str += NATIVE("_republic2"); break;
+		case culture::flag_type::republic3:
+			file_str += NATIVE("_republic3"); break;
+		case culture::flag_type::communist2:
+			file_str += NATIVE("_communist2"); break;
+		case culture::flag_type::communist3:
+			file_str += NATIVE("_communist3"); break;
+		case culture::flag_type::fascist2:
+			file_str += NATIVE("_fascist2"); break;
+		case culture::flag_type::fascist3:
+			file_str += NATIVE("_fascist3"); break;
+		case culture::flag_type::theocracy2:
+			file_str += NATIVE("_theocracy2"); break;
+		case culture::flag_type::theocracy3:
+			file_str += NATIVE("_theocracy3"); break;
+		case culture::flag_type::cosmetic_1:
+			file_str += NATIVE("_cosmetic_1"); break;
+		case culture::flag_type::cosmetic_2:
+			file_str += NATIVE("_cosmetic_2"); break;
+		case culture::flag_type::colonial:
+			file_str += NATIVE("_colonial"); break;
+		case culture::flag_type::nationalist:
+			file_str += NATIVE("_nationalist"); break;
+		case culture::flag_type::sectarian:
+			file_str += NATIVE("_sectarian"); break;
+		case culture::flag_type::socialist:
+			file_str += NATIVE("_socialist"); break;
+		case culture::flag_type::dominion:
+			file_str += NATIVE("_dominion"); break;
+		case culture::flag_type::agrarism:
+			file_str += NATIVE("_agrarism"); break;
+		case culture::flag_type::national_syndicalist:
+			file_str += NATIVE("_national_syndicalist"); break;
+		case culture::flag_type::theocratic:
+			file_str += NATIVE("_theocratic"); break;
+	}
+	file_str += NATIVE(".tga");
+	return file_str;
+}
+
+GLuint get_flag_handle(sys::state& state, dcon::national_identity_id nat_id, culture::flag_type type) {
+	dcon::texture_id id = get_flag_texture_id(state, nat_id, type);
 
 	if(state.open_gl.asset_textures[id].loaded) {
 		return state.open_gl.asset_textures[id].texture_handle;
+	} else if(state.open_gl.asset_textures[id].streaming) {
+		return state.open_gl.texture_stream.placeholder;
 	} else { // load from file
-
-		native_string file_str;
-		file_str += NATIVE("gfx");
-		file_str += NATIVE_DIR_SEPARATOR;
-		file_str += NATIVE("flags");
-		file_str += NATIVE_DIR_SEPARATOR;
-		file_str += simple_fs::win1250_to_native(nations::int_to_tag(state.world.national_identity_get_identifying_int(nat_id)));
-		switch(type) {
-			case culture::flag_type::communist:
-				file_str += NATIVE("_communist"); break;
-			case culture::flag_type::count:
-			case culture::flag_type::default_flag:
-				break;
-			case culture::flag_type::fascist:
-				file_str += NATIVE("_fascist"); break;
-			case culture::flag_type::monarchy:
-				file_str += NATIVE("_monarchy"); break;
-			case culture::flag_type::republic:
-				file_str += NATIVE("_republic"); break;
-			// Non-vanilla
-			case culture::flag_type::theocracy:
-				file_str += NATIVE("_theocracy"); break;
-			case culture::flag_type::special:
-				file_str += NATIVE("_special"); break;
-			case culture::flag_type::spare:
-				file_str += NATIVE("_spare"); break;
-			case culture::flag_type::populist:
-				file_str += NATIVE("_populist"); break;
-			case culture::flag_type::realm:
-				file_str += NATIVE("_realm"); break;
-			case culture::flag_type::other:
-				file_str += NATIVE("_other"); break;
-			case culture::flag_type::monarchy2:
-				file_str += NATIVE("_monarchy2"); break;
-			case culture::flag_type::monarchy3:
-				file_str += NATIVE("_monarchy3"); break;
-			case culture::flag_type::republic2:
-				file_str += NATIVE("_republic2"); break;
-			case culture::flag_type::republic3:
-				file_str += NATIVE("_republic3"); break;
-			case culture::flag_type::communist2:
-				file_str += NATIVE("_communist2"); break;
-			case culture::flag_type::communist3:
-				file_str += NATIVE("_communist3"); break;
-			case culture::flag_type::fascist2:
-				file_str += NATIVE("_fascist2"); break;
-			case culture::flag_type::fascist3:
-				file_str += NATIVE("_fascist3"); break;
-			case culture::flag_type::theocracy2:
-				file_str += NATIVE("_theocracy2"); break;
-			case culture::flag_type::theocracy3:
-				file_str += NATIVE("_theocracy3"); break;
-			case culture::flag_type::cosmetic_1:
-				file_str += NATIVE("_cosmetic_1"); break;
-			case culture::flag_type::cosmetic_2:
-				file_str += NATIVE("_cosmetic_2"); break;
-			case culture::flag_type::colonial:
-				file_str += NATIVE("_colonial"); break;
-			case culture::flag_type::nationalist:
-				file_str += NATIVE("_nationalist"); break;
-			case culture::flag_type::sectarian:
-				file_str += NATIVE("_sectarian"); break;
-			case culture::flag_type::socialist:
-				file_str += NATIVE("_socialist"); break;
-			case culture::flag_type::dominion:
-				file_str += NATIVE("_dominion"); break;
-			case culture::flag_type::agrarism:
-				file_str += NATIVE("_agrarism"); break;
-			case culture::flag_type::national_syndicalist:
-				file_str += NATIVE("_national_syndicalist"); break;
-			case culture::flag_type::theocratic:
-				file_str += NATIVE("_theocratic"); break;
-		}
-		file_str += NATIVE(".tga");
-
-		return load_file_and_return_handle(file_str, state.common_fs, state.open_gl.asset_textures[id], false);
+		return request_texture_load(state, id, get_flag_file_name(state, nat_id, type));
 	}
 }
 
 GLuint get_texture_handle(sys::state& state, dcon::texture_id id, bool keep_data) {
 	if(state.open_gl.asset_textures[id].loaded) {
 		return state.open_gl.asset_textures[id].texture_handle;
+	} else if(state.open_gl.asset_textures[id].streaming && !keep_data) {
+		return state.open_gl.texture_stream.placeholder;
 	} else { // load from file
 		auto fname = state.ui_defs.textures[id];
 		auto fname_view = state.to_string_view(fname);
 		auto native_name = simple_fs::win1250_to_native(fname_view);
 
-		return load_file_and_return_handle(native_name, state.common_fs, state.open_gl.asset_textures[id], keep_data);
+		if(keep_data) // the pixel data is wanted right away (i.e. for transparency checks), so this can't wait for the streamer
+			return load_file_and_return_handle(native_name, state.common_fs, state.open_gl.asset_textures[id], keep_data);
+		return request_texture_load(state, id, std::move(native_name));
 	} // end else (not already loaded)
 }
 
+void prefetch_texture(sys::state& state, dcon::texture_id id) {
+	auto& asset_texture = state.open_gl.asset_textures[id];
+	if(asset_texture.loaded || asset_texture.streaming || !state.open_gl.texture_stream.workers[0].joinable())
+		return;
+
+	auto fname = state.ui_defs.textures[id];
+	request_texture_load(state, id, simple_fs::win1250_to_native(state.to_string_view(fname)));
+}
+
+void prefetch_gfx_texture(sys::state& state, dcon::gfx_object_id gfx_id) {
+	if(gfx_id) {
+		auto& gfx_def = state.ui_defs.gfx[gfx_id];
+		if(gfx_def.primary_texture_handle)
+			prefetch_texture(state, gfx_def.primary_texture_handle);
+	}
+}
+
+void prefetch_textures(sys::state& state, ui::element_data const& def) {
+	switch(def.get_element_type()) {
+		case ui::element_type::button:
+			prefetch_gfx_texture(state, def.data.button.button_image);
+			break;
+		case ui::element_type::image:
+			prefetch_gfx_texture(state, def.data.image.gfx_object);
+			break;
+		case ui::element_type::listbox:
+			prefetch_gfx_texture(state, def.data.list_box.background_image);
+			break;
+		case ui::element_type::window:
+			for(uint32_t i = 0; i < def.data.window.num_children; ++i) {
+				auto child_tag = dcon::gui_def_id(dcon::gui_def_id::value_base_t(i + def.data.window.first_child.index()));
+				prefetch_textures(state, state.ui_defs.gui[child_tag]);
+			}
+			break;
+		case ui::element_type::scrollbar:
+			for(uint32_t i = 0; i < def.data.scrollbar.num_children; ++i) {
+				auto child_tag = dcon::gui_def_id(dcon::gui_def_id::value_base_t(i + def.data.scrollbar.first_child.index()));
+				prefetch_textures(state, state.ui_defs.gui[child_tag]);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+// Expands the top mip level of a parsed dds into 8-bit rgba; compressed images are decoded from their DXT1/3/5 blocks
+uint8_t* dds_to_rgba(dds_image const& image) {
+	uint32_t const w = image.width;
+	uint32_t const h = image.height;
+	uint8_t* rgba = static_cast<uint8_t*>(STBI_MALLOC(4 * w * h));
+	if(!rgba)
+		return nullptr;
+
+	if(image.uncompressed) {
+		for(uint32_t i = 0; i < w * h; ++i) {
+			rgba[i * 4 + 0] = image.data[i * image.block_size + 0];
+			rgba[i * 4 + 1] = image.data[i * image.block_size + 1];
+			rgba[i * 4 + 2] = image.data[i * image.block_size + 2];
+			rgba[i * 4 + 3] = image.block_size == 4 ? image.data[i * image.block_size + 3] : uint8_t(255);
+		}
+		return rgba;
+	}
+
+	auto unpack_565 = [](uint16_t c, uint8_t* out) {
+		out[0] = uint8_t(((c >> 11) & 0x1F) * 255 / 31);
+		out[1] = uint8_t(((c >> 5) & 0x3F) * 255 / 63);
+		out[2] = uint8_t((c & 0x1F) * 255 / 31);
+		out[3] = 255;
+	};
+
+	bool const has_alpha_block = image.format != SOIL_RGBA_S3TC_DXT1;
+	uint8_t const* block = image.data;
+	for(uint32_t by = 0; by < (h + 3) / 4; ++by) {
+		for(uint32_t bx = 0; bx < (w + 3) / 4; ++bx) {
+			uint8_t alpha[16];
+			for(auto& a : alpha)
+				a = 255;
+			uint8_t const* color_block = block;
+			if(image.format == SOIL_RGBA_S3TC_DXT3) {
+				for(uint32_t i = 0; i < 16; ++i) {
+					uint8_t nibble = (block[i / 2] >> ((i & 1) * 4)) & 0x0F;
+					alpha[i] = uint8_t(nibble * 17);
+				}
+				color_block = block + 8;
+			} else if(image.format == SOIL_RGBA_S3TC_DXT5) {
+				uint8_t a[8];
+				a[0] = block[0];
+				a[1] = block[1];
+				if(a[0] > a[1]) {
+					for(uint32_t i = 1; i < 7; ++i)
+						a[i + 1] = uint8_t(((7 - i) * a[0] + i * a[1]) / 7);
+				} else {
+					for(uint32_t i = 1; i < 5; ++i)
+						a[i + 1] = uint8_t(((5 - i) * a[0] + i * a[1]) / 5);
+					a[6] = 0;
+					a[7] = 255;
+				}
+				uint64_t bits = 0;
+				for(uint32_t i = 0; i < 6; ++i)
+					bits |= uint64_t(block[2 + i]) << (8 * i);
+				for(uint32_t i = 0; i < 16; ++i)
+					alpha[i] = a[(bits >> (3 * i)) & 0x07];
+				color_block = block + 8;
+			}
+
+			uint16_t c0 = uint16_t(color_block[0] | (color_block[1] << 8));
+			uint16_t c1 = uint16_t(color_block[2] | (color_block[3] << 8));
+			uint8_t colors[4][4];
+			unpack_565(c0, colors[0]);
+			unpack_565(c1, colors[1]);
+			if(c0 > c1 || has_alpha_block) {
+				for(uint32_t k = 0; k < 3; ++k) {
+					colors[2][k] = uint8_t((2 * colors[0][k] + colors[1][k]) / 3);
+					colors[3][k] = uint8_t((colors[0][k] + 2 * colors[1][k]) / 3);
+				}
+				colors[2][3] = 255;
+				colors[3][3] = 255;
+			} else {
+				for(uint32_t k = 0; k < 3; ++k) {
+					colors[2][k] = uint8_t((colors[0][k] + colors[1][k]) / 2);
+					colors[3][k] = 0;
+				}
+				colors[2][3] = 255;
+				colors[3][3] = 0;
+			}
+			uint32_t indices = uint32_t(color_block[4]) | (uint32_t(color_block[5]) << 8) | (uint32_t(color_block[6]) << 16) | (uint32_t(color_block[7]) << 24);
+
+			for(uint32_t i = 0; i < 16; ++i) {
+				uint32_t px = bx * 4 + (i & 3);
+				uint32_t py = by * 4 + (i >> 2);
+				if(px >= w || py >= h)
+					continue;
+				auto& c = colors[(indices >> (2 * i)) & 0x03];
+				uint8_t* out = rgba + (py * w + px) * 4;
+				out[0] = c[0];
+				out[1] = c[1];
+				out[2] = c[2];
+				out[3] = has_alpha_block ? alpha[i] : c[3];
+			}
+			block += image.block_size;
+		}
+	}
+	return rgba;
+}
+
+decoded_texture decode_texture_file(simple_fs::file_system const& fs, texture_load_request const& request) {
+	decoded_texture result;
+	result.id = request.id;
+	result.to_atlas = request.to_atlas;
+
+	auto name_length = request.file_name.length();
+	auto root = get_root(fs);
+	if(name_length > 4) { // try loading as a dds
+		auto dds_name = request.file_name.substr(0, name_length - 3) + NATIVE("dds");
+		auto file = open_file(root, dds_name);
+		if(file) {
+			auto content = simple_fs::view_contents(*file);
+			if(SOIL_parse_DDS_from_memory(reinterpret_cast<uint8_t const*>(content.data), content.file_size, result.dds)) {
+				result.size_x = int32_t(result.dds.width);
+				result.size_y = int32_t(result.dds.height);
+				if(request.to_atlas) { // the atlas is plain rgba, so the dds can't be uploaded as it is
+					result.rgba = dds_to_rgba(result.dds);
+					result.failed = (result.rgba == nullptr);
+					free(result.dds.data);
+					result.dds.data = nullptr;
+				}
+				return result;
+			}
+		}
+	}
+
+	auto file = open_file(root, request.file_name);
+	if(file) {
+		auto content = simple_fs::view_contents(*file);
+		int32_t file_channels = 4;
+		result.rgba = stbi_load_from_memory(reinterpret_cast<uint8_t const*>(content.data), int32_t(content.file_size),
+			&(result.size_x), &(result.size_y), &file_channels, 4);
+	}
+	result.failed = (result.rgba == nullptr);
+	return result;
+}
+
+void free_decoded_texture(decoded_texture& t) {
+	free(t.dds.data);
+	t.dds.data = nullptr;
+	STBI_FREE(t.rgba);
+	t.rgba = nullptr;
+}
+
+void texture_streaming_worker(sys::state& state, texture_streamer& streamer) {
+	while(true) {
+		texture_load_request request;
+		{
+			std::unique_lock lock(streamer.request_lock);
+			streamer.request_signal.wait(lock, [&]() { return streamer.quit || !streamer.requests.empty(); });
+			if(streamer.quit)
+				return;
+			request = std::move(streamer.requests.front());
+			streamer.requests.pop_front();
+		}
+		auto result = decode_texture_file(state.common_fs, request);
+		{
+			std::lock_guard lock(streamer.result_lock);
+			streamer.results.push_back(std::move(result));
+		}
+	}
+}
+
+void upload_atlas_texture(sys::state& state, decoded_texture const& t);
+
+GLuint request_texture_load(sys::state& state, dcon::texture_id id, native_string&& file_name, bool to_atlas) {
+	auto& streamer = state.open_gl.texture_stream;
+	auto& asset_texture = state.open_gl.asset_textures[id];
+	if(!streamer.workers[0].joinable()) { // streaming hasn't been started (or was stopped); load it the old way
+		if(to_atlas) {
+			auto t = decode_texture_file(state.common_fs, texture_load_request{ id, std::move(file_name), true });
+			upload_atlas_texture(state, t);
+			free_decoded_texture(t);
+			return 0;
+		}
+		return load_file_and_return_handle(file_name, state.common_fs, asset_texture, false);
+	}
+
+	if(to_atlas)
+		asset_texture.atlas_streaming = true;
+	else
+		asset_texture.streaming = true;
+	{
+		std::lock_guard lock(streamer.request_lock);
+		streamer.requests.push_back(texture_load_request{ id, std::move(file_name), to_atlas });
+	}
+	streamer.request_signal.notify_one();
+	return streamer.placeholder;
+}
+
+// Copies the pixel data into the next pixel unpack buffer and leaves it bound; returns the pointer to pass to the
+// gl*Tex*Image functions (an offset into the bound buffer, or the data itself if the buffer couldn't be mapped)
+uint8_t const* stage_texture_upload(texture_streamer& streamer, uint8_t const* data, uint32_t size) {
+	auto buffer = streamer.upload_buffers[streamer.next_upload_buffer];
+	streamer.next_upload_buffer = (streamer.next_upload_buffer + 1) % texture_streamer::upload_buffer_count;
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW); // orphan the storage the previous upload may still be reading
+	void* destination = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if(destination) {
+		memcpy(destination, data, size);
+		if(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE)
+			return nullptr;
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	return data;
+}
+
+void upload_decoded_texture(texture_streamer& streamer, decoded_texture const& t, texture& asset_texture) {
+	if(t.failed) {
+		asset_texture.texture_handle = 0;
+		asset_texture.loaded = true; // don't go back to the disk every frame for a file that isn't there
+		return;
+	}
+
+	auto pixels = stage_texture_upload(streamer, t.dds.data ? t.dds.data : t.rgba, t.byte_size());
+	if(t.dds.data) {
+		asset_texture.texture_handle = SOIL_upload_DDS(t.dds, pixels, 0);
+	} else {
+		glGenTextures(1, &asset_texture.texture_handle);
+		if(asset_texture.texture_handle) {
+			glBindTexture(GL_TEXTURE_2D, asset_texture.texture_handle);
+
+			glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, t.size_x, t.size_y);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, t.size_x, t.size_y, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		}
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	asset_texture.channels = 4;
+	asset_texture.size_x = t.size_x;
+	asset_texture.size_y = t.size_y;
+	asset_texture.loaded = true;
+}
+
+void process_texture_uploads(sys::state& state) {
+	auto& streamer = state.open_gl.texture_stream;
+	{
+		std::lock_guard lock(streamer.result_lock);
+		for(auto& r : streamer.results)
+			streamer.pending_uploads.push_back(std::move(r));
+		streamer.results.clear();
+	}
+
+	uint32_t uploaded_bytes = 0;
+	while(!streamer.pending_uploads.empty()) {
+		auto& t = streamer.pending_uploads.front();
+		if(uploaded_bytes != 0 && uploaded_bytes + t.byte_size() > texture_streamer::upload_bytes_per_frame)
+			break;
+
+		auto& asset_texture = state.open_gl.asset_textures[t.id];
+		if(t.to_atlas) {
+			if(!asset_texture.atlas_loaded) {
+				upload_atlas_texture(state, t);
+				uploaded_bytes += t.failed ? 0 : t.byte_size();
+			}
+			asset_texture.atlas_streaming = false;
+		} else {
+			if(!asset_texture.loaded) { // it may have been loaded synchronously in the meantime
+				upload_decoded_texture(streamer, t, asset_texture);
+				uploaded_bytes += t.failed ? 0 : t.byte_size();
+			}
+			asset_texture.streaming = false;
+		}
+
+		free_decoded_texture(t);
+		streamer.pending_uploads.pop_front();
+	}
+}
+
+void start_texture_streaming(sys::state& state) {
+	auto& streamer = state.open_gl.texture_stream;
+
+	uint32_t transparent_pixel = 0;
+	glGenTextures(1, &streamer.placeholder);
+	glBindTexture(GL_TEXTURE_2D, streamer.placeholder);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 1, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &transparent_pixel);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenBuffers(texture_streamer::upload_buffer_count, streamer.upload_buffers);
+
+	streamer.quit = false;
+	for(auto& w : streamer.workers)
+		w = std::thread([&state, &streamer]() { texture_streaming_worker(state, streamer); });
+}
+
+void stop_texture_streaming(sys::state& state) {
+	auto& streamer = state.open_gl.texture_stream;
+	streamer.stop();
+	for(auto& t : state.open_gl.asset_textures) { // whatever was still in flight will be loaded on demand again
+		t.streaming = false;
+		t.atlas_streaming = false;
+	}
+
+	glDeleteBuffers(texture_streamer::upload_buffer_count, streamer.upload_buffers);
+	for(auto& b : streamer.upload_buffers)
+		b = 0;
+}
+
+void texture_streamer::stop() {
+	{
+		std::lock_guard lock(request_lock);
+		quit = true;
+		requests.clear();
+	}
+	request_signal.notify_all();
+	for(auto& w : workers) {
+		if(w.joinable())
+			w.join();
+	}
+
+	for(auto& r : results)
+		free_decoded_texture(r);
+	results.clear();
+	for(auto& r : pending_uploads)
+		free_decoded_texture(r);
+	pending_uploads.clear();
+}
+
+texture_streamer::~texture_streamer() {
+	stop();
+}
+
+void upload_atlas_texture(sys::state& state, decoded_texture const& t) {
+	auto& atlas = state.open_gl.atlas;
+	auto& asset_texture = state.open_gl.asset_textures[t.id];
+	asset_texture.atlas_loaded = true; // even if it failed; the region is left transparent then
+
+	if(t.failed || !t.rgba || t.id.index() >= int32_t(atlas.regions.size()))
+		return;
+	auto const& region = atlas.regions[t.id];
+	if(!region.valid())
+		return;
+
+	// the file may have changed size since the packing was cached; never write outside the region
+	int32_t w = std::min(int32_t(region.width), t.size_x);
+	int32_t h = std::min(int32_t(region.height), t.size_y);
+
+	auto& streamer = state.open_gl.texture_stream;
+	glBindTexture(GL_TEXTURE_2D_ARRAY, atlas.handle);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, t.size_x);
+	uint8_t const* pixels = t.rgba;
+	if(streamer.upload_buffers[0])
+		pixels = stage_texture_upload(streamer, t.rgba, t.byte_size());
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, region.x, region.y, region.layer, w, h, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+atlas_region const* get_atlas_region(sys::state& state, dcon::texture_id id) {
+	auto& atlas = state.open_gl.atlas;
+	if(!atlas.handle || id.index() >= int32_t(atlas.regions.size()) || !atlas.regions[id].valid())
+		return nullptr;
+
+	auto& asset_texture = state.open_gl.asset_textures[id];
+	if(!asset_texture.atlas_loaded && !asset_texture.atlas_streaming) {
+		if(id.index() < int32_t(state.ui_defs.textures.size())) {
+			auto fname = state.ui_defs.textures[id];
+			request_texture_load(state, id, simple_fs::win1250_to_native(state.to_string_view(fname)), true);
+		}
+	}
+	return &atlas.regions[id];
+}
+
+atlas_region const* get_flag_atlas_region(sys::state& state, dcon::national_identity_id nat_id, culture::flag_type type) {
+	auto& atlas = state.open_gl.atlas;
+	auto id = get_flag_texture_id(state, nat_id, type);
+	if(!atlas.handle || id.index() >= int32_t(atlas.regions.size()) || !atlas.regions[id].valid())
+		return nullptr;
+
+	auto& asset_texture = state.open_gl.asset_textures[id];
+	if(!asset_texture.atlas_loaded && !asset_texture.atlas_streaming)
+		request_texture_load(state, id, get_flag_file_name(state, nat_id, type), true);
+	return &atlas.regions[id];
+}
+
+// Reads just enough of the file to learn the size of the image; returns false if there is no such image
+bool probe_texture_size(simple_fs::directory const& root, native_string const& file_name, int32_t& size_x, int32_t& size_y) {
+	auto name_length = file_name.length();
+	if(name_length > 4) {
+		auto file = open_file(root, file_name.substr(0, name_length - 3) + NATIVE("dds"));
+		if(file) {
+			auto content = simple_fs::view_contents(*file);
+			DDS_header header;
+			if(content.file_size >= sizeof(DDS_header)) {
+				memcpy(&header, content.data, sizeof(DDS_header));
+				if(header.dwMagic == (('D' << 0) | ('D' << 8) | ('S' << 16) | (' ' << 24))) {
+					size_x = int32_t(header.dwWidth);
+					size_y = int32_t(header.dwHeight);
+					return true;
+				}
+			}
+		}
+	}
+	auto file = open_file(root, file_name);
+	if(file) {
+		auto content = simple_fs::view_contents(*file);
+		int32_t channels = 0;
+		return stbi_info_from_memory(reinterpret_cast<uint8_t const*>(content.data), int32_t(content.file_size), &size_x, &size_y, &channels) != 0;
+	}
+	return false;
+}
+
+bool get_texture_size(sys::state& state, dcon::texture_id id, int32_t& size_x, int32_t& size_y) {
+	auto& asset_texture = state.open_gl.asset_textures[id];
+	if(asset_texture.loaded) {
+		size_x = asset_texture.size_x;
+		size_y = asset_texture.size_y;
+		return true;
+	}
+	// not uploaded yet (or still streaming), so the header of the file is the only place that knows
+	auto name = simple_fs::win1250_to_native(state.to_string_view(state.ui_defs.textures[id]));
+	return probe_texture_size(get_root(state.common_fs), name, size_x, size_y);
+}
+
+void build_texture_atlas(sys::state& state) {
+	auto& atlas = state.open_gl.atlas;
+	auto const texture_count = uint32_t(state.open_gl.asset_textures.size());
+	auto const ui_texture_count = uint32_t(state.ui_defs.textures.size());
+
+	// the file name of every texture slot; flag slots without a nation are left empty
+	std::vector<native_string> names(texture_count);
+	for(uint32_t i = 0; i < ui_texture_count; ++i) {
+		names[i] = simple_fs::win1250_to_native(state.to_string_view(state.ui_defs.textures[dcon::texture_id(dcon::texture_id::value_base_t(i))]));
+	}
+	state.world.for_each_national_identity([&](dcon::national_identity_id ident) {
+		for(auto type : state.flag_types) {
+			auto id = get_flag_texture_id(state, ident, type);
+			if(uint32_t(id.index()) < texture_count)
+				names[id.index()] = get_flag_file_name(state, ident, type);
+		}
+	});
+
+	/*
+	The packing depends on nothing but the dimensions of each image, so those are what the cache is keyed on. Only the image
+	headers are read, but there are a lot of files, so this is spread over the worker threads.
+	*/
+	auto root = get_root(state.common_fs);
+	std::vector<int32_t> sizes_x(texture_count, 0);
+	std::vector<int32_t> sizes_y(texture_count, 0);
+	concurrency::parallel_for(uint32_t(0), texture_count, [&](uint32_t i) {
+		if(!names[i].empty() && !probe_texture_size(root, names[i], sizes_x[i], sizes_y[i])) {
+			sizes_x[i] = 0;
+			sizes_y[i] = 0;
+		}
+	});
+
+	uint64_t files_hash = 0xcbf29ce484222325ull; // FNV-1a
+	auto mix = [&](uint64_t v) {
+		files_hash ^= v;
+		files_hash *= 0x100000001b3ull;
+	};
+	auto mix32 = [&](int32_t v) {
+		for(uint32_t b = 0; b < 4; ++b)
+			mix((uint32_t(v) >> (8 * b)) & 0xFF);
+	};
+	for(uint32_t i = 0; i < texture_count; ++i) {
+		for(auto c : names[i])
+			mix(uint64_t(c));
+		mix(0xFF);
+		mix32(sizes_x[i]);
+		mix32(sizes_y[i]);
+	}
+
+	atlas_cache_header expected;
+	expected.version = texture_atlas::cache_version;
+	expected.texture_count = texture_count;
+	expected.max_texture_size = uint32_t(texture_atlas::max_texture_size);
+	expected.layer_size = uint32_t(texture_atlas::layer_size);
+	expected.files_hash = files_hash;
+
+	atlas.regions.resize(texture_count);
+	atlas.layer_count = 0;
+
+	auto cache_dir = simple_fs::get_or_create_scenario_directory();
+	bool cache_valid = false;
+	if(auto cache_file = simple_fs::open_file(cache_dir, NATIVE("texture_atlas.bin")); cache_file) {
+		auto content = simple_fs::view_contents(*cache_file);
+		atlas_cache_header header;
+		if(content.file_size == sizeof(atlas_cache_header) + sizeof(atlas_region) * texture_count) {
+			memcpy(&header, content.data, sizeof(atlas_cache_header));
+			if(header.version == expected.version && header.texture_count == expected.texture_count
+				&& header.max_texture_size == expected.max_texture_size && header.layer_size == expected.layer_size
+				&& header.files_hash == expected.files_hash) {
+				memcpy(atlas.regions.data(), content.data + sizeof(atlas_cache_header), sizeof(atlas_region) * texture_count);
+				atlas.layer_count = header.layer_count;
+				cache_valid = true;
+			}
+		}
+	}
+
+	if(!cache_valid) {
+		std::vector<uint32_t> candidates;
+		for(uint32_t i = 0; i < texture_count; ++i) {
+			if(sizes_x[i] > 0 && sizes_y[i] > 0 && sizes_x[i] <= texture_atlas::max_texture_size && sizes_y[i] <= texture_atlas::max_texture_size)
+				candidates.push_back(i);
+		}
+		std::sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) {
+			if(sizes_y[a] != sizes_y[b])
+				return sizes_y[a] > sizes_y[b];
+			if(sizes_x[a] != sizes_x[b])
+				return sizes_x[a] > sizes_x[b];
+			return a < b;
+		});
+
+		// shelf packing: fill rows left to right, a row is as tall as its first (tallest) entry
+		int32_t shelf_x = 0;
+		int32_t shelf_y = 0;
+		int32_t shelf_height = 0;
+		for(auto i : candidates) {
+			if(atlas.layer_count == 0) {
+				atlas.layer_count = 1;
+			}
+			if(shelf_x + sizes_x[i] > texture_atlas::layer_size) {
+				shelf_y += shelf_height;
+				shelf_x = 0;
+				shelf_height = 0;
+			}
+			if(shelf_y + sizes_y[i] > texture_atlas::layer_size) {
+				++atlas.layer_count;
+				shelf_x = 0;
+				shelf_y = 0;
+				shelf_height = 0;
+			}
+			auto& region = atlas.regions[dcon::texture_id(dcon::texture_id::value_base_t(i))];
+			region.layer = uint16_t(atlas.layer_count - 1);
+			region.x = uint16_t(shelf_x);
+			region.y = uint16_t(shelf_y);
+			region.width = uint16_t(sizes_x[i]);
+			region.height = uint16_t(sizes_y[i]);
+
+			shelf_x += sizes_x[i];
+			shelf_height = std::max(shelf_height, sizes_y[i]);
+		}
+
+		expected.layer_count = atlas.layer_count;
+		std::vector<char> cache_data(sizeof(atlas_cache_header) + sizeof(atlas_region) * texture_count);
+		memcpy(cache_data.data(), &expected, sizeof(atlas_cache_header));
+		memcpy(cache_data.data() + sizeof(atlas_cache_header), atlas.regions.data(), sizeof(atlas_region) * texture_count);
+		simple_fs::write_file(cache_dir, NATIVE("texture_atlas.bin"), cache_data.data(), uint32_t(cache_data.size()));
+	}
+
+	if(atlas.layer_count == 0)
+		return;
+
+	glGenTextures(1, &atlas.handle);
+	if(atlas.handle) {
+		glBindTexture(GL_TEXTURE_2D_ARRAY, atlas.handle);
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, texture_atlas::layer_size, texture_atlas::layer_size, GLsizei(atlas.layer_count));
+		// the storage starts out undefined; regions are transparent until their texture has been streamed in
+		std::vector<uint8_t> clear_data(size_t(texture_atlas::layer_size) * texture_atlas::layer_size * 4, 0);
+		for(uint32_t l = 0; l < atlas.layer_count; ++l) {
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, GLint(l), texture_atlas::layer_size, texture_atlas::layer_size, 1, GL_RGBA, GL_UNSIGNED_BYTE, clear_data.data());
+		}
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	}
+}
+
 data_texture::data_texture(int32_t sz, int32_t ch) {
 	size = sz;
 	channels = ch;
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
 #include "container_types.hpp"
 
 #ifndef GLEW_STATIC
@@ -7,6 +12,10 @@
 #endif
 #include "glew.h"
 
+namespace ui {
+struct element_data;
+}
+
 namespace ogl {
 
 class texture;
@@ -14,6 +23,26 @@ class texture;
 GLuint get_texture_handle(sys::state& state, dcon::texture_id id, bool keep_data);
 GLuint get_flag_handle(sys::state& state, dcon::national_identity_id nat_id, culture::flag_type type);
 
+// The size of the texture, read from the header of its file if it hasn't been uploaded yet; returns false if there is no such image
+bool get_texture_size(sys::state& state, dcon::texture_id id, int32_t& size_x, int32_t& size_y);
+// Queues the texture to be read and decoded in the background, if it isn't loaded or loading already
+void prefetch_texture(sys::state& state, dcon::texture_id id);
+// Prefetches every texture used by the gui definition and its children (i.e. a window that is about to be opened)
+void prefetch_textures(sys::state& state, ui::element_data const& def);
+// Uploads textures finished by the streaming workers; called once per frame from the render thread
+void process_texture_uploads(sys::state& state);
+
+void start_texture_streaming(sys::state& state);
+void stop_texture_streaming(sys::state& state);
+
+struct atlas_region;
+// Packs the small ui textures and flags into the atlas (reusing the packing cached in the scenario directory if it is
+// still valid) and creates the array texture backing it; the pixels themselves are streamed in on first use
+void build_texture_atlas(sys::state& state);
+// Returns the region of the atlas holding the texture, or nullptr if the texture is not part of the atlas
+atlas_region const* get_atlas_region(sys::state& state, dcon::texture_id id);
+atlas_region const* get_flag_atlas_region(sys::state& state, dcon::national_identity_id nat_id, culture::flag_type type);
+
 enum {
 	SOIL_FLAG_POWER_OF_TWO = 1,
 	SOIL_FLAG_MIPMAPS = 2,
@@ -32,6 +61,25 @@ enum {
 	SOIL_FLAG_NEAREST = 16384,
 };
 
+struct dds_image {
+	unsigned char* data = nullptr; // all mip levels, already swizzled to RGB(A) if uncompressed; owned by whoever parsed it (malloc)
+	unsigned int width = 0;
+	unsigned int height = 0;
+	unsigned int format = 0;
+	unsigned int main_size = 0;
+	unsigned int full_size = 0;
+	int block_size = 16;
+	int mipmaps = 0;
+	bool uncompressed = false;
+};
+
+// parsing only touches memory and may be done on any thread; uploading must happen on the thread that owns the context
+bool SOIL_parse_DDS_from_memory(
+		const unsigned char* const buffer,
+		unsigned int buffer_length,
+		dds_image& image);
+unsigned int SOIL_upload_DDS(dds_image const& image, unsigned char const* pixels, int flags);
+
 unsigned int SOIL_direct_load_DDS_from_memory(
 		const unsigned char* const buffer,
 		unsigned int buffer_length,
@@ -48,6 +96,9 @@ public:
 	int32_t channels = 4;
 
 	bool loaded = false;
+	bool streaming = false; // a background load has been requested and has not been uploaded yet
+	bool atlas_loaded = false; // as above, but for the copy of the pixels in the texture atlas
+	bool atlas_streaming = false;
 
 	texture() { }
 	texture(texture const&) = delete;
@@ -62,6 +113,8 @@ public:
 	friend GLuint get_texture_handle(sys::state& state, dcon::texture_id id, bool keep_data);
 	friend GLuint load_file_and_return_handle(native_string const& native_name, simple_fs::file_system const& fs, texture& asset_texture, bool keep_data);
 	friend GLuint get_flag_handle(sys::state& state, dcon::national_identity_id nat_id, culture::flag_type type);
+	friend void process_texture_uploads(sys::state& state);
+	friend atlas_region const* get_atlas_region(sys::state& state, dcon::texture_id id);
 };
 
 class data_texture {
@@ -84,6 +137,99 @@ public:
 	~data_texture();
 };
 
+// Background texture loading: worker threads read and decode files, the render thread uploads the results
+// through pixel buffer objects, a few per frame, while the texture shows a (transparent) placeholder
+
+struct texture_load_request {
+	dcon::texture_id id;
+	native_string file_name;
+	bool to_atlas = false;
+};
+
+struct decoded_texture {
+	dcon::texture_id id;
+	bool to_atlas = false; // if set, the pixels are always decoded into rgba
+	dds_image dds; // set when loaded from a dds file
+	uint8_t* rgba = nullptr; // set when decoded by stb (from STBI_MALLOC)
+	int32_t size_x = 0;
+	int32_t size_y = 0;
+	bool failed = false;
+
+	uint32_t byte_size() const {
+		return dds.data ? dds.full_size : uint32_t(size_x * size_y * 4);
+	}
+};
+
+class texture_streamer {
+public:
+	static constexpr uint32_t worker_count = 2;
+	static constexpr uint32_t upload_buffer_count = 4;
+	static constexpr uint32_t upload_bytes_per_frame = 4 * 1024 * 1024; // at least one texture is uploaded per frame regardless
+
+	std::thread workers[worker_count];
+	std::mutex request_lock;
+	std::condition_variable request_signal;
+	std::deque<texture_load_request> requests; // guarded by request_lock
+	bool quit = false; // guarded by request_lock
+
+	std::mutex result_lock;
+	std::vector<decoded_texture> results; // guarded by result_lock
+
+	// render thread only
+	std::deque<decoded_texture> pending_uploads;
+	GLuint upload_buffers[upload_buffer_count] = { 0 };
+	uint32_t next_upload_buffer = 0;
+	GLuint placeholder = 0;
+
+	texture_streamer() { }
+	texture_streamer(texture_streamer const&) = delete;
+	texture_streamer& operator=(texture_streamer const&) = delete;
+	~texture_streamer();
+
+	void stop();
+};
+
+// Small textures (icons, flags, ...) are packed into the layers of one array texture so that rows of them can be
+// drawn without rebinding textures
+
+struct atlas_region {
+	uint16_t layer = 0;
+	uint16_t x = 0;
+	uint16_t y = 0;
+	uint16_t width = 0;
+	uint16_t height = 0;
+
+	bool valid() const {
+		return width != 0;
+	}
+};
+
+// written to the cache file as is, so it is laid out without any padding
+struct atlas_cache_header {
+	uint64_t files_hash = 0; // the file names and image dimensions
+	uint32_t version = 0;
+	uint32_t texture_count = 0;
+	uint32_t max_texture_size = 0;
+	uint32_t layer_size = 0;
+	uint32_t layer_count = 0;
+	uint32_t reserved = 0;
+};
+static_assert(sizeof(atlas_cache_header) == 32);
+
+class texture_atlas {
+public:
+	static constexpr uint32_t cache_version = 3;
+	static constexpr int32_t layer_size = 1024;
+	// Textures no larger than this in either dimension are packed. The bulk of the small textures are the flags (93x64 in vanilla)
+	// and the icons, which this covers; anything larger is drawn rarely enough that its own texture is fine, and would leave
+	// large gaps in a 1024x1024 layer.
+	static constexpr int32_t max_texture_size = 96;
+
+	GLuint handle = 0;
+	uint32_t layer_count = 0;
+	tagged_vector<atlas_region, dcon::texture_id> regions; // indexed like asset_textures; a default region means not packed
+};
+
 struct font_texture_result {
 	uint32_t handle = 0;
 	uint32_t size = 0;
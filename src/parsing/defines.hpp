@@ -645,7 +645,19 @@
 	LUA_DEFINES_LIST_ELEMENT(cities_special_buildings_pool_size, 64.000000) \
 	LUA_DEFINES_LIST_ELEMENT(cities_size_max_population_k, 1000.000000) \
 	/* Non-vanilla defines */ \
-	LUA_DEFINES_LIST_ELEMENT(factories_per_state, 8.000000)
+	LUA_DEFINES_LIST_ELEMENT(factories_per_state, 8.000000) \
+	/* days it takes each staggered pop update to visit every pop, 0 = the length of the month (see demographics::pop_update_scheduler) */ \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_ideologies, 0.000000) \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_issues, 0.000000) \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_militancy, 0.000000) \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_consciousness, 0.000000) \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_literacy, 0.000000) \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_growth, 0.000000) \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_type_changes, 0.000000) \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_assimilation, 0.000000) \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_internal_migration, 0.000000) \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_colonial_migration, 0.000000) \
+	LUA_DEFINES_LIST_ELEMENT(pop_update_period_immigration, 0.000000)
 
 namespace parsing {
 struct defines {
@@ -342,7 +342,7 @@ void tr_scope_this(token_generator& gen, error_handler& err, trigger_building_co
 	auto payload_size_offset = context.compiled_trigger.size() - 1;
 
 	auto old_main = context.main_slot;
-	context.main_slot = context.this_slot;
+	context.main_slot = context.read_this_slot();
 	parse_trigger_body(gen, err, context);
 	context.main_slot = old_main;
 
@@ -675,12 +675,16 @@ void make_value_modifier_segment(token_generator& gen, error_handler& err, trigg
 
 dcon::value_modifier_key make_value_modifier(token_generator& gen, error_handler& err, trigger_building_context& context) {
 	auto old_count = context.outer_context.state.value_modifier_segments.size();
+	auto old_this_referenced = context.this_slot_referenced;
+	context.this_slot_referenced = false;
 	value_modifier_definition result = parse_value_modifier_definition(gen, err, context);
 
 	auto overall_factor = result.factor;
 	auto new_count = context.outer_context.state.value_modifier_segments.size();
+	auto this_referenced = context.this_slot_referenced;
+	context.this_slot_referenced = old_this_referenced || this_referenced;
 
-	return context.outer_context.state.value_modifiers.push_back(sys::value_modifier_description{ overall_factor, uint16_t(old_count), uint16_t(new_count - old_count) });
+	return context.outer_context.state.value_modifiers.push_back(sys::value_modifier_description{ overall_factor, uint16_t(old_count), uint16_t(new_count - old_count), this_referenced });
 }
 
 void trigger_body::is_canal_enabled(association_type a, int32_t value, error_handler& err, int32_t line, trigger_building_context& context) {
@@ -23,9 +23,16 @@ struct trigger_building_context {
 	trigger::slot_contents this_slot = trigger::slot_contents::empty;
 	trigger::slot_contents from_slot = trigger::slot_contents::empty;
 
+	bool this_slot_referenced = false; // set whenever the compiled trigger reads the this slot
+
 
 	trigger_building_context(scenario_building_context& outer_context, trigger::slot_contents main_slot, trigger::slot_contents this_slot, trigger::slot_contents from_slot) : outer_context(outer_context), main_slot(main_slot), this_slot(this_slot), from_slot(from_slot) { }
 
+	trigger::slot_contents read_this_slot() {
+		this_slot_referenced = true;
+		return this_slot;
+	}
+
 	void add_float_to_payload(float f) {
 		union {
 			struct {
@@ -254,6 +261,13 @@ inline bool is_from(std::string_view value) {
 inline bool is_this(std::string_view value) {
 	return is_fixed_token_ci(value.data(), value.data() + value.length(), "this");
 }
+inline bool is_this(std::string_view value, trigger_building_context& context) {
+	if(is_this(value)) {
+		context.this_slot_referenced = true;
+		return true;
+	}
+	return false;
+}
 inline bool is_reb(std::string_view value) {
 	return is_fixed_token_ci(value.data(), value.data() + value.length(), "reb");
 }
@@ -319,7 +333,7 @@ struct trigger_body {
 		}
 	}
 	void has_cultural_sphere(association_type a, bool value, error_handler& err, int32_t line, trigger_building_context& context) {
-		if(context.main_slot == trigger::slot_contents::nation && context.this_slot == trigger::slot_contents::nation) {
+		if(context.main_slot == trigger::slot_contents::nation && context.read_this_slot() == trigger::slot_contents::nation) {
 			context.compiled_trigger.push_back(uint16_t(trigger::has_cultural_sphere | trigger::no_payload | association_to_bool_code(a, value)));
 		} else {
 			err.accumulated_errors += "has_cultural_sphere trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -1064,7 +1078,7 @@ struct trigger_body {
 	}
 	void brigades_compare(association_type a, float value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(context.this_slot == trigger::slot_contents::nation) {
+			if(context.read_this_slot() == trigger::slot_contents::nation) {
 				context.compiled_trigger.push_back(uint16_t(trigger::brigades_compare_this | association_to_trigger_code(a)));
 			} else if(context.from_slot == trigger::slot_contents::nation) {
 				context.compiled_trigger.push_back(uint16_t(trigger::brigades_compare_from | association_to_trigger_code(a)));
@@ -1491,7 +1505,7 @@ struct trigger_body {
 	}
 
 	void culture(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
-		if(is_this(value)) {
+		if(is_this(value, context)) {
 			if(context.main_slot == trigger::slot_contents::pop) {
 				if(context.main_slot == trigger::slot_contents::nation) {
 					context.compiled_trigger.push_back(uint16_t(trigger::culture_this_nation | trigger::no_payload | association_to_bool_code(a)));
@@ -1551,8 +1565,8 @@ struct trigger_body {
 		}
 	}
 	void has_pop_culture(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
-		if(is_this(value)) {
-			if(context.this_slot == trigger::slot_contents::pop) {
+		if(is_this(value, context)) {
+			if(context.read_this_slot() == trigger::slot_contents::pop) {
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::has_pop_culture_nation_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.main_slot == trigger::slot_contents::pop)
@@ -1588,8 +1602,8 @@ struct trigger_body {
 		}
 	}
 	void has_pop_religion(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
-		if(is_this(value)) {
-			if(context.this_slot == trigger::slot_contents::pop) {
+		if(is_this(value, context)) {
+			if(context.read_this_slot() == trigger::slot_contents::pop) {
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::has_pop_religion_nation_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.main_slot == trigger::slot_contents::pop)
@@ -1626,8 +1640,8 @@ struct trigger_body {
 	}
 
 	void culture_group(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
-		if(is_this(value)) {
-			if(context.this_slot == trigger::slot_contents::nation) {
+		if(is_this(value, context)) {
+			if(context.read_this_slot() == trigger::slot_contents::nation) {
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::culture_group_nation_this_nation | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.main_slot == trigger::slot_contents::pop)
@@ -1636,7 +1650,7 @@ struct trigger_body {
 					err.accumulated_errors += "culture_group = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 					return;
 				}
-			} else if(context.this_slot == trigger::slot_contents::state) {
+			} else if(context.read_this_slot() == trigger::slot_contents::state) {
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::culture_group_nation_this_state | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.main_slot == trigger::slot_contents::pop)
@@ -1645,7 +1659,7 @@ struct trigger_body {
 					err.accumulated_errors += "culture_group = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 					return;
 				}
-			} else if(context.this_slot == trigger::slot_contents::province) {
+			} else if(context.read_this_slot() == trigger::slot_contents::province) {
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::culture_group_nation_this_province | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.main_slot == trigger::slot_contents::pop)
@@ -1654,7 +1668,7 @@ struct trigger_body {
 					err.accumulated_errors += "culture_group = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 					return;
 				}
-			} else if(context.this_slot == trigger::slot_contents::pop) {
+			} else if(context.read_this_slot() == trigger::slot_contents::pop) {
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::culture_group_nation_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.main_slot == trigger::slot_contents::pop)
@@ -1711,8 +1725,8 @@ struct trigger_body {
 	}
 
 	void religion(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
-		if(is_this(value)) {
-			if(context.this_slot == trigger::slot_contents::nation) {
+		if(is_this(value, context)) {
+			if(context.read_this_slot() == trigger::slot_contents::nation) {
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::religion_nation_this_nation | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.main_slot == trigger::slot_contents::pop)
@@ -1721,7 +1735,7 @@ struct trigger_body {
 					err.accumulated_errors += "religion = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 					return;
 				}
-			} else if(context.this_slot == trigger::slot_contents::state) {
+			} else if(context.read_this_slot() == trigger::slot_contents::state) {
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::religion_nation_this_state | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.main_slot == trigger::slot_contents::pop)
@@ -1730,7 +1744,7 @@ struct trigger_body {
 					err.accumulated_errors += "religion = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 					return;
 				}
-			} else if(context.this_slot == trigger::slot_contents::province) {
+			} else if(context.read_this_slot() == trigger::slot_contents::province) {
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::religion_nation_this_province | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.main_slot == trigger::slot_contents::pop)
@@ -1739,7 +1753,7 @@ struct trigger_body {
 					err.accumulated_errors += "religion = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 					return;
 				}
-			} else if(context.this_slot == trigger::slot_contents::pop) {
+			} else if(context.read_this_slot() == trigger::slot_contents::pop) {
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::religion_nation_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.main_slot == trigger::slot_contents::pop)
@@ -1864,19 +1878,19 @@ struct trigger_body {
 				err.accumulated_errors += "is_cultural_union = bool trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 				return;
 			}
-		} else if(is_this(value)) {
-			if(context.main_slot == trigger::slot_contents::pop && context.this_slot == trigger::slot_contents::nation)
+		} else if(is_this(value, context)) {
+			if(context.main_slot == trigger::slot_contents::pop && context.read_this_slot() == trigger::slot_contents::nation)
 				context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_this_self_pop | trigger::no_payload | association_to_bool_code(a)));
-			else if(context.main_slot == trigger::slot_contents::pop && context.this_slot == trigger::slot_contents::pop)
+			else if(context.main_slot == trigger::slot_contents::pop && context.read_this_slot() == trigger::slot_contents::pop)
 				context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_pop_this_pop | trigger::no_payload | association_to_bool_code(a)));
 			else if(context.main_slot == trigger::slot_contents::nation) {
-				if(context.this_slot == trigger::slot_contents::pop)
+				if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_this_pop | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::nation)
+				else if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_this_nation | trigger::no_payload | association_to_bool_code(a)));
 				else if(context.from_slot == trigger::slot_contents::rebel)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_this_rebel | trigger::no_payload | association_to_bool_code(a)));
@@ -1893,13 +1907,13 @@ struct trigger_body {
 
 				if(context.main_slot == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_tag_nation | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_tag_this_pop | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_tag_this_state | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_tag_this_province | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::nation)
+				else if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_cultural_union_tag_this_nation | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "is_cultural_union = tag trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -1987,14 +2001,14 @@ struct trigger_body {
 	}
 
 	void is_core(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
-		if(is_this(value) && context.main_slot == trigger::slot_contents::province) {
-			if(context.this_slot == trigger::slot_contents::nation) {
+		if(is_this(value, context) && context.main_slot == trigger::slot_contents::province) {
+			if(context.read_this_slot() == trigger::slot_contents::nation) {
 				context.compiled_trigger.push_back(uint16_t(trigger::is_core_this_nation | trigger::no_payload | association_to_bool_code(a)));
-			} else if(context.this_slot == trigger::slot_contents::state) {
+			} else if(context.read_this_slot() == trigger::slot_contents::state) {
 				context.compiled_trigger.push_back(uint16_t(trigger::is_core_this_state | trigger::no_payload | association_to_bool_code(a)));
-			} else if(context.this_slot == trigger::slot_contents::province) {
+			} else if(context.read_this_slot() == trigger::slot_contents::province) {
 				context.compiled_trigger.push_back(uint16_t(trigger::is_core_this_province | trigger::no_payload | association_to_bool_code(a)));
-			} else if(context.this_slot == trigger::slot_contents::pop) {
+			} else if(context.read_this_slot() == trigger::slot_contents::pop) {
 				context.compiled_trigger.push_back(uint16_t(trigger::is_core_this_pop | trigger::no_payload | association_to_bool_code(a)));
 			} else {
 				err.accumulated_errors += "is_core = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2058,14 +2072,14 @@ struct trigger_body {
 		context.add_float_to_payload(value);
 	}
 	void num_of_cities(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
-		if(is_this(value) && context.main_slot == trigger::slot_contents::nation) {
-			if(context.this_slot == trigger::slot_contents::nation) {
+		if(is_this(value, context) && context.main_slot == trigger::slot_contents::nation) {
+			if(context.read_this_slot() == trigger::slot_contents::nation) {
 				context.compiled_trigger.push_back(uint16_t(trigger::num_of_cities_this_nation | trigger::no_payload | association_to_trigger_code(a)));
-			} else if(context.this_slot == trigger::slot_contents::state) {
+			} else if(context.read_this_slot() == trigger::slot_contents::state) {
 				context.compiled_trigger.push_back(uint16_t(trigger::num_of_cities_this_province | trigger::no_payload | association_to_trigger_code(a)));
-			} else if(context.this_slot == trigger::slot_contents::province) {
+			} else if(context.read_this_slot() == trigger::slot_contents::province) {
 				context.compiled_trigger.push_back(uint16_t(trigger::num_of_cities_this_state | trigger::no_payload | association_to_trigger_code(a)));
-			} else if(context.this_slot == trigger::slot_contents::pop) {
+			} else if(context.read_this_slot() == trigger::slot_contents::pop) {
 				context.compiled_trigger.push_back(uint16_t(trigger::num_of_cities_this_pop | trigger::no_payload | association_to_trigger_code(a)));
 			} else {
 				err.accumulated_errors += "num_of_cities = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2115,14 +2129,14 @@ struct trigger_body {
 	}
 	void owned_by(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::province) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::pop)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::owned_by_this_pop | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::owned_by_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::owned_by_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::nation)
+				else if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::owned_by_this_nation | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "owned_by = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2193,8 +2207,8 @@ struct trigger_body {
 
 	void continent(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation) {
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation) {
 					context.compiled_trigger.push_back(uint16_t(trigger::continent_nation_this | trigger::no_payload | association_to_bool_code(a)));
 				} else {
 					err.accumulated_errors += "continent = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2215,8 +2229,8 @@ struct trigger_body {
 				return;
 			}
 		} else if(context.main_slot == trigger::slot_contents::state) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation) {
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation) {
 					context.compiled_trigger.push_back(uint16_t(trigger::continent_state_this | trigger::no_payload | association_to_bool_code(a)));
 				} else {
 					err.accumulated_errors += "continent = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2237,8 +2251,8 @@ struct trigger_body {
 				return;
 			}
 		} else if(context.main_slot == trigger::slot_contents::province) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation) {
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation) {
 					context.compiled_trigger.push_back(uint16_t(trigger::continent_province_this | trigger::no_payload | association_to_bool_code(a)));
 				} else {
 					err.accumulated_errors += "continent = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2259,8 +2273,8 @@ struct trigger_body {
 				return;
 			}
 		} else if(context.main_slot == trigger::slot_contents::pop) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation) {
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation) {
 					context.compiled_trigger.push_back(uint16_t(trigger::continent_pop_this | trigger::no_payload | association_to_bool_code(a)));
 				} else {
 					err.accumulated_errors += "continent = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2287,14 +2301,14 @@ struct trigger_body {
 	}
 	void casus_belli(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::pop)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::casus_belli_this_pop | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::casus_belli_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::casus_belli_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::nation)
+				else if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::casus_belli_this_nation | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "casus_belli = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2326,14 +2340,14 @@ struct trigger_body {
 
 	void military_access(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::pop)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::military_access_this_pop | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::military_access_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::military_access_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::nation)
+				else if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::military_access_this_nation | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "military_access = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2365,14 +2379,14 @@ struct trigger_body {
 
 	void prestige(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::pop)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::prestige_this_pop | trigger::no_payload | association_to_trigger_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::prestige_this_state | trigger::no_payload | association_to_trigger_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::prestige_this_province | trigger::no_payload | association_to_trigger_code(a)));
-				else if(context.this_slot == trigger::slot_contents::nation)
+				else if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::prestige_this_nation | trigger::no_payload | association_to_trigger_code(a)));
 				else {
 					err.accumulated_errors += "prestige = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2506,10 +2520,10 @@ struct trigger_body {
 
 	void tag(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::province)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::tag_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::nation)
+				else if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::tag_this_nation | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "tag = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2554,8 +2568,8 @@ struct trigger_body {
 	}
 	void neighbour(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::neighbour_this | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "neighbour = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2586,14 +2600,14 @@ struct trigger_body {
 	}
 	void units_in_province(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::province) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::units_in_province_this_nation | trigger::no_payload | association_to_trigger_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::units_in_province_this_state | trigger::no_payload | association_to_trigger_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::units_in_province_this_province | trigger::no_payload | association_to_trigger_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::units_in_province_this_pop | trigger::no_payload | association_to_trigger_code(a)));
 				else {
 					err.accumulated_errors += "units_in_province = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2617,14 +2631,14 @@ struct trigger_body {
 	}
 	void war_with(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::war_with_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::war_with_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::war_with_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::war_with_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "war_with = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2783,54 +2797,54 @@ struct trigger_body {
 		}
 	}
 	void is_primary_culture(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
-		if(is_this(value)) {
+		if(is_this(value, context)) {
 			if(context.main_slot == trigger::slot_contents::nation) {
-				if(context.this_slot == trigger::slot_contents::nation)
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_nation_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_nation_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_nation_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_nation_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "is_primary_culture = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 					return;
 				}
 			} else if(context.main_slot == trigger::slot_contents::state) {
-				if(context.this_slot == trigger::slot_contents::nation)
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_state_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_state_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_state_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_state_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "is_primary_culture = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 					return;
 				}
 			} else if(context.main_slot == trigger::slot_contents::province) {
-				if(context.this_slot == trigger::slot_contents::nation)
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_province_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_province_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_province_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_province_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "is_primary_culture = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 					return;
 				}
 			} else if(context.main_slot == trigger::slot_contents::pop) {
-				if(context.this_slot == trigger::slot_contents::nation)
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_pop_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_pop_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_pop_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_primary_culture_pop_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "is_primary_culture = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -2876,14 +2890,14 @@ struct trigger_body {
 	}
 	void in_sphere(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::in_sphere_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::in_sphere_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::in_sphere_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::in_sphere_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "in_sphere = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3039,7 +3053,7 @@ struct trigger_body {
 	void has_culture_core(association_type a, bool value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::pop) {
 			context.compiled_trigger.push_back(uint16_t(trigger::has_culture_core | trigger::no_payload | association_to_bool_code(a, value)));
-		} else if(context.main_slot == trigger::slot_contents::province && context.this_slot == trigger::slot_contents::pop) {
+		} else if(context.main_slot == trigger::slot_contents::province && context.read_this_slot() == trigger::slot_contents::pop) {
 			context.compiled_trigger.push_back(uint16_t(trigger::has_culture_core_province_this_pop | trigger::no_payload | association_to_bool_code(a, value)));
 		} else {
 			err.accumulated_errors += "has_culture_core trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3073,14 +3087,14 @@ struct trigger_body {
 	}
 	void controlled_by(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::province) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::controlled_by_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::controlled_by_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::controlled_by_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::controlled_by_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "controlled_by = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3120,14 +3134,14 @@ struct trigger_body {
 	}
 	void truce_with(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::truce_with_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::truce_with_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::truce_with_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::truce_with_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "truce_with = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3158,14 +3172,14 @@ struct trigger_body {
 	}
 	void is_sphere_leader_of(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_sphere_leader_of_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_sphere_leader_of_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_sphere_leader_of_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_sphere_leader_of_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "is_sphere_leader_of = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3196,14 +3210,14 @@ struct trigger_body {
 	}
 	void constructing_cb(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::constructing_cb_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::constructing_cb_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::constructing_cb_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::constructing_cb_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "constructing_cb = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3234,14 +3248,14 @@ struct trigger_body {
 	}
 	void vassal_of(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::vassal_of_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::vassal_of_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::vassal_of_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::vassal_of_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "vassal_of = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3272,14 +3286,14 @@ struct trigger_body {
 	}
 	void substate_of(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::substate_of_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::substate_of_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::substate_of_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::substate_of_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "substate_of = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3310,14 +3324,14 @@ struct trigger_body {
 	}
 	void is_our_vassal(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_our_vassal_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_our_vassal_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_our_vassal_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::is_our_vassal_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "is_our_vassal = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3348,27 +3362,27 @@ struct trigger_body {
 	}
 	void this_culture_union(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::this_culture_union_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::this_culture_union_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::this_culture_union_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::this_culture_union_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "this_culture_union = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
 					return;
 				}
 			} else if(is_fixed_token_ci(value.data(), value.data() + value.length(), "this_union")) {
-				if(context.this_slot == trigger::slot_contents::nation)
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::this_culture_union_this_union_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::this_culture_union_this_union_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::this_culture_union_this_union_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::this_culture_union_this_union_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "this_culture_union = this_union trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3399,14 +3413,14 @@ struct trigger_body {
 	}
 	void alliance_with(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::alliance_with_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::alliance_with_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::alliance_with_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::alliance_with_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "alliance_with = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3437,14 +3451,14 @@ struct trigger_body {
 	}
 	void in_default(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::in_default_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::in_default_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::in_default_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::in_default_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "in_default = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3475,14 +3489,14 @@ struct trigger_body {
 	}
 	void industrial_score(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::industrial_score_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::industrial_score_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::industrial_score_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::industrial_score_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "industrial_score = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3506,14 +3520,14 @@ struct trigger_body {
 	}
 	void military_score(association_type a, std::string_view value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(context.main_slot == trigger::slot_contents::nation) {
-			if(is_this(value)) {
-				if(context.this_slot == trigger::slot_contents::nation)
+			if(is_this(value, context)) {
+				if(context.read_this_slot() == trigger::slot_contents::nation)
 					context.compiled_trigger.push_back(uint16_t(trigger::military_score_this_nation | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::state)
+				else if(context.read_this_slot() == trigger::slot_contents::state)
 					context.compiled_trigger.push_back(uint16_t(trigger::military_score_this_state | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::province)
+				else if(context.read_this_slot() == trigger::slot_contents::province)
 					context.compiled_trigger.push_back(uint16_t(trigger::military_score_this_province | trigger::no_payload | association_to_bool_code(a)));
-				else if(context.this_slot == trigger::slot_contents::pop)
+				else if(context.read_this_slot() == trigger::slot_contents::pop)
 					context.compiled_trigger.push_back(uint16_t(trigger::military_score_this_pop | trigger::no_payload | association_to_bool_code(a)));
 				else {
 					err.accumulated_errors += "military_score = this trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3567,10 +3581,10 @@ struct trigger_body {
 				return;
 			}
 			context.compiled_trigger.push_back(trigger::payload(uint16_t(value.value_)).value);
-		} else if(is_this(value.who)) {
-			if(context.this_slot == trigger::slot_contents::nation)
+		} else if(is_this(value.who, context)) {
+			if(context.read_this_slot() == trigger::slot_contents::nation)
 				context.compiled_trigger.push_back(uint16_t(trigger::diplomatic_influence_this_nation | association_to_trigger_code(value.a)));
-			else if(context.this_slot == trigger::slot_contents::province)
+			else if(context.read_this_slot() == trigger::slot_contents::province)
 				context.compiled_trigger.push_back(uint16_t(trigger::diplomatic_influence_this_province | association_to_trigger_code(value.a)));
 			else {
 				err.accumulated_errors += "diplomatic_influence trigger used in an incorrect scope type " + slot_contents_to_string(context.main_slot) + "(" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3592,7 +3606,7 @@ struct trigger_body {
 	}
 	void pop_unemployment(tr_pop_unemployment const& value, error_handler& err, int32_t line, trigger_building_context& context) {
 		if(is_from(value.type)) {
-			if(context.this_slot != trigger::slot_contents::pop) {
+			if(context.read_this_slot() != trigger::slot_contents::pop) {
 				err.accumulated_errors += "pop_unemployment = this trigger used in an invalid context (" + err.file_name + ", line " + std::to_string(line) + ")\n";
 				return;
 			} else if(context.main_slot == trigger::slot_contents::nation)
@@ -3641,10 +3655,10 @@ struct trigger_body {
 				return;
 			}
 			context.compiled_trigger.push_back(trigger::payload(int16_t(value.value_)).value);
-		} else if(is_this(value.who)) {
-			if(context.this_slot == trigger::slot_contents::nation)
+		} else if(is_this(value.who, context)) {
+			if(context.read_this_slot() == trigger::slot_contents::nation)
 				context.compiled_trigger.push_back(uint16_t(trigger::relation_this_nation | association_to_trigger_code(value.a)));
-			else if(context.this_slot == trigger::slot_contents::province)
+			else if(context.read_this_slot() == trigger::slot_contents::province)
 				context.compiled_trigger.push_back(uint16_t(trigger::relation_this_province | association_to_trigger_code(value.a)));
 			else {
 				err.accumulated_errors += "relation = this trigger used in an invalid context (" + err.file_name + ", line " + std::to_string(line) + ")\n";
@@ -3754,7 +3768,7 @@ struct trigger_body {
 			err.accumulated_errors += "can_build_in_province trigger used in an invalid context (" + err.file_name + ", line " + std::to_string(line) + ")\n";
 			return;
 		} else if(value.limit_to_world_greatest_level) {
-			if(context.this_slot == trigger::slot_contents::nation) {
+			if(context.read_this_slot() == trigger::slot_contents::nation) {
 				if(is_fixed_token_ci(value.building.data(), value.building.data() + value.building.length(), "railroad"))
 					context.compiled_trigger.push_back(uint16_t(trigger::can_build_in_province_railroad_yes_limit_this_nation | trigger::association_eq | trigger::no_payload));
 				else if(is_fixed_token_ci(value.building.data(), value.building.data() + value.building.length(), "naval_base"))
@@ -3773,7 +3787,7 @@ struct trigger_body {
 				return;
 			}
 		} else {
-			if(context.this_slot == trigger::slot_contents::nation) {
+			if(context.read_this_slot() == trigger::slot_contents::nation) {
 				if(is_fixed_token_ci(value.building.data(), value.building.data() + value.building.length(), "railroad"))
 					context.compiled_trigger.push_back(uint16_t(trigger::can_build_in_province_railroad_no_limit_this_nation | trigger::association_eq | trigger::no_payload));
 				else if(is_fixed_token_ci(value.building.data(), value.building.data() + value.building.length(), "naval_base"))
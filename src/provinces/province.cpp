@@ -696,15 +696,23 @@ void change_province_owner(sys::state& state, dcon::province_id id, dcon::nation
 			regs.push_back(r.get_regiment().id);
 		}
 		for(auto r : regs) {
-			state.world.delete_regiment(r);
+			military::delete_regiment(state, r);
 		}
 	}
 
+	for(auto p : state.world.province_get_pop_location(id)) { // counted again below, for the new owner
+		military::remove_pop_regiment_counts(state, p.get_pop());
+	}
+
 	state.world.province_set_nation_from_province_ownership(id, new_owner);
 	state.world.province_set_last_control_change(id, state.current_date);
 	state.world.province_set_nation_from_province_control(id, new_owner);
 	state.world.province_set_is_owner_core(id, bool(state.world.get_core_by_prov_tag_key(id, state.world.nation_get_identity_from_identity_holder(new_owner))));
 
+	for(auto p : state.world.province_get_pop_location(id)) {
+		military::update_pop_regiment_counts(state, p.get_pop());
+	}
+
 	if(old_si) {
 		dcon::province_id a_province;
 		province::for_each_province_in_state_instance(state, old_si, [&](auto p) { a_province = p; });
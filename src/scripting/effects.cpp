@@ -1268,12 +1268,14 @@ uint32_t ef_remove_core_reb(EFFECT_PARAMTERS) {
 uint32_t ef_change_region_name_state(EFFECT_PARAMTERS) {
 	auto def = ws.world.state_instance_get_definition(trigger::to_state(primary_slot));
 	ws.world.state_definition_set_name(def, trigger::payload(tval[1]).text_id);
+	ws.search_data.built = false;
 	return 0;
 }
 uint32_t ef_change_region_name_province(EFFECT_PARAMTERS) {
 	auto def = ws.world.province_get_state_from_abstract_state_membership(trigger::to_prov(primary_slot));
 	if(def) {
 		ws.world.state_definition_set_name(def, trigger::payload(tval[1]).text_id);
+		ws.search_data.built = false;
 	}
 	return 0;
 }
@@ -1359,6 +1361,7 @@ uint32_t ef_is_slave_state_yes(EFFECT_PARAMTERS) {
 }
 uint32_t ef_is_slave_pop_yes(EFFECT_PARAMTERS) {
 	ws.world.pop_set_poptype(trigger::to_pop(primary_slot), ws.culture_definitions.slaves);
+	military::update_pop_regiment_counts(ws, trigger::to_pop(primary_slot));
 	return 0;
 }
 uint32_t ef_research_points(EFFECT_PARAMTERS) {
@@ -2169,6 +2172,7 @@ uint32_t ef_release_vassal_random(EFFECT_PARAMTERS) {
 }
 uint32_t ef_change_province_name(EFFECT_PARAMTERS) {
 	ws.world.province_set_name(trigger::to_prov(primary_slot), trigger::payload(tval[1]).text_id);
+	ws.search_data.built = false;
 	return 0;
 }
 uint32_t ef_enable_canal(EFFECT_PARAMTERS) {
@@ -2208,6 +2212,7 @@ uint32_t ef_is_slave_state_no(EFFECT_PARAMTERS) {
 		for(auto pop : ws.world.province_get_pop_location(p)) {
 			if(pop.get_pop().get_poptype() == ws.culture_definitions.slaves) {
 				pop.get_pop().set_poptype(mine ? ws.culture_definitions.laborers : ws.culture_definitions.farmers);
+				military::update_pop_regiment_counts(ws, pop.get_pop());
 			}
 		}
 	});
@@ -2217,6 +2222,7 @@ uint32_t ef_is_slave_pop_no(EFFECT_PARAMTERS) {
 	if(ws.world.pop_get_poptype(trigger::to_pop(primary_slot)) == ws.culture_definitions.slaves) {
 		bool mine = ws.world.commodity_get_is_mine(ws.world.province_get_rgo(ws.world.pop_get_province_from_pop_location(trigger::to_pop(primary_slot))));
 		ws.world.pop_set_poptype(trigger::to_pop(primary_slot), mine ? ws.culture_definitions.laborers : ws.culture_definitions.farmers);
+		military::update_pop_regiment_counts(ws, trigger::to_pop(primary_slot));
 	}
 	return 0;
 }
@@ -2257,11 +2263,14 @@ uint32_t ef_reduce_pop(EFFECT_PARAMTERS) {
 	return 0;
 }
 uint32_t ef_move_pop(EFFECT_PARAMTERS) {
+	military::remove_pop_regiment_counts(ws, trigger::to_pop(primary_slot)); // they belong to the province it leaves
 	ws.world.pop_set_province_from_pop_location(trigger::to_pop(primary_slot), trigger::payload(tval[1]).prov_id);
+	military::update_pop_regiment_counts(ws, trigger::to_pop(primary_slot));
 	return 0;
 }
 uint32_t ef_pop_type(EFFECT_PARAMTERS) {
 	ws.world.pop_set_poptype(trigger::to_pop(primary_slot), trigger::payload(tval[1]).popt_id);
+	military::update_pop_regiment_counts(ws, trigger::to_pop(primary_slot));
 	return 0;
 }
 uint32_t ef_years_of_research(EFFECT_PARAMTERS) {
@@ -3506,6 +3515,7 @@ uint32_t ef_define_general(EFFECT_PARAMTERS) {
 	l.set_personality(trigger::payload(tval[2]).lead_id);
 	l.set_name(trigger::payload(tval[1]).unam_id);
 	l.set_nation_from_leader_loyalty(trigger::to_nation(primary_slot));
+	military::register_leader(ws, l);
 	return 0;
 }
 uint32_t ef_define_admiral(EFFECT_PARAMTERS) {
@@ -3516,6 +3526,7 @@ uint32_t ef_define_admiral(EFFECT_PARAMTERS) {
 	l.set_personality(trigger::payload(tval[2]).lead_id);
 	l.set_name(trigger::payload(tval[1]).unam_id);
 	l.set_nation_from_leader_loyalty(trigger::to_nation(primary_slot));
+	military::register_leader(ws, l);
 	return 0;
 }
 uint32_t ef_dominant_issue(EFFECT_PARAMTERS) {
@@ -1,5 +1,7 @@
 #include "sound.hpp"
 #include "system_state.hpp"
+#include <array>
+#include <atomic>
 
 #define MINIAUDIO_IMPLEMENTATION
 #include "miniaudio.h"
@@ -10,10 +12,20 @@ class audio_instance {
 public:
 	native_string filename;
 
-	audio_instance() = default;
+	// the decoded samples of a sound effect, in the engine's format; empty for music, which is streamed
+	float* pcm_frames = nullptr;
+	ma_uint64 frame_count = 0;
 
-	audio_instance& operator=(audio_instance const& o) {
-		filename = o.filename;
+	audio_instance() = default;
+	audio_instance(audio_instance const&) = delete;
+	audio_instance(audio_instance&& o) noexcept : filename(std::move(o.filename)), pcm_frames(o.pcm_frames), frame_count(o.frame_count) {
+		o.pcm_frames = nullptr;
+		o.frame_count = 0;
+	}
+	audio_instance& operator=(audio_instance&& o) noexcept {
+		std::swap(filename, o.filename);
+		std::swap(pcm_frames, o.pcm_frames);
+		std::swap(frame_count, o.frame_count);
 		return *this;
 	}
 
@@ -22,31 +34,150 @@ public:
 	}
 
 	~audio_instance() {
+		if(pcm_frames)
+			ma_free(pcm_frames, nullptr);
+	}
+
+	bool is_loaded() const {
+		return pcm_frames != nullptr;
+	}
+};
+
+// Forwards to miniaudio's default file system, counting the files opened through it. Both the decoder used for effects and the
+// engine's resource manager (which streams the music) go through it, so it sees every file the sound system touches.
+struct counting_vfs {
+	ma_vfs_callbacks cb; // must come first: miniaudio treats a pointer to this struct as a pointer to its callbacks
+	ma_default_vfs inner;
+	std::atomic<uint32_t> files_opened = 0;
+
+	static ma_default_vfs* forward(ma_vfs* v) {
+		return &static_cast<counting_vfs*>(v)->inner;
+	}
 
+	counting_vfs() {
+		ma_default_vfs_init(&inner, nullptr);
+		cb.onOpen = [](ma_vfs* v, char const* path, ma_uint32 mode, ma_vfs_file* f) {
+			++static_cast<counting_vfs*>(v)->files_opened;
+			return ma_vfs_open(forward(v), path, mode, f);
+		};
+		cb.onOpenW = [](ma_vfs* v, wchar_t const* path, ma_uint32 mode, ma_vfs_file* f) {
+			++static_cast<counting_vfs*>(v)->files_opened;
+			return ma_vfs_open_w(forward(v), path, mode, f);
+		};
+		cb.onClose = [](ma_vfs* v, ma_vfs_file f) {
+			return ma_vfs_close(forward(v), f);
+		};
+		cb.onRead = [](ma_vfs* v, ma_vfs_file f, void* dst, size_t size, size_t* read) {
+			return ma_vfs_read(forward(v), f, dst, size, read);
+		};
+		cb.onWrite = [](ma_vfs* v, ma_vfs_file f, void const* src, size_t size, size_t* written) {
+			return ma_vfs_write(forward(v), f, src, size, written);
+		};
+		cb.onSeek = [](ma_vfs* v, ma_vfs_file f, ma_int64 offset, ma_seek_origin origin) {
+			return ma_vfs_seek(forward(v), f, offset, origin);
+		};
+		cb.onTell = [](ma_vfs* v, ma_vfs_file f, ma_int64* cursor) {
+			return ma_vfs_tell(forward(v), f, cursor);
+		};
+		cb.onInfo = [](ma_vfs* v, ma_vfs_file f, ma_file_info* info) {
+			return ma_vfs_info(forward(v), f, info);
+		};
 	}
+	counting_vfs(counting_vfs const&) = delete;
+};
+
+enum class voice_category : uint8_t {
+	effect, interface
+};
+
+// a sound that plays out of a decoded effect held in memory
+struct voice {
+	ma_audio_buffer_ref source;
+	ma_sound sound;
+	audio_instance const* playing = nullptr;
+	voice_category category = voice_category::effect;
+	uint64_t started = 0; // the play count when it was last started
+	bool ready = false;
 };
 
 class sound_impl {
 public:
-	std::optional<ma_sound> effect_sound;
-	std::optional<ma_sound> interface_sound;
+	static constexpr uint32_t voice_count = 8;
+
 	std::optional<ma_sound> music;
 
+	counting_vfs vfs;
+	ma_context context;
 	ma_engine engine;
+	bool has_context = false;
+
 	audio_instance click_sound;
 	std::vector<audio_instance> music_list;
 	int32_t last_music = -1;
 	int32_t first_music = -1;
 	int32_t current_music = -1;
 
-	sound_impl() {
-		if(ma_engine_init(NULL, &engine) != MA_SUCCESS) {
+	std::array<voice, voice_count> voices;
+	uint64_t play_count = 0;
+
+	// with null_backend set, nothing is actually sent to an audio device (for testing)
+	sound_impl(bool null_backend = false) {
+		ma_engine_config engine_config = ma_engine_config_init();
+		engine_config.pResourceManagerVFS = &vfs;
+		if(null_backend) {
+			ma_backend backends[] = { ma_backend_null };
+			if(ma_context_init(backends, 1, NULL, &context) != MA_SUCCESS) {
+				std::abort();
+			}
+			has_context = true;
+			engine_config.pContext = &context;
+		}
+		if(ma_engine_init(&engine_config, &engine) != MA_SUCCESS) {
 			std::abort();
 		}
+
+		for(auto& v : voices) {
+			if(ma_audio_buffer_ref_init(ma_format_f32, ma_engine_get_channels(&engine), NULL, 0, &v.source) != MA_SUCCESS)
+				continue;
+			if(ma_sound_init_from_data_source(&engine, &v.source, MA_SOUND_FLAG_NO_SPATIALIZATION, NULL, &v.sound) != MA_SUCCESS) {
+				ma_audio_buffer_ref_uninit(&v.source);
+				continue;
+			}
+			v.ready = true;
+		}
+	}
+
+	// every file opened so far, by the decoder or the streaming music; playing an effect should never change it
+	uint32_t files_opened() const {
+		return vfs.files_opened.load();
 	}
 
 	~sound_impl() {
+		if(music.has_value()) {
+			ma_sound_uninit(&*music);
+		}
+		for(auto& v : voices) {
+			if(v.ready) {
+				ma_sound_uninit(&v.sound);
+				ma_audio_buffer_ref_uninit(&v.source);
+			}
+		}
 		ma_engine_uninit(&engine);
+		if(has_context)
+			ma_context_uninit(&context);
+	}
+
+	// decodes the whole file into memory, converted to the format the engine mixes in
+	void load_into_memory(audio_instance& s) {
+		if(s.is_loaded())
+			return;
+		ma_decoder_config config = ma_decoder_config_init(ma_format_f32, ma_engine_get_channels(&engine), ma_engine_get_sample_rate(&engine));
+		void* frames = nullptr;
+		ma_uint64 count = 0;
+		if(ma_decode_from_vfs(&vfs, s.filename.c_str(), &config, &count, &frames) == MA_SUCCESS) {
+			s.pcm_frames = static_cast<float*>(frames);
+			s.frame_count = count;
+		}
 	}
 
 	void set_volume(std::optional<ma_sound>& sound, float volume) {
@@ -54,33 +185,71 @@ public:
 			ma_sound_set_volume(&*sound, volume);
 		}
 	}
-
-	void override_sound(std::optional<ma_sound>& sound, audio_instance& s, float volume) {
-		if(sound.has_value()) {
-			ma_sound_uninit(&*sound);
+	// the volume a play is started at already includes its category's volume, so a change only needs to reach the voices in use
+	void set_volume(voice_category category, float volume) {
+		for(auto& v : voices) {
+			if(v.ready && v.category == category)
+				ma_sound_set_volume(&v.sound, volume);
 		}
+	}
 
-		sound.reset();
-		sound.emplace();
-		ma_result result = ma_sound_init_from_file(&engine, s.filename.c_str(), 0, NULL, NULL, &*sound);
-		if(result == MA_SUCCESS) {
-			set_volume(sound, volume);
-			ma_sound_start(&*sound);
+	/*
+	Picks the voice to play an effect on. A voice that is already playing the same effect is simply restarted; otherwise the
+	voice that has been idle the longest is rebound to the effect's samples. A voice is only rebound once it has stopped, so
+	the mixer never sees its data change underneath it; if every voice is busy with other effects, the new one is dropped.
+	*/
+	void play_from_memory(audio_instance& s, voice_category category, float volume) {
+		if(!s.is_loaded())
+			return;
+
+		voice* chosen = nullptr;
+		for(auto& v : voices) {
+			if(v.ready && v.playing == &s && v.category == category) {
+				chosen = &v;
+				break;
+			}
+		}
+		if(!chosen) {
+			for(auto& v : voices) {
+				if(v.ready && !ma_sound_is_playing(&v.sound) && (!chosen || v.started < chosen->started))
+					chosen = &v;
+			}
+			if(!chosen)
+				return;
+			ma_audio_buffer_ref_set_data(&chosen->source, s.pcm_frames, s.frame_count);
+			chosen->playing = &s;
 		}
+
+		chosen->category = category;
+		chosen->started = ++play_count;
+		ma_sound_set_volume(&chosen->sound, volume);
+		ma_sound_seek_to_pcm_frame(&chosen->sound, 0);
+		ma_sound_start(&chosen->sound);
 	}
 
 	void play_music(int32_t track, float volume) {
 		current_music = track;
+		last_music = track;
 
-		audio_instance audio{};
-		audio.filename = music_list[track].filename.c_str();
-		override_sound(music, audio, volume);
+		if(music.has_value()) {
+			ma_sound_uninit(&*music);
+		}
+		music.reset();
+		music.emplace();
+		// streamed: the resource manager's job thread decodes ahead of the mixer, and ASYNC keeps the file open off this thread
+		ma_result result = ma_sound_init_from_file(&engine, music_list[track].filename.c_str(), MA_SOUND_FLAG_STREAM | MA_SOUND_FLAG_ASYNC | MA_SOUND_FLAG_NO_SPATIALIZATION, NULL, NULL, &*music);
+		if(result == MA_SUCCESS) {
+			set_volume(music, volume);
+			ma_sound_start(&*music);
+		} else {
+			music.reset();
+		}
 	}
 
 	void play_new_track(sys::state& s, float v) {
 		if(music_list.size() > 0) {
 			int32_t result = int32_t(rand() % music_list.size()); // well aware that using rand is terrible, thanks
-			while(result == last_music)
+			while(result == last_music && music_list.size() > 1)
 				result = int32_t(rand() % music_list.size());
 			play_music(result, v);
 		}
@@ -88,7 +257,7 @@ public:
 
 	bool music_finished() {
 		if(music.has_value())
-			return music->atEnd;
+			return ma_sound_at_end(&*music);
 		return true;
 	}
 };
@@ -114,22 +283,23 @@ void initialize_sound_system(sys::state& state) {
 		std::abort();
 	}
 	state.sound_ptr->click_sound = audio_instance(*click_peek);
+	state.sound_ptr->load_into_memory(state.sound_ptr->click_sound);
 }
 void change_effect_volume(sys::state& state, float v) {
-	state.sound_ptr->set_volume(state.sound_ptr->effect_sound, v);
+	state.sound_ptr->set_volume(voice_category::effect, v);
 }
 void change_interface_volume(sys::state& state, float v) {
-	state.sound_ptr->set_volume(state.sound_ptr->interface_sound, v);
+	state.sound_ptr->set_volume(voice_category::interface, v);
 }
 void change_music_volume(sys::state& state, float v) {
 	state.sound_ptr->set_volume(state.sound_ptr->music, v);
 }
 
 void play_effect(sys::state& state, audio_instance& s, float volume) {
-	state.sound_ptr->override_sound(state.sound_ptr->effect_sound, s, volume);
+	state.sound_ptr->play_from_memory(s, voice_category::effect, volume);
 }
 void play_interface_sound(sys::state& state, audio_instance& s, float volume) {
-	state.sound_ptr->override_sound(state.sound_ptr->interface_sound, s, volume);
+	state.sound_ptr->play_from_memory(s, voice_category::interface, volume);
 }
 
 void stop_music(sys::state& state) {
@@ -262,6 +262,13 @@ void font_manager::load_font(font& fnt, char const* file_data, uint32_t file_siz
 	FT_Select_Charmap(fnt.font_face, FT_ENCODING_UNICODE);
 	FT_Set_Pixel_Sizes(fnt.font_face, 0, 64 * magnification_factor);
 	fnt.loaded = true;
+	fnt.file_size = file_size;
+
+	fnt.file_hash = 0xcbf29ce484222325ull; // FNV-1a, identifies the font file in the glyph cache
+	for(uint32_t i = 0; i < file_size; ++i) {
+		fnt.file_hash ^= uint64_t(uint8_t(file_data[i]));
+		fnt.file_hash *= 0x100000001b3ull;
+	}
 
 	fnt.internal_line_height = static_cast<float>(fnt.font_face->size->metrics.height) / static_cast<float>((1 << 6) * magnification_factor);
 	fnt.internal_ascender = static_cast<float>(fnt.font_face->size->metrics.ascender) / static_cast<float>((1 << 6) * magnification_factor);
@@ -280,6 +287,11 @@ void font_manager::load_font(font& fnt, char const* file_data, uint32_t file_siz
 }
 
 float font::kerning(char codepoint_first, char codepoint_second) const {
+	if(kerning_cached) {
+		auto it = kerning_pairs.find(uint16_t((uint16_t(uint8_t(codepoint_first)) << 8) | uint16_t(uint8_t(codepoint_second))));
+		return it != kerning_pairs.end() ? it->second : 0.0f;
+	}
+
 	auto utf16_first = win1250toUTF16(codepoint_first);
 	auto utf16_second = win1250toUTF16(codepoint_second);
 	const auto index_a = FT_Get_Char_Index(font_face, utf16_first);
@@ -327,83 +339,238 @@ float font_manager::text_extent(sys::state& state, const char* codepoints, uint3
 }
 
 
-void font::make_glyph(char ch_in) {
-	if(glyph_loaded[uint8_t(ch_in)])
-		return;
-	glyph_loaded[uint8_t(ch_in)] = true;
+constexpr uint32_t glyph_page_size = 64 * 8;
+constexpr uint32_t glyph_page_bytes = glyph_page_size * glyph_page_size;
+constexpr uint32_t glyph_cache_version = 1;
+
+struct glyph_cache_header {
+	uint32_t version = 0;
+	uint32_t magnification = 0;
+	uint32_t page_size = 0;
+	uint32_t file_size = 0;
+	uint64_t file_hash = 0;
+	uint32_t kerning_count = 0;
+	uint32_t padding = 0;
+};
+
+struct glyph_bitmap {
+	std::vector<uint8_t> buffer;
+	uint32_t width = 0;
+	uint32_t rows = 0;
+	uint32_t pitch = 0;
+	float hb_x = 0.0f;
+	float hb_y = 0.0f;
+	bool present = false;
+};
+
+// FreeType faces are not thread safe, so the rasterization happens serially and the bitmap is copied out
+glyph_bitmap render_glyph_bitmap(FT_Face font_face, char ch_in) {
+	glyph_bitmap result;
 
 	auto codepoint = win1250toUTF16(ch_in);
 	if(codepoint == ' ')
-		return;
+		return result;
 
 	const auto index_in_this_font = FT_Get_Char_Index(font_face, codepoint);
-	if(index_in_this_font) {
-		FT_Load_Glyph(font_face, index_in_this_font, FT_LOAD_TARGET_NORMAL | FT_LOAD_RENDER);
+	if(!index_in_this_font)
+		return result;
 
-		FT_Glyph g_result;
-		FT_Get_Glyph(font_face->glyph, &g_result);
+	FT_Load_Glyph(font_face, index_in_this_font, FT_LOAD_TARGET_NORMAL | FT_LOAD_RENDER);
 
-		auto texture_number = uint8_t(ch_in) >> 6;
+	FT_Glyph g_result;
+	FT_Get_Glyph(font_face->glyph, &g_result);
+	FT_Bitmap& bitmap = ((FT_BitmapGlyphRec*)g_result)->bitmap;
 
-		if(textures[texture_number] == 0) {
-			glGenTextures(1, &textures[texture_number]);
-			glBindTexture(GL_TEXTURE_2D, textures[texture_number]);
-			glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, 64 * 8, 64 * 8);
+	result.width = bitmap.width;
+	result.rows = bitmap.rows;
+	result.pitch = (uint32_t)bitmap.pitch;
+	result.buffer.assign(bitmap.buffer, bitmap.buffer + size_t(bitmap.rows) * size_t(result.pitch));
+	result.hb_x = static_cast<float>(font_face->glyph->metrics.horiBearingX) / static_cast<float>(1 << 6);
+	result.hb_y = static_cast<float>(font_face->glyph->metrics.horiBearingY) / static_cast<float>(1 << 6);
+	result.present = true;
 
-			//glClearTexImage(textures[texture_number], 0, GL_RED, GL_FLOAT, nullptr);
+	FT_Done_Glyph(g_result);
+	return result;
+}
 
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		} else {
-			glBindTexture(GL_TEXTURE_2D, textures[texture_number]);
-		}
+// writes the 64x64 distance field for the glyph into dest, which has rows of dest_pitch bytes
+void make_glyph_sdf(glyph_bitmap& bmp, uint8_t* dest, uint32_t dest_pitch, glyph_sub_offset& position) {
+	const int btmap_x_off = 32 * magnification_factor - int(bmp.width) / 2;
+	const int btmap_y_off = 32 * magnification_factor - int(bmp.rows) / 2;
 
-		FT_Bitmap& bitmap = ((FT_BitmapGlyphRec*)g_result)->bitmap;
+	position.x = (bmp.hb_x - static_cast<float>(btmap_x_off)) * 1.0f / static_cast<float>(magnification_factor);
+	position.y = (-bmp.hb_y - static_cast<float>(btmap_y_off)) * 1.0f / static_cast<float>(magnification_factor);
 
-		const float hb_x = static_cast<float>(font_face->glyph->metrics.horiBearingX) / static_cast<float>(1 << 6);
-		const float hb_y = static_cast<float>(font_face->glyph->metrics.horiBearingY) / static_cast<float>(1 << 6);
+	// heap allocated: this runs on worker threads, which may have small stacks
+	std::unique_ptr<bool[]> in_map(new bool[dr_size * dr_size]);
+	std::unique_ptr<float[]> distance_map(new float[dr_size * dr_size]);
 
-		auto sub_index = (uint8_t(ch_in) & 63);
+	init_in_map(in_map.get(), bmp.buffer.data(), btmap_x_off, btmap_y_off, bmp.width, bmp.rows, bmp.pitch);
+	dead_reckoning(distance_map.get(), in_map.get());
 
-		uint8_t pixel_buffer[64 * 64];
+	for(int y = 0; y < 64; ++y) {
+		for(int x = 0; x < 64; ++x) {
+			const float distance_value = distance_map[
+				(x * magnification_factor + magnification_factor / 2) +
+					(y * magnification_factor + magnification_factor / 2) * dr_size]
+				/ static_cast<float>(magnification_factor * 64);
+				const int int_value = static_cast<int>(distance_value * -255.0f + 128.0f);
+				const uint8_t small_value = static_cast<uint8_t>(std::min(255, std::max(0, int_value)));
 
-		const int btmap_x_off = 32 * magnification_factor - bitmap.width / 2;
-		const int btmap_y_off = 32 * magnification_factor - bitmap.rows / 2;
+				dest[x + y * dest_pitch] = small_value;
+		}
+	}
+}
+
+void create_glyph_texture(uint32_t& texture) {
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, glyph_page_size, glyph_page_size);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+}
+
+void font::make_glyph(char ch_in) {
+	if(glyph_loaded[uint8_t(ch_in)])
+		return;
+	glyph_loaded[uint8_t(ch_in)] = true;
 
-		glyph_positions[uint8_t(ch_in)].x = (hb_x - static_cast<float>(btmap_x_off)) * 1.0f / static_cast<float>(magnification_factor);
-		glyph_positions[uint8_t(ch_in)].y = (-hb_y - static_cast<float>(btmap_y_off)) * 1.0f / static_cast<float>(magnification_factor);
+	auto bmp = render_glyph_bitmap(font_face, ch_in);
+	if(!bmp.present)
+		return;
+
+	auto texture_number = uint8_t(ch_in) >> 6;
+	if(textures[texture_number] == 0) {
+		create_glyph_texture(textures[texture_number]);
+	} else {
+		glBindTexture(GL_TEXTURE_2D, textures[texture_number]);
+	}
 
-		bool in_map[dr_size * dr_size] = { false };
-		float distance_map[dr_size * dr_size];
+	auto sub_index = (uint8_t(ch_in) & 63);
+	uint8_t pixel_buffer[64 * 64];
+	make_glyph_sdf(bmp, pixel_buffer, 64, glyph_positions[uint8_t(ch_in)]);
 
-		init_in_map(in_map, bitmap.buffer, btmap_x_off, btmap_y_off, bitmap.width, bitmap.rows, (uint32_t)bitmap.pitch);
-		dead_reckoning(distance_map, in_map);
+	glTexSubImage2D(GL_TEXTURE_2D, 0,
+		(sub_index & 7) * 64,
+		((sub_index >> 3) & 7) * 64,
+		64,
+		64,
+		GL_RED, GL_UNSIGNED_BYTE, pixel_buffer);
+}
 
+// renders the distance fields of all 256 glyphs into four page_data pages of glyph_page_size x glyph_page_size
+void font::make_all_glyphs(uint8_t* page_data) {
+	std::vector<glyph_bitmap> bitmaps(256);
+	for(uint32_t i = 0; i < 256; ++i) {
+		bitmaps[i] = render_glyph_bitmap(font_face, char(i));
+	}
 
-		for(int y = 0; y < 64; ++y) {
-			for(int x = 0; x < 64; ++x) {
+	concurrency::parallel_for(uint32_t(0), uint32_t(256), [&](uint32_t i) {
+		if(!bitmaps[i].present)
+			return;
+		auto sub_index = i & 63;
+		auto dest = page_data + size_t(i >> 6) * glyph_page_bytes + (sub_index & 7) * 64 + ((sub_index >> 3) & 7) * 64 * glyph_page_size;
+		make_glyph_sdf(bitmaps[i], dest, glyph_page_size, glyph_positions[i]);
+	});
 
-				const size_t index = static_cast<size_t>(x + y * 64);
-				const float distance_value = distance_map[
-					(x * magnification_factor + magnification_factor / 2) +
-						(y * magnification_factor + magnification_factor / 2) * dr_size]
-					/ static_cast<float>(magnification_factor * 64);
-					const int int_value = static_cast<int>(distance_value * -255.0f + 128.0f);
-					const uint8_t small_value = static_cast<uint8_t>(std::min(255, std::max(0, int_value)));
+	for(uint32_t i = 0; i < 256; ++i)
+		glyph_loaded[i] = true;
+}
 
-					pixel_buffer[index] = small_value;
+void font::make_kerning_pairs() {
+	kerning_pairs.clear();
+	if(FT_HAS_KERNING(font_face)) {
+		uint32_t indices[256];
+		for(uint32_t i = 0; i < 256; ++i)
+			indices[i] = FT_Get_Char_Index(font_face, win1250toUTF16(char(i)));
+
+		for(uint32_t a = 0; a < 256; ++a) {
+			if(indices[a] == 0)
+				continue;
+			for(uint32_t b = 0; b < 256; ++b) {
+				if(indices[b] == 0)
+					continue;
+				FT_Vector kerning;
+				FT_Get_Kerning(font_face, indices[a], indices[b], FT_KERNING_DEFAULT, &kerning);
+				if(kerning.x != 0)
+					kerning_pairs.insert_or_assign(uint16_t((a << 8) | b), static_cast<float>(kerning.x) / static_cast<float>((1 << 6) * magnification_factor));
 			}
 		}
+	}
+	kerning_cached = true;
+}
+
+/*
+Cache layout: glyph_cache_header, the line metrics, glyph_advances, glyph_positions, the four glyph pages,
+and then kerning_count (uint16_t pair, float value) entries
+*/
 
-		glTexSubImage2D(GL_TEXTURE_2D, 0,
-			(sub_index & 7) * 64,
-			((sub_index >> 3) & 7) * 64,
-			64,
-			64,
-			GL_RED, GL_UNSIGNED_BYTE, pixel_buffer);
+bool font::read_glyph_cache(char const* data, uint32_t size, uint8_t* page_data) {
+	constexpr size_t fixed_size = sizeof(glyph_cache_header) + sizeof(float) * 4 + sizeof(glyph_advances) + sizeof(glyph_positions) + size_t(glyph_page_bytes) * 4;
+	if(size < fixed_size)
+		return false;
 
-		FT_Done_Glyph(g_result);
+	glyph_cache_header header;
+	memcpy(&header, data, sizeof(glyph_cache_header));
+	if(header.version != glyph_cache_version || header.magnification != uint32_t(magnification_factor)
+		|| header.page_size != glyph_page_size || header.file_size != file_size || header.file_hash != file_hash) {
+		return false;
 	}
+	if(size != fixed_size + size_t(header.kerning_count) * (sizeof(uint16_t) + sizeof(float)))
+		return false;
+
+	auto ptr = data + sizeof(glyph_cache_header);
+	memcpy(&internal_line_height, ptr, sizeof(float)); ptr += sizeof(float);
+	memcpy(&internal_ascender, ptr, sizeof(float)); ptr += sizeof(float);
+	memcpy(&internal_descender, ptr, sizeof(float)); ptr += sizeof(float);
+	memcpy(&internal_top_adj, ptr, sizeof(float)); ptr += sizeof(float);
+	memcpy(glyph_advances, ptr, sizeof(glyph_advances)); ptr += sizeof(glyph_advances);
+	memcpy(glyph_positions, ptr, sizeof(glyph_positions)); ptr += sizeof(glyph_positions);
+	memcpy(page_data, ptr, size_t(glyph_page_bytes) * 4); ptr += size_t(glyph_page_bytes) * 4;
+
+	kerning_pairs.clear();
+	kerning_pairs.reserve(header.kerning_count);
+	for(uint32_t i = 0; i < header.kerning_count; ++i) {
+		uint16_t pair = 0;
+		float value = 0.0f;
+		memcpy(&pair, ptr, sizeof(uint16_t)); ptr += sizeof(uint16_t);
+		memcpy(&value, ptr, sizeof(float)); ptr += sizeof(float);
+		kerning_pairs.insert_or_assign(pair, value);
+	}
+	kerning_cached = true;
+
+	for(uint32_t i = 0; i < 256; ++i)
+		glyph_loaded[i] = true;
+	return true;
+}
+
+std::vector<char> font::write_glyph_cache(uint8_t const* page_data) const {
+	glyph_cache_header header;
+	header.version = glyph_cache_version;
+	header.magnification = uint32_t(magnification_factor);
+	header.page_size = glyph_page_size;
+	header.file_size = file_size;
+	header.file_hash = file_hash;
+	header.kerning_count = uint32_t(kerning_pairs.size());
+
+	std::vector<char> result(sizeof(glyph_cache_header) + sizeof(float) * 4 + sizeof(glyph_advances) + sizeof(glyph_positions) + size_t(glyph_page_bytes) * 4
+		+ size_t(header.kerning_count) * (sizeof(uint16_t) + sizeof(float)));
+
+	auto ptr = result.data();
+	memcpy(ptr, &header, sizeof(glyph_cache_header)); ptr += sizeof(glyph_cache_header);
+	memcpy(ptr, &internal_line_height, sizeof(float)); ptr += sizeof(float);
+	memcpy(ptr, &internal_ascender, sizeof(float)); ptr += sizeof(float);
+	memcpy(ptr, &internal_descender, sizeof(float)); ptr += sizeof(float);
+	memcpy(ptr, &internal_top_adj, sizeof(float)); ptr += sizeof(float);
+	memcpy(ptr, glyph_advances, sizeof(glyph_advances)); ptr += sizeof(glyph_advances);
+	memcpy(ptr, glyph_positions, sizeof(glyph_positions)); ptr += sizeof(glyph_positions);
+	memcpy(ptr, page_data, size_t(glyph_page_bytes) * 4); ptr += size_t(glyph_page_bytes) * 4;
+	for(auto& p : kerning_pairs) {
+		memcpy(ptr, &p.first, sizeof(uint16_t)); ptr += sizeof(uint16_t);
+		memcpy(ptr, &p.second, sizeof(float)); ptr += sizeof(float);
+	}
+	return result;
 }
 
 float font::text_extent(const char* codepoints, uint32_t count, int32_t size) const {
@@ -436,9 +603,37 @@ void load_bmfonts(sys::state& state) {
 }
 
 void font_manager::load_all_glyphs() {
+	auto cache_dir = simple_fs::get_or_create_scenario_directory();
+	native_string_view cache_names[2] = { NATIVE("font_cache_a.bin"), NATIVE("font_cache_b.bin") };
+
+	std::vector<uint8_t> page_data(size_t(glyph_page_bytes) * 4, 0);
 	for(uint32_t j = 0; j < 2; ++j) {
-		for(uint32_t i = 0; i < 256; ++i)
-			fonts[j].make_glyph(char(i));
+		auto& fnt = fonts[j];
+		if(!fnt.loaded)
+			continue;
+
+		bool cache_valid = false;
+		if(auto cache_file = simple_fs::open_file(cache_dir, cache_names[j]); cache_file) {
+			auto content = simple_fs::view_contents(*cache_file);
+			cache_valid = fnt.read_glyph_cache(content.data, content.file_size, page_data.data());
+		}
+		if(!cache_valid) {
+			std::fill(page_data.begin(), page_data.end(), uint8_t(0));
+			fnt.make_all_glyphs(page_data.data());
+			fnt.make_kerning_pairs();
+			auto cache_data = fnt.write_glyph_cache(page_data.data());
+			simple_fs::write_file(cache_dir, cache_names[j], cache_data.data(), uint32_t(cache_data.size()));
+		}
+
+		// one upload per glyph page instead of one per glyph
+		for(uint32_t t = 0; t < 4; ++t) {
+			if(fnt.textures[t] == 0) {
+				create_glyph_texture(fnt.textures[t]);
+			} else {
+				glBindTexture(GL_TEXTURE_2D, fnt.textures[t]);
+			}
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, glyph_page_size, glyph_page_size, GL_RED, GL_UNSIGNED_BYTE, page_data.data() + size_t(t) * glyph_page_bytes);
+		}
 	}
 }
 
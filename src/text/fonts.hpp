@@ -46,12 +46,20 @@ public:
 	uint32_t textures[4] = { 0, 0, 0, 0 };
 	bool glyph_loaded[256] = { false };
 	glyph_sub_offset glyph_positions[256] = {};
+	ankerl::unordered_dense::map<uint16_t, float> kerning_pairs; // (first << 8 | second) -> non-zero kerning
+	bool kerning_cached = false;
 
 	std::unique_ptr<FT_Byte[]> file_data;
+	uint32_t file_size = 0;
+	uint64_t file_hash = 0;
 
 	~font();
 
 	void make_glyph(char ch_in);
+	void make_all_glyphs(uint8_t* page_data);
+	void make_kerning_pairs();
+	bool read_glyph_cache(char const* data, uint32_t size, uint8_t* page_data);
+	std::vector<char> write_glyph_cache(uint8_t const* page_data) const;
 	float line_height(int32_t size) const;
 	float ascender(int32_t size) const;
 	float descender(int32_t size) const;
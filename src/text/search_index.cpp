@@ -0,0 +1,168 @@
+#include "search_index.hpp"
+#include "system_state.hpp"
+#include "text.hpp"
+#include "parsers_declarations.hpp"
+#include <algorithm>
+
+namespace text {
+
+namespace impl {
+
+inline uint32_t trigram_key(char const* p) {
+	return (uint32_t(uint8_t(p[0])) << 16) | (uint32_t(uint8_t(p[1])) << 8) | uint32_t(uint8_t(p[2]));
+}
+
+}
+
+void search_index::clear() {
+	arena.clear();
+	entries.clear();
+	sorted.clear();
+	trigrams.clear();
+	trigram_start.clear();
+	postings.clear();
+}
+
+void search_index::add(std::string_view name, uint32_t value) {
+	entry e;
+	e.offset = uint32_t(arena.size());
+	e.length = uint32_t(name.length());
+	e.value = value;
+	auto folded = parsers::lowercase_str(name);
+	arena.insert(arena.end(), folded.begin(), folded.end());
+	entries.push_back(e);
+}
+
+void search_index::finish() {
+	sorted.resize(entries.size());
+	for(uint32_t i = 0; i < entries.size(); ++i)
+		sorted[i] = i;
+	std::sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) {
+		auto na = folded_name(a);
+		auto nb = folded_name(b);
+		if(na != nb)
+			return na < nb;
+		return entries[a].value < entries[b].value;
+	});
+
+	// (trigram, entry) pairs, each entry counted once per distinct trigram
+	std::vector<std::pair<uint32_t, uint32_t>> pairs;
+	for(uint32_t i = 0; i < entries.size(); ++i) {
+		auto name = folded_name(i);
+		for(size_t j = 0; j + 3 <= name.length(); ++j) {
+			pairs.emplace_back(impl::trigram_key(name.data() + j), i);
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+	trigrams.clear();
+	trigram_start.clear();
+	postings.clear();
+	postings.reserve(pairs.size());
+	for(auto& p : pairs) {
+		if(trigrams.empty() || trigrams.back() != p.first) {
+			trigrams.push_back(p.first);
+			trigram_start.push_back(uint32_t(postings.size()));
+		}
+		postings.push_back(p.second);
+	}
+	trigram_start.push_back(uint32_t(postings.size()));
+}
+
+template<typename F>
+void search_index::find_in_range(std::string_view folded_term, std::vector<uint32_t>& out, F&& keep) const {
+	out.clear();
+	auto first = std::lower_bound(sorted.begin(), sorted.end(), folded_term, [&](uint32_t e, std::string_view t) {
+		return folded_name(e) < t;
+	});
+	for(auto it = first; it != sorted.end(); ++it) {
+		auto name = folded_name(*it);
+		if(!name.starts_with(folded_term))
+			break;
+		if(keep(name))
+			out.push_back(entries[*it].value);
+	}
+	std::sort(out.begin(), out.end());
+}
+
+void search_index::find_exact(std::string_view term, std::vector<uint32_t>& out) const {
+	auto folded_term = parsers::lowercase_str(term);
+	find_in_range(folded_term, out, [&](std::string_view name) { return name.length() == folded_term.length(); });
+}
+
+void search_index::find_prefix(std::string_view term, std::vector<uint32_t>& out) const {
+	auto folded_term = parsers::lowercase_str(term);
+	find_in_range(folded_term, out, [](std::string_view) { return true; });
+}
+
+void search_index::find_substring(std::string_view term, std::vector<uint32_t>& out) const {
+	out.clear();
+	auto folded_term = parsers::lowercase_str(term);
+
+	if(folded_term.length() < 3) { // no trigram to narrow things down with
+		for(auto& e : entries) {
+			if(std::string_view(arena.data() + e.offset, e.length).find(folded_term) != std::string_view::npos)
+				out.push_back(e.value);
+		}
+		std::sort(out.begin(), out.end());
+		return;
+	}
+
+	// only entries containing every trigram of the term can match; start from the trigram with the fewest of them
+	uint32_t best_begin = 0;
+	uint32_t best_end = 0;
+	bool have_best = false;
+	for(size_t j = 0; j + 3 <= folded_term.length(); ++j) {
+		auto key = impl::trigram_key(folded_term.data() + j);
+		auto it = std::lower_bound(trigrams.begin(), trigrams.end(), key);
+		if(it == trigrams.end() || *it != key)
+			return; // some trigram appears nowhere
+		auto t = uint32_t(it - trigrams.begin());
+		if(!have_best || trigram_start[t + 1] - trigram_start[t] < best_end - best_begin) {
+			best_begin = trigram_start[t];
+			best_end = trigram_start[t + 1];
+			have_best = true;
+		}
+	}
+	for(uint32_t i = best_begin; i < best_end; ++i) {
+		if(folded_name(postings[i]).find(folded_term) != std::string_view::npos)
+			out.push_back(entries[postings[i]].value);
+	}
+	std::sort(out.begin(), out.end());
+}
+
+void build_search_indices(sys::state& state) {
+	auto& s = state.search_data;
+
+	s.provinces.clear();
+	state.world.for_each_province([&](dcon::province_id id) {
+		s.provinces.add(text::produce_simple_string(state, state.world.province_get_name(id)), uint32_t(id.index()));
+	});
+	s.provinces.finish();
+
+	s.nations.clear();
+	s.tags.clear();
+	state.world.for_each_national_identity([&](dcon::national_identity_id id) {
+		s.nations.add(text::produce_simple_string(state, state.world.national_identity_get_name(id)), uint32_t(id.index()));
+		s.tags.add(nations::int_to_tag(state.world.national_identity_get_identifying_int(id)), uint32_t(id.index()));
+	});
+	s.nations.finish();
+	s.tags.finish();
+
+	s.states.clear();
+	state.world.for_each_state_definition([&](dcon::state_definition_id id) {
+		s.states.add(text::produce_simple_string(state, state.world.state_definition_get_name(id)), uint32_t(id.index()));
+	});
+	s.states.finish();
+
+	s.built = true;
+}
+
+search_indices& get_search_indices(sys::state& state) {
+	if(!state.search_data.built)
+		build_search_indices(state);
+	return state.search_data;
+}
+
+}
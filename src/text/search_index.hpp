@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sys {
+	struct state;
+}
+
+namespace text {
+
+/*
+An index over a set of names for the search boxes. The names are case folded (the same way as parsers::lowercase_str) and copied
+into a single arena. A table of the entries sorted by name answers prefix queries with a binary search, and the postings of each
+trigram appearing in the names narrow substring queries down to the entries that can possibly match. Each entry carries a 32 bit
+value, which is what the queries report (in increasing order, regardless of how the names sort).
+*/
+class search_index {
+public:
+	void clear();
+	void add(std::string_view name, uint32_t value);
+	void finish(); // call once after the last add and before any query
+
+	void find_exact(std::string_view term, std::vector<uint32_t>& out) const;
+	void find_prefix(std::string_view term, std::vector<uint32_t>& out) const;
+	void find_substring(std::string_view term, std::vector<uint32_t>& out) const;
+
+	size_t size() const {
+		return entries.size();
+	}
+	std::string_view folded_name(uint32_t entry) const {
+		return std::string_view(arena.data() + entries[entry].offset, entries[entry].length);
+	}
+
+private:
+	struct entry {
+		uint32_t offset = 0;
+		uint32_t length = 0;
+		uint32_t value = 0;
+	};
+
+	std::vector<char> arena;
+	std::vector<entry> entries;
+	std::vector<uint32_t> sorted; // entry indices, ordered by folded name
+
+	std::vector<uint32_t> trigrams; // sorted
+	std::vector<uint32_t> trigram_start; // postings of trigrams[i] are [trigram_start[i], trigram_start[i + 1])
+	std::vector<uint32_t> postings; // entry indices
+
+	template<typename F>
+	void find_in_range(std::string_view folded_term, std::vector<uint32_t>& out, F&& keep) const;
+};
+
+// The indices behind the province search window and the console's tag lookups. They are built on first use, and are rebuilt
+// after the localisation is (re)loaded or a province or state is renamed (clear `built` to request that).
+struct search_indices {
+	search_index provinces; // province ids
+	search_index nations; // national identity ids, by the name of the identity (which, unlike the nation holding it, never changes)
+	search_index states; // state definition ids
+	search_index tags; // national identity ids, by three letter tag
+	std::atomic<bool> built = false; // cleared by the game thread, rebuilt on demand by the ui
+};
+
+void build_search_indices(sys::state& state);
+search_indices& get_search_indices(sys::state& state);
+
+}
@@ -40,58 +40,65 @@ namespace text {
 		return result;
 	}
 
-	void consume_csv_file(sys::state& state, uint32_t language, char const* file_content, uint32_t file_size) {
+	dcon::text_key add_to_csv_pool(std::vector<char>& text_data, std::string_view new_text) {
+		auto start = text_data.size();
+		text_data.resize(start + new_text.length() + 1, char(0));
+		std::copy_n(new_text.data(), new_text.length(), text_data.data() + start);
+		return dcon::text_key(uint32_t(start));
+	}
+
+	void parse_csv_file(csv_file_contents& out, uint32_t language, char const* file_content, uint32_t file_size) {
 		auto start = (file_size != 0 && file_content[0] == '#') ? parsers::csv_advance_to_next_line(file_content, file_content + file_size) : file_content;
 		while(start < file_content + file_size) {
-			start = parsers::parse_first_and_nth_csv_values(language, start, file_content + file_size, ';', [&state](std::string_view key, std::string_view content) {
+			start = parsers::parse_first_and_nth_csv_values(language, start, file_content + file_size, ';', [&out](std::string_view key, std::string_view content) {
 				char const* seq_start = content.data();
 				char const* seq_end = content.data() + content.size();
 				char const* section_start = seq_start;
 
-				const auto component_start_index = state.text_components.size();
+				const auto component_start_index = out.text_components.size();
 				for(char const* pos = seq_start; pos < seq_end; ) {
 					bool colour_esc = false;
 					if(uint8_t(*pos) == 0xA7) {
 						if(section_start != pos) {
-							auto added_key = state.add_to_pool(std::string_view(section_start, pos - section_start));
-							state.text_components.emplace_back( added_key );
+							auto added_key = add_to_csv_pool(out.text_data, std::string_view(section_start, pos - section_start));
+							out.text_components.emplace_back( added_key );
 						}
 						pos += 1;
 						section_start = pos;
 						colour_esc = true;
 					} else if(pos + 2 < seq_end && uint8_t(*pos) == 0xEF && uint8_t(*(pos + 1)) == 0xBF && uint8_t(*(pos + 2)) == 0xBD && is_qmark_color(*(pos + 3))) {
 						if(section_start != pos) {
-							auto added_key = state.add_to_pool(std::string_view(section_start, pos - section_start));
-							state.text_components.emplace_back( added_key );
+							auto added_key = add_to_csv_pool(out.text_data, std::string_view(section_start, pos - section_start));
+							out.text_components.emplace_back( added_key );
 						}
 						section_start = pos += 3;
 						colour_esc = true;
 					} else if(pos + 1 < seq_end && *pos == '?' && is_qmark_color(*(pos + 1))) {
 						if(section_start != pos) {
-							auto added_key = state.add_to_pool(std::string_view(section_start, pos - section_start));
-							state.text_components.emplace_back( added_key );
+							auto added_key = add_to_csv_pool(out.text_data, std::string_view(section_start, pos - section_start));
+							out.text_components.emplace_back( added_key );
 						}
 						pos += 1;
 						section_start = pos;
 						colour_esc = true;
 					} else if(*pos == '$') {
 						if(section_start != pos) {
-							auto added_key = state.add_to_pool(std::string_view(section_start, pos - section_start));
-							state.text_components.emplace_back( added_key );
+							auto added_key = add_to_csv_pool(out.text_data, std::string_view(section_start, pos - section_start));
+							out.text_components.emplace_back( added_key );
 						}
 						const char* vend = pos + 1;
 						for(; vend != seq_end && *vend != '$'; ++vend)
 							;
 						if(vend > pos + 1)
-							state.text_components.emplace_back( variable_type_from_name(std::string_view(pos + 1, vend - pos - 1)) );
+							out.text_components.emplace_back( variable_type_from_name(std::string_view(pos + 1, vend - pos - 1)) );
 						pos = vend + 1;
 						section_start = pos;
 					} else if(pos + 1 < seq_end && *pos == '\\' && *(pos + 1) == 'n') {
 						if(section_start != pos) {
-							auto added_key = state.add_to_pool(std::string_view(section_start, pos - section_start));
-							state.text_components.emplace_back( added_key );
+							auto added_key = add_to_csv_pool(out.text_data, std::string_view(section_start, pos - section_start));
+							out.text_components.emplace_back( added_key );
 						}
-						state.text_components.emplace_back(line_break{});
+						out.text_components.emplace_back(line_break{});
 						section_start = pos += 2;
 					} else {
 						++pos;
@@ -100,51 +107,80 @@ namespace text {
 					// This colour escape sequence must be followed by something, otherwise
 					// we should probably discard the last colour command
 					if(colour_esc && pos < seq_end) {
-						state.text_components.emplace_back( char_to_color(*pos) );
+						out.text_components.emplace_back( char_to_color(*pos) );
 						pos += 1;
 						section_start = pos;
 					}
 				}
 
 				if(section_start < seq_end) {
-					auto added_key = state.add_to_pool(std::string_view(section_start, seq_end - section_start));
-					state.text_components.emplace_back( added_key );
+					auto added_key = add_to_csv_pool(out.text_data, std::string_view(section_start, seq_end - section_start));
+					out.text_components.emplace_back( added_key );
 				}
 
 				// TODO: Emit error when 64K boundary is violated
-				assert(state.text_components.size() < std::numeric_limits<uint32_t>::max());
-				assert(state.text_components.size() - component_start_index < std::numeric_limits<uint8_t>::max());
-
-				auto to_lower_temp = lowercase_str(key);
-				if(auto it = state.key_to_text_sequence.find(to_lower_temp); it != state.key_to_text_sequence.end()) {
-					// maybe report an error here -- repeated definition
-					state.text_sequences[it->second] = text_sequence{
-							static_cast<uint32_t>(component_start_index),
-							static_cast<uint16_t>(state.text_components.size() - component_start_index) };
-				} else {
-					const auto nh = state.text_sequences.size();
-					state.text_sequences.emplace_back(
-						text_sequence{
-							static_cast<uint32_t>(component_start_index),
-							static_cast<uint16_t>(state.text_components.size() - component_start_index) });
-
-					auto main_key = state.add_to_pool_lowercase(key);
-					state.key_to_text_sequence.insert_or_assign(main_key, dcon::text_sequence_id(uint16_t(nh)));
-				}
+				assert(out.text_components.size() - component_start_index < std::numeric_limits<uint8_t>::max());
 
+				auto key_start = out.key_data.size();
+				for(auto ch : key) {
+					out.key_data.push_back(char(tolower(ch)));
+				}
+				out.entries.push_back(csv_entry{
+					static_cast<uint32_t>(key_start),
+					static_cast<uint32_t>(key.length()),
+					static_cast<uint32_t>(component_start_index),
+					static_cast<uint16_t>(out.text_components.size() - component_start_index) });
 			});
 		}
 	}
 
+	void merge_csv_file(sys::state& state, csv_file_contents const& in) {
+		const auto text_offset = uint32_t(state.text_data.size());
+		const auto component_offset = uint32_t(state.text_components.size());
+
+		state.text_data.insert(state.text_data.end(), in.text_data.begin(), in.text_data.end());
+		state.text_components.reserve(state.text_components.size() + in.text_components.size());
+		for(auto& c : in.text_components) {
+			if(std::holds_alternative<dcon::text_key>(c)) {
+				state.text_components.emplace_back(dcon::text_key(uint32_t(std::get<dcon::text_key>(c).index() + text_offset)));
+			} else {
+				state.text_components.push_back(c);
+			}
+		}
+		assert(state.text_components.size() < std::numeric_limits<uint32_t>::max());
+
+		for(auto& e : in.entries) {
+			auto seq = text_sequence{ e.starting_component + component_offset, e.component_count };
+			auto lower_key = std::string_view(in.key_data.data() + e.key_start, e.key_length);
+			if(auto it = state.key_to_text_sequence.find(lower_key); it != state.key_to_text_sequence.end()) {
+				// maybe report an error here -- repeated definition
+				state.text_sequences[it->second] = seq;
+			} else {
+				const auto nh = state.text_sequences.size();
+				state.text_sequences.emplace_back(seq);
+
+				auto main_key = state.add_to_pool(lower_key);
+				state.key_to_text_sequence.insert_or_assign(main_key, dcon::text_sequence_id(uint16_t(nh)));
+			}
+		}
+	}
+
+	void consume_csv_file(sys::state& state, uint32_t language, char const* file_content, uint32_t file_size) {
+		csv_file_contents parsed;
+		parse_csv_file(parsed, language, file_content, file_size);
+		merge_csv_file(state, parsed);
+	}
+
 	void load_text_data(sys::state& state, uint32_t language) {
 		auto rt = get_root(state.common_fs);
 
+		std::vector<simple_fs::file> files;
+
 		// first, load in special mod gui
 		// TODO put this in a better location
 		auto alice_csv = open_file(rt, NATIVE("assets/alice.csv"));
 		if(alice_csv) {
-			auto content = view_contents(*alice_csv);
-			consume_csv_file(state, language, content.data, content.file_size);
+			files.push_back(std::move(*alice_csv));
 		}
 
 		auto text_dir = open_directory(rt, NATIVE("localisation"));
@@ -153,10 +189,22 @@ namespace text {
 		for(auto& file : all_files) {
 			auto ofile = open_file(file);
 			if(ofile) {
-				auto content = view_contents(*ofile);
-				consume_csv_file(state, language, content.data, content.file_size);
+				files.push_back(std::move(*ofile));
 			}
 		}
+
+		// files are parsed independently and then merged in order, so later files still override earlier keys
+		std::vector<csv_file_contents> parsed(files.size());
+		concurrency::parallel_for(size_t(0), files.size(), [&](size_t i) {
+			auto content = view_contents(files[i]);
+			parse_csv_file(parsed[i], language, content.data, content.file_size);
+		});
+		for(auto& p : parsed) {
+			merge_csv_file(state, p);
+		}
+
+		// the names have changed, so the search indices will need to be rebuilt
+		state.search_data.built = false;
 	}
 
 	template<size_t N>
@@ -288,6 +288,22 @@ namespace text {
 	void add_to_substitution_map(substitution_map& mp, variable_type key, substitution value);
 	void add_to_substitution_map(substitution_map &mp, variable_type key, std::string const&);	// DO NOT USE THIS FUNCTION
 
+	struct csv_entry {
+		uint32_t key_start = 0;
+		uint32_t key_length = 0;
+		uint32_t starting_component = 0;
+		uint16_t component_count = 0;
+	};
+	// the contents of a single localisation file; text keys in the components are relative to its own text_data
+	struct csv_file_contents {
+		std::vector<char> text_data;
+		std::vector<text_component> text_components;
+		std::vector<char> key_data; // lower case keys
+		std::vector<csv_entry> entries;
+	};
+
+	void parse_csv_file(csv_file_contents& out, uint32_t language, char const* file_content, uint32_t file_size); // does not touch the state, may run in parallel
+	void merge_csv_file(sys::state& state, csv_file_contents const& in);
 	void consume_csv_file(sys::state& state, uint32_t language, char const* file_content, uint32_t file_size);
 	variable_type variable_type_from_name(std::string_view);
 	void load_text_data(sys::state& state, uint32_t language);
@@ -0,0 +1,129 @@
+#include "catch.hpp"
+#include "system_state.hpp"
+#include "demographics.hpp"
+
+TEST_CASE("pop update periods", "[demographics_tests]") {
+	demographics::pop_update_scheduler schedule;
+	parsing::defines d;
+	d.pop_update_period_militancy = 7.0f;
+	d.pop_update_period_growth = 1000.0f;
+	schedule.configure(d);
+
+	// by default an update visits 1 / (length of the month) of the pops each day
+	REQUIRE(schedule.divisions(demographics::pop_update::literacy, 31) == 31);
+	REQUIRE(schedule.offset(demographics::pop_update::literacy, sys::date{ 100 }, 30, 31) == (30 + 4) % 31);
+
+	// with a period, it visits all of them every n days, whatever the month
+	REQUIRE(schedule.divisions(demographics::pop_update::militancy, 31) == 7);
+	std::vector<bool> seen(7, false);
+	for(uint16_t day = 0; day < 7; ++day)
+		seen[schedule.offset(demographics::pop_update::militancy, sys::date{ uint16_t(200 + day) }, 1, 31)] = true;
+	REQUIRE(std::count(seen.begin(), seen.end(), true) == 7);
+
+	// periods from the defines are limited to what the scheduler can store
+	REQUIRE(schedule.divisions(demographics::pop_update::growth, 31) == 255);
+}
+
+#ifndef IGNORE_REAL_FILES_TESTS
+TEST_CASE("size zero pops are compacted stably", "[demographics_tests]") {
+	std::unique_ptr<sys::state> state = load_testing_scenario_file();
+
+	struct survivor {
+		float size = 0.0f;
+		dcon::culture_id culture;
+		dcon::province_id location;
+		dcon::movement_id movement;
+		dcon::rebel_faction_id faction;
+		uint32_t regiments = 0;
+	};
+
+	// every seventh pop dies, along with a run at the very end of the table
+	auto const count = state->world.pop_size();
+	REQUIRE(count > 100);
+	std::vector<survivor> expected;
+	for(uint32_t i = 0; i < count; ++i) {
+		auto p = fatten(state->world, dcon::pop_id{ dcon::pop_id::value_base_t(i) });
+		if(i % 7 == 3 || i + 10 >= count) {
+			p.set_size(0.0f);
+		} else if(p.get_size() >= 1.0f) {
+			auto regs = p.get_regiment_source();
+			expected.push_back(survivor{ p.get_size(), p.get_culture(), p.get_province_from_pop_location(),
+				p.get_movement_from_pop_movement_membership(), p.get_rebel_faction_from_pop_rebellion_membership(), uint32_t(regs.end() - regs.begin()) });
+		}
+	}
+	// the order of the surviving pops within each province
+	std::vector<std::vector<float>> province_order(state->world.province_size());
+	for(auto prov : state->world.in_province) {
+		for(auto pl : prov.get_pop_location()) {
+			if(pl.get_pop().get_size() >= 1.0f)
+				province_order[prov.id.index()].push_back(pl.get_pop().get_size());
+		}
+	}
+
+	demographics::remove_size_zero_pops(*state);
+
+	REQUIRE(state->world.pop_size() == expected.size());
+	for(uint32_t i = 0; i < expected.size(); ++i) {
+		auto p = fatten(state->world, dcon::pop_id{ dcon::pop_id::value_base_t(i) });
+		REQUIRE(p.get_size() == expected[i].size);
+		REQUIRE(p.get_culture() == expected[i].culture);
+		REQUIRE(p.get_province_from_pop_location() == expected[i].location);
+		REQUIRE(p.get_movement_from_pop_movement_membership() == expected[i].movement);
+		REQUIRE(p.get_rebel_faction_from_pop_rebellion_membership() == expected[i].faction);
+		auto regs = p.get_regiment_source();
+		REQUIRE(uint32_t(regs.end() - regs.begin()) == expected[i].regiments);
+	}
+	for(auto prov : state->world.in_province) {
+		std::vector<float> order;
+		for(auto pl : prov.get_pop_location())
+			order.push_back(pl.get_pop().get_size());
+		REQUIRE(order == province_order[prov.id.index()]);
+	}
+	state->world.for_each_regiment([&](dcon::regiment_id r) {
+		auto p = state->world.regiment_get_pop_from_regiment_source(r);
+		REQUIRE((!p || uint32_t(p.index()) < state->world.pop_size()));
+	});
+}
+
+TEST_CASE("packed pop ideology and issue updates match the buffer per key", "[demographics_tests]") {
+	std::unique_ptr<sys::state> per_key_state = load_testing_scenario_file();
+	std::unique_ptr<sys::state> packed_state = load_testing_scenario_file();
+
+	demographics::ideology_buffer ideology_per_key(*per_key_state);
+	demographics::issues_buffer issues_per_key(*per_key_state);
+	demographics::packed_attraction_buffer ideology_packed;
+	demographics::packed_attraction_buffer issues_packed;
+
+	// a few days' worth of staggered updates, so that every pop is visited twice
+	uint32_t const divisions = 3;
+	for(uint32_t day = 0; day < 2 * divisions; ++day) {
+		auto offset = day % divisions;
+		demographics::update_ideologies(*per_key_state, offset, divisions, ideology_per_key);
+		demographics::apply_ideologies(*per_key_state, offset, divisions, ideology_per_key);
+		demographics::update_issues(*per_key_state, offset, divisions, issues_per_key);
+		demographics::apply_issues(*per_key_state, offset, divisions, issues_per_key);
+
+		demographics::update_ideologies(*packed_state, offset, divisions, ideology_packed);
+		demographics::apply_ideologies(*packed_state, offset, divisions, ideology_packed);
+		demographics::update_issues(*packed_state, offset, divisions, issues_packed);
+		demographics::apply_issues(*packed_state, offset, divisions, issues_packed);
+	}
+
+	REQUIRE(per_key_state->world.pop_size() == packed_state->world.pop_size());
+	uint32_t mismatches = 0;
+	auto compare = [&](dcon::pop_demographics_key k) {
+		for(uint32_t i = 0; i < per_key_state->world.pop_size(); ++i) {
+			auto p = dcon::pop_id{ dcon::pop_id::value_base_t(i) };
+			if(per_key_state->world.pop_get_demographics(p, k) != packed_state->world.pop_get_demographics(p, k))
+				++mismatches;
+		}
+	};
+	per_key_state->world.for_each_ideology([&](dcon::ideology_id i) {
+		compare(pop_demographics::to_key(*per_key_state, i));
+	});
+	per_key_state->world.for_each_issue_option([&](dcon::issue_option_id i) {
+		compare(pop_demographics::to_key(*per_key_state, i));
+	});
+	REQUIRE(mismatches == 0);
+}
+#endif
@@ -0,0 +1,159 @@
+#include "catch.hpp"
+#include "system_state.hpp"
+#include "diplomatic_messages.hpp"
+
+namespace {
+
+diplomatic_message::message make_message(int32_t to, int32_t from, diplomatic_message::type_t t, sys::date when) {
+	diplomatic_message::message m;
+	std::memset(&m, 0, sizeof(diplomatic_message::message));
+	m.to = dcon::nation_id{ dcon::nation_id::value_base_t(to) };
+	m.from = dcon::nation_id{ dcon::nation_id::value_base_t(from) };
+	m.type = t;
+	m.when = when;
+	return m;
+}
+
+}
+
+TEST_CASE("pending messages reuse the lowest free slot", "[diplomatic_message_tests]") {
+	diplomatic_message::pending_message_queue q;
+	for(int32_t i = 0; i < 6; ++i) {
+		REQUIRE(q.add(make_message(1, i, diplomatic_message::type_t::alliance_request, sys::date{ 0 })) == uint32_t(i));
+	}
+	q.remove(4);
+	q.remove(1);
+	q.remove(3);
+	REQUIRE(q.size() == 3);
+	REQUIRE(q.add(make_message(2, 0, diplomatic_message::type_t::access_request, sys::date{ 0 })) == 1);
+	REQUIRE(q.add(make_message(2, 1, diplomatic_message::type_t::access_request, sys::date{ 0 })) == 3);
+	REQUIRE(q.add(make_message(2, 2, diplomatic_message::type_t::access_request, sys::date{ 0 })) == 4);
+	REQUIRE(q.add(make_message(2, 3, diplomatic_message::type_t::access_request, sys::date{ 0 })) == 6);
+	REQUIRE(q.size() == 7);
+}
+
+TEST_CASE("pending messages find the lowest matching slot", "[diplomatic_message_tests]") {
+	diplomatic_message::pending_message_queue q;
+	auto same = make_message(1, 2, diplomatic_message::type_t::alliance_request, sys::date{ 0 });
+	q.add(same); // 0
+	q.add(make_message(1, 3, diplomatic_message::type_t::alliance_request, sys::date{ 0 })); // 1
+	q.add(same); // 2
+	q.add(same); // 3
+	q.add(make_message(1, 2, diplomatic_message::type_t::access_request, sys::date{ 0 })); // 4
+
+	REQUIRE(q.find(same.to, same.from, same.type) == 0);
+	q.remove(0);
+	REQUIRE(q.find(same.to, same.from, same.type) == 2);
+	q.remove(2);
+	REQUIRE(q.find(same.to, same.from, same.type) == 3);
+	REQUIRE(q.add(same) == 0);
+	REQUIRE(q.find(same.to, same.from, same.type) == 0);
+
+	REQUIRE(q.find(same.to, same.from, diplomatic_message::type_t::call_ally_request) == -1);
+	REQUIRE(q.find(dcon::nation_id{ dcon::nation_id::value_base_t(7) }, same.from, same.type) == -1);
+	REQUIRE(q.find(dcon::nation_id{}, same.from, same.type) == -1);
+}
+
+TEST_CASE("pending messages expire in slot order and skip removed messages", "[diplomatic_message_tests]") {
+	diplomatic_message::pending_message_queue q;
+	auto const exp = diplomatic_message::message_expiration_days;
+
+	q.add(make_message(1, 10, diplomatic_message::type_t::alliance_request, sys::date{ 20 })); // 0
+	q.add(make_message(1, 11, diplomatic_message::type_t::alliance_request, sys::date{ 10 })); // 1
+	q.add(make_message(1, 12, diplomatic_message::type_t::alliance_request, sys::date{ 15 })); // 2
+	q.add(make_message(1, 13, diplomatic_message::type_t::alliance_request, sys::date{ 10 })); // 3
+
+	// slot 1 is answered, and its slot is taken by a message that is due much later; the old heap entry is stale
+	q.remove(1);
+	REQUIRE(q.add(make_message(1, 14, diplomatic_message::type_t::alliance_request, sys::date{ 40 })) == 1);
+
+	std::vector<diplomatic_message::message> out;
+	q.take_expired(sys::date{ uint16_t(10 + exp) }, out);
+	REQUIRE(out.size() == 1);
+	REQUIRE(out[0].from.index() == 13);
+
+	// everything due by now comes out in slot order, not in the order it became due
+	out.clear();
+	q.take_expired(sys::date{ uint16_t(20 + exp) }, out);
+	REQUIRE(out.size() == 2);
+	REQUIRE(out[0].from.index() == 10);
+	REQUIRE(out[1].from.index() == 12);
+	REQUIRE(q.size() == 1);
+
+	out.clear();
+	q.take_expired(sys::date{ uint16_t(39 + exp) }, out);
+	REQUIRE(out.empty());
+	q.take_expired(sys::date{ uint16_t(40 + exp) }, out);
+	REQUIRE(out.size() == 1);
+	REQUIRE(out[0].from.index() == 14);
+	REQUIRE(q.size() == 0);
+}
+
+#ifndef IGNORE_REAL_FILES_TESTS
+TEST_CASE("pending messages survive a save and load", "[diplomatic_message_tests]") {
+	std::unique_ptr<sys::state> state = load_testing_scenario_file();
+	auto const exp = diplomatic_message::message_expiration_days;
+
+	auto& q = state->pending_messages;
+	REQUIRE(q.size() == 0);
+	for(int32_t i = 0; i < 8; ++i) {
+		q.add(make_message(1 + i % 2, i, diplomatic_message::type_t::access_request, sys::date{ uint16_t(i) }));
+	}
+	q.remove(2);
+	q.remove(5);
+
+	std::vector<uint8_t> buffer(sys::sizeof_save_section(*state));
+	sys::write_save_section(buffer.data(), *state);
+
+	std::unique_ptr<sys::state> loaded = load_testing_scenario_file();
+	sys::read_save_section(buffer.data(), buffer.data() + buffer.size(), *loaded);
+	auto& l = loaded->pending_messages;
+
+	REQUIRE(l.size() == 6);
+	for(int32_t i = 0; i < 8; ++i) {
+		auto from = dcon::nation_id{ dcon::nation_id::value_base_t(i) };
+		auto to = dcon::nation_id{ dcon::nation_id::value_base_t(1 + i % 2) };
+		REQUIRE(l.find(to, from, diplomatic_message::type_t::access_request) == ((i == 2 || i == 5) ? -1 : i));
+	}
+	// the free slots and the expiry heap are rebuilt too
+	REQUIRE(l.add(make_message(3, 9, diplomatic_message::type_t::access_request, sys::date{ 100 })) == 2);
+	REQUIRE(l.add(make_message(3, 10, diplomatic_message::type_t::access_request, sys::date{ 100 })) == 5);
+	REQUIRE(l.add(make_message(3, 11, diplomatic_message::type_t::access_request, sys::date{ 100 })) == 8);
+	std::vector<diplomatic_message::message> out;
+	l.take_expired(sys::date{ uint16_t(3 + exp) }, out);
+	REQUIRE(out.size() == 3);
+	REQUIRE(out[0].from.index() == 0);
+	REQUIRE(out[1].from.index() == 1);
+	REQUIRE(out[2].from.index() == 3);
+}
+
+TEST_CASE("ai requests posted while resolving are answered", "[diplomatic_message_tests]") {
+	std::unique_ptr<sys::state> state = load_testing_scenario_file();
+
+	// the first great power asked to lead the attack in a crisis has gone to war since; the second is free
+	auto first = dcon::nation_id{ dcon::nation_id::value_base_t(0) };
+	auto second = dcon::nation_id{ dcon::nation_id::value_base_t(1) };
+	state->world.nation_set_is_player_controlled(first, false);
+	state->world.nation_set_is_player_controlled(second, false);
+	state->world.nation_set_is_at_war(first, true);
+	state->world.nation_set_is_at_war(second, false);
+	state->great_nations.clear();
+	state->great_nations.emplace_back(sys::date{ 0 }, first);
+	state->great_nations.emplace_back(sys::date{ 0 }, second);
+	state->current_crisis_mode = sys::crisis_mode::finding_attacker;
+	state->crisis_last_checked_gp = 0;
+	state->primary_crisis_attacker = dcon::nation_id{};
+	state->primary_crisis_defender = dcon::nation_id{};
+	state->ai_messages.clear();
+
+	diplomatic_message::post_message(*state, make_message(0, 2, diplomatic_message::type_t::be_crisis_primary_attacker, sys::date{ 0 }));
+	REQUIRE(state->ai_messages.size() == 1);
+	REQUIRE(state->primary_crisis_attacker == dcon::nation_id{});
+
+	// answering the first refuses and asks the second, whose request is answered in the same pass
+	diplomatic_message::resolve_ai_messages(*state);
+	REQUIRE(state->ai_messages.empty());
+	REQUIRE(state->crisis_last_checked_gp == 1);
+	REQUIRE(state->primary_crisis_attacker == second);
+}
+#endif
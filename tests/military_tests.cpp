@@ -0,0 +1,189 @@
+#include "catch.hpp"
+#include "system_state.hpp"
+#include <cstring>
+
+#ifndef IGNORE_REAL_FILES_TESTS
+namespace {
+
+uint64_t hash_cb_state(sys::state& state) {
+	uint64_t h = 14695981039346656037ull;
+	auto mix = [&](uint32_t v) {
+		h ^= v;
+		h *= 1099511628211ull;
+	};
+	auto mix_float = [&](float f) {
+		uint32_t v = 0;
+		std::memcpy(&v, &f, sizeof(float));
+		mix(v);
+	};
+
+	for(auto n : state.world.in_nation) {
+		mix(uint32_t(n.get_constructing_cb_target().index()));
+		mix(uint32_t(n.get_constructing_cb_type().index()));
+		mix(n.get_constructing_cb_is_discovered() ? 1 : 0);
+		mix_float(n.get_constructing_cb_progress());
+		mix_float(n.get_infamy());
+		for(auto& cb : n.get_available_cbs()) {
+			mix(uint32_t(cb.target.index()));
+			mix(uint32_t(cb.cb_type.index()));
+			mix(cb.expiration.value);
+		}
+	}
+	state.world.for_each_diplomatic_relation([&](dcon::diplomatic_relation_id r) {
+		mix(uint32_t(state.world.diplomatic_relation_get_related_nations(r, 0).index()));
+		mix(uint32_t(state.world.diplomatic_relation_get_related_nations(r, 1).index()));
+		mix_float(state.world.diplomatic_relation_get_value(r));
+	});
+	for(auto s : state.world.in_state_instance) {
+		mix_float(s.get_flashpoint_tension());
+	}
+	return h;
+}
+
+uint64_t run_cb_days(sys::state& state, bool in_parallel, int32_t days) {
+	// every nation with territory starts fabricating against the next one, with whatever cb type comes next in line
+	std::vector<dcon::nation_id> landed;
+	for(auto n : state.world.in_nation) {
+		if(n.get_owned_province_count() != 0)
+			landed.push_back(n);
+	}
+	REQUIRE(landed.size() > 1);
+	REQUIRE(state.world.cb_type_size() > 0);
+	for(size_t i = 0; i < landed.size(); ++i) {
+		auto n = fatten(state.world, landed[i]);
+		n.set_constructing_cb_target(landed[(i + 1) % landed.size()]);
+		n.set_constructing_cb_type(dcon::cb_type_id{ dcon::cb_type_id::value_base_t(i % state.world.cb_type_size()) });
+		n.set_constructing_cb_progress(float(i % 100));
+		n.set_constructing_cb_is_discovered(false);
+	}
+
+	for(int32_t i = 0; i < days; ++i) {
+		state.current_date += 1;
+		military::update_cbs(state, in_parallel);
+	}
+	return hash_cb_state(state);
+}
+
+// nations' recruitable regiments are only worked out on load, so they are only compared right after a rebuild
+void check_regiment_counts(sys::state& state, bool check_recruitable) {
+	std::vector<int32_t> recruitable(state.world.nation_size(), 0);
+	for(auto p : state.world.in_province) {
+		int32_t capacity = 0;
+		int32_t main_capacity = 0;
+		int32_t created = 0;
+		int32_t main_created = 0;
+		for(auto pl : p.get_pop_location()) {
+			auto pop = pl.get_pop();
+			if(pop.get_poptype() != state.culture_definitions.soldiers)
+				continue;
+			auto c = military::regiments_supported_by_pop(state, pop);
+			auto regs = pop.get_regiment_source();
+			auto r = int32_t(regs.end() - regs.begin());
+			capacity += c;
+			created += r;
+			main_capacity += military::main_culture_regiments_supported_by_pop(state, pop);
+			if(pop.get_is_primary_or_accepted_culture())
+				main_created += r;
+		}
+		REQUIRE(military::regiments_max_possible_from_province(state, p) == capacity);
+		REQUIRE(military::main_culture_regiments_max_possible_from_province(state, p) == main_capacity);
+		REQUIRE(military::regiments_created_from_province(state, p) == created);
+		REQUIRE(military::main_culture_regiments_created_from_province(state, p) == main_created);
+		if(auto owner = p.get_nation_from_province_ownership(); owner)
+			recruitable[owner.id.index()] += capacity;
+	}
+	if(check_recruitable) {
+		for(auto n : state.world.in_nation) {
+			REQUIRE(int32_t(n.get_recruitable_regiments()) == recruitable[n.id.index()]);
+		}
+	}
+}
+
+}
+
+TEST_CASE("regiment counts follow pop changes", "[military_tests]") {
+	std::unique_ptr<sys::state> state = load_testing_scenario_file();
+	check_regiment_counts(*state, true);
+
+	// soldier pops grow, shrink and die, and a few provinces change hands
+	uint32_t i = 0;
+	for(auto p : state->world.in_pop) {
+		if(p.get_poptype() == state->culture_definitions.soldiers) {
+			switch(i++ % 3) {
+				case 0:
+					p.set_size(p.get_size() * 3.0f);
+					break;
+				case 1:
+					p.set_size(p.get_size() * 0.25f);
+					break;
+				case 2:
+					p.set_size(0.0f);
+					break;
+			}
+		}
+	}
+	demographics::remove_size_zero_pops(*state);
+	military::update_pop_regiment_capacity(*state);
+	check_regiment_counts(*state, false);
+
+	// regiments disbanded through military::delete_regiment leave the counts right without waiting for the daily pass
+	std::vector<dcon::regiment_id> regiments;
+	for(auto r : state->world.in_regiment) {
+		if(r.get_pop_from_regiment_source() && regiments.size() < 50)
+			regiments.push_back(r);
+	}
+	for(auto r : regiments) {
+		military::delete_regiment(*state, r);
+	}
+	check_regiment_counts(*state, false);
+
+	std::vector<dcon::province_id> owned;
+	for(auto p : state->world.in_province) {
+		if(p.get_nation_from_province_ownership())
+			owned.push_back(p);
+	}
+	REQUIRE(owned.size() > 20);
+	for(size_t j = 0; j + 1 < owned.size() && j < 40; j += 2) {
+		province::change_province_owner(*state, owned[j], state->world.province_get_nation_from_province_ownership(owned[j + 1]));
+	}
+	check_regiment_counts(*state, false);
+
+	military::update_all_recruitable_regiments(*state);
+	check_regiment_counts(*state, true);
+}
+
+TEST_CASE("parallel cb update matches serial", "[military_tests]") {
+	std::unique_ptr<sys::state> serial_state = load_testing_scenario_file();
+	std::unique_ptr<sys::state> parallel_state = load_testing_scenario_file();
+
+	REQUIRE(hash_cb_state(*serial_state) == hash_cb_state(*parallel_state));
+
+	auto serial_hash = run_cb_days(*serial_state, false, 120);
+	auto parallel_hash = run_cb_days(*parallel_state, true, 120);
+	REQUIRE(serial_hash == parallel_hash);
+}
+
+TEST_CASE("parallel cb update matches serial when cb triggers test fabrication progress", "[military_tests]") {
+	std::unique_ptr<sys::state> serial_state = load_testing_scenario_file();
+	std::unique_ptr<sys::state> parallel_state = load_testing_scenario_file();
+
+	// every cb type may only be used against a target whose own fabrication has not passed the half way mark
+	auto script_cb_types = [](sys::state& state) {
+		float threshold = 50.0f;
+		uint16_t words[2] = { 0, 0 };
+		std::memcpy(words, &threshold, sizeof(float));
+		auto can_use = state.commit_trigger_data(std::vector<uint16_t>{ uint16_t(trigger::constructing_cb_progress | trigger::association_lt), words[0], words[1] });
+		for(auto cb : state.world.in_cb_type) {
+			cb.set_can_use(can_use);
+		}
+		military::update_cb_trigger_dependencies(state);
+		REQUIRE(state.military_definitions.cb_triggers_read_fabrication_progress);
+	};
+	script_cb_types(*serial_state);
+	script_cb_types(*parallel_state);
+
+	auto serial_hash = run_cb_days(*serial_state, false, 120);
+	auto parallel_hash = run_cb_days(*parallel_state, true, 120);
+	REQUIRE(serial_hash == parallel_hash);
+}
+#endif
@@ -0,0 +1,144 @@
+#include "catch.hpp"
+#include "system_state.hpp"
+#include "nations.hpp"
+
+TEST_CASE("ranking keys", "[nations_tests]") {
+	struct entry {
+		uint32_t tier = 0;
+		float score = 0.0f;
+		dcon::nation_id n;
+	};
+	float const sample_scores[] = { 0.0f, -0.0f, 1.5f, -2.25f, 100.1f, 0.1f, 3.0f, 1.0e9f, -1.0e-9f };
+
+	uint32_t seed = 12345;
+	auto next = [&]() {
+		seed = seed * 1664525u + 1013904223u;
+		return seed >> 8;
+	};
+
+	std::vector<uint64_t> keys;
+	std::vector<uint64_t> scratch;
+	for(int32_t trial = 0; trial < 50; ++trial) {
+		std::vector<entry> entries;
+		uint32_t count = 1 + next() % 700;
+		for(uint32_t i = 0; i < count; ++i) {
+			entries.push_back(entry{ next() % 4, sample_scores[next() % 9], dcon::nation_id{ dcon::nation_id::value_base_t(i) } });
+		}
+
+		keys.clear();
+		for(auto& e : entries)
+			keys.push_back(nations::ranking::make_key(e.tier, e.score, e.n));
+		nations::ranking::radix_sort(keys, scratch);
+
+		std::sort(entries.begin(), entries.end(), [](entry const& a, entry const& b) {
+			if(a.tier != b.tier)
+				return a.tier > b.tier;
+			if(a.score != b.score)
+				return a.score > b.score;
+			return a.n.index() > b.n.index();
+		});
+
+		REQUIRE(keys.size() == entries.size());
+		for(uint32_t i = 0; i < count; ++i) {
+			REQUIRE(nations::ranking::key_to_nation(keys[i]) == entries[i].n);
+		}
+	}
+}
+
+#ifndef IGNORE_REAL_FILES_TESTS
+namespace {
+
+// the orderings the rankings were sorted with before they were keyed, kept as the reference
+std::vector<dcon::nation_id> reference_rank_order(sys::state& state) {
+	std::vector<dcon::nation_id> result;
+	state.world.for_each_nation([&](dcon::nation_id n) { result.push_back(n); });
+	std::sort(result.begin(), result.end(), [&](dcon::nation_id a, dcon::nation_id b) {
+		auto fa = fatten(state.world, a);
+		auto fb = fatten(state.world, b);
+		if((fa.get_owned_province_count() != 0) != (fb.get_owned_province_count() != 0)) {
+			return (fa.get_owned_province_count() != 0);
+		}
+		if(fa.get_is_civilized() != fb.get_is_civilized())
+			return fa.get_is_civilized();
+		if(bool(fa.get_overlord_as_subject()) != bool(fa.get_overlord_as_subject()))
+			return !bool(fa.get_overlord_as_subject());
+		auto a_score = fa.get_military_score() + fa.get_industrial_score() + nations::prestige_score(state, a);
+		auto b_score = fb.get_military_score() + fb.get_industrial_score() + nations::prestige_score(state, b);
+		if(a_score != b_score)
+			return a_score > b_score;
+		return a.index() > b.index();
+	});
+	return result;
+}
+template<typename F>
+std::vector<dcon::nation_id> reference_ui_order(sys::state& state, F&& score) {
+	std::vector<dcon::nation_id> result;
+	state.world.for_each_nation([&](dcon::nation_id n) {
+		if(state.world.nation_get_owned_province_count(n) != 0)
+			result.push_back(n);
+	});
+	std::sort(result.begin(), result.end(), [&](dcon::nation_id a, dcon::nation_id b) {
+		auto fa = fatten(state.world, a);
+		auto fb = fatten(state.world, b);
+		if(fa.get_is_civilized() && !fb.get_is_civilized())
+			return true;
+		if(!fa.get_is_civilized() && fb.get_is_civilized())
+			return false;
+		if(bool(fa.get_overlord_as_subject()) && !bool(fa.get_overlord_as_subject()))
+			return false;
+		if(!bool(fa.get_overlord_as_subject()) && bool(fa.get_overlord_as_subject()))
+			return true;
+		auto a_score = score(a);
+		auto b_score = score(b);
+		if(a_score != b_score)
+			return a_score > b_score;
+		return a.index() > b.index();
+	});
+	return result;
+}
+
+void require_same_order(std::vector<dcon::nation_id> const& ranking, std::vector<dcon::nation_id> const& reference) {
+	for(size_t i = 0; i < reference.size(); ++i) {
+		REQUIRE(ranking[i] == reference[i]);
+	}
+	if(reference.size() < ranking.size()) {
+		REQUIRE(!ranking[reference.size()]);
+	}
+}
+
+void check_rankings(sys::state& state) {
+	nations::update_rankings(state);
+	nations::update_ui_rankings(state);
+
+	require_same_order(state.nations_by_rank, reference_rank_order(state));
+	require_same_order(state.nations_by_industrial_score, reference_ui_order(state, [&](dcon::nation_id n) { return state.world.nation_get_industrial_score(n); }));
+	require_same_order(state.nations_by_military_score, reference_ui_order(state, [&](dcon::nation_id n) { return state.world.nation_get_military_score(n); }));
+	require_same_order(state.nations_by_prestige_score, reference_ui_order(state, [&](dcon::nation_id n) { return nations::prestige_score(state, n); }));
+}
+
+}
+
+TEST_CASE("keyed rankings match the comparator order", "[nations_tests]") {
+	std::unique_ptr<sys::state> state = load_testing_scenario_file();
+
+	check_rankings(*state);
+	check_rankings(*state); // nothing changed: the previous order is kept
+
+	// many ties, signed zeros, and some nations without provinces
+	uint32_t i = 0;
+	state->world.for_each_nation([&](dcon::nation_id n) {
+		state->world.nation_set_military_score(n, uint16_t(i % 5));
+		state->world.nation_set_industrial_score(n, uint16_t(i % 3));
+		state->world.nation_set_prestige(n, (i % 7 == 0) ? -0.0f : float(i % 4) * 0.5f);
+		if(i % 11 == 0)
+			state->world.nation_set_owned_province_count(n, uint16_t(0));
+		++i;
+	});
+	check_rankings(*state);
+
+	state->world.for_each_nation([&](dcon::nation_id n) {
+		state->world.nation_set_prestige(n, state->world.nation_get_prestige(n) + float(n.index() % 13));
+	});
+	check_rankings(*state);
+}
+#endif
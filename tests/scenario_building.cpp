@@ -2073,6 +2073,126 @@ TEST_CASE("Scenario building", "[req-game-files]") {
 			});
 		});
 	};
+
+	// pop ideology and issue updates with a buffer per key vs. packed blocks of pops (ALICE_PACKED_POP_DEMOGRAPHICS)
+	demographics::ideology_buffer ideology_per_key(*state);
+	demographics::issues_buffer issues_per_key(*state);
+	demographics::packed_attraction_buffer ideology_packed;
+	demographics::packed_attraction_buffer issues_packed;
+
+	BENCHMARK_ADVANCED("ideology update, buffer per key")(Catch::Benchmark::Chronometer meter) {
+		trash_cache();
+		meter.measure([&]() {
+			demographics::update_ideologies(*state, 0, 1, ideology_per_key);
+			demographics::apply_ideologies(*state, 0, 1, ideology_per_key);
+		});
+	};
+	BENCHMARK_ADVANCED("ideology update, packed pop blocks")(Catch::Benchmark::Chronometer meter) {
+		trash_cache();
+		meter.measure([&]() {
+			demographics::update_ideologies(*state, 0, 1, ideology_packed);
+			demographics::apply_ideologies(*state, 0, 1, ideology_packed);
+		});
+	};
+	BENCHMARK_ADVANCED("issues update, buffer per key")(Catch::Benchmark::Chronometer meter) {
+		trash_cache();
+		meter.measure([&]() {
+			demographics::update_issues(*state, 0, 1, issues_per_key);
+			demographics::apply_issues(*state, 0, 1, issues_per_key);
+		});
+	};
+	BENCHMARK_ADVANCED("issues update, packed pop blocks")(Catch::Benchmark::Chronometer meter) {
+		trash_cache();
+		meter.measure([&]() {
+			demographics::update_issues(*state, 0, 1, issues_packed);
+			demographics::apply_issues(*state, 0, 1, issues_packed);
+		});
+	};
+
+	// province name lookups: a scan over the province names vs. the search index
+	text::load_text_data(*state, 2);
+	text::build_search_indices(*state);
+	std::vector<uint32_t> search_results;
+
+	BENCHMARK_ADVANCED("province prefix search, scan")(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&]() {
+			search_results.clear();
+			state->world.for_each_province([&](dcon::province_id p) {
+				auto name = parsers::lowercase_str(text::produce_simple_string(*state, state->world.province_get_name(p)));
+				if(name.starts_with("san"))
+					search_results.push_back(uint32_t(p.index()));
+			});
+			return search_results.size();
+		});
+	};
+	BENCHMARK_ADVANCED("province prefix search, index")(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&]() {
+			state->search_data.provinces.find_prefix("san", search_results);
+			return search_results.size();
+		});
+	};
+	BENCHMARK_ADVANCED("province substring search, index")(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&]() {
+			state->search_data.provinces.find_substring("burg", search_results);
+			return search_results.size();
+		});
+	};
+
+	// daily rankings at 600 nations: comparator sorts vs. packed keys
+	while(state->world.nation_size() < 600) {
+		auto n = state->world.create_nation();
+		state->world.nation_set_owned_province_count(n, uint16_t(n.index() % 5 != 0 ? 1 : 0));
+		state->world.nation_set_is_civilized(n, n.index() % 3 == 0);
+		state->world.nation_set_military_score(n, uint16_t(n.index() * 7 % 200));
+		state->world.nation_set_industrial_score(n, uint16_t(n.index() * 13 % 300));
+		state->world.nation_set_prestige(n, float(n.index() % 17) * 1.5f);
+	}
+	std::vector<dcon::nation_id> comparator_order;
+	auto sort_by_comparator = [&](auto&& score, bool ranked_by_provinces) {
+		comparator_order.clear();
+		state->world.for_each_nation([&](dcon::nation_id n) {
+			if(ranked_by_provinces || state->world.nation_get_owned_province_count(n) != 0)
+				comparator_order.push_back(n);
+		});
+		std::sort(comparator_order.begin(), comparator_order.end(), [&](dcon::nation_id a, dcon::nation_id b) {
+			auto fa = fatten(state->world, a);
+			auto fb = fatten(state->world, b);
+			if((fa.get_owned_province_count() != 0) != (fb.get_owned_province_count() != 0))
+				return (fa.get_owned_province_count() != 0);
+			if(fa.get_is_civilized() != fb.get_is_civilized())
+				return fa.get_is_civilized();
+			auto a_score = score(a);
+			auto b_score = score(b);
+			if(a_score != b_score)
+				return a_score > b_score;
+			return a.index() > b.index();
+		});
+	};
+	BENCHMARK_ADVANCED("rankings, comparator sorts")(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&]() {
+			sort_by_comparator([&](dcon::nation_id n) { return state->world.nation_get_military_score(n) + state->world.nation_get_industrial_score(n) + nations::prestige_score(*state, n); }, true);
+			sort_by_comparator([&](dcon::nation_id n) { return float(state->world.nation_get_industrial_score(n)); }, false);
+			sort_by_comparator([&](dcon::nation_id n) { return float(state->world.nation_get_military_score(n)); }, false);
+			sort_by_comparator([&](dcon::nation_id n) { return nations::prestige_score(*state, n); }, false);
+			return comparator_order.size();
+		});
+	};
+	BENCHMARK_ADVANCED("rankings, packed keys")(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&]() {
+			state->nations_by_rank[0] = dcon::nation_id{}; // force the sorts
+			state->nations_by_industrial_score[0] = dcon::nation_id{};
+			state->nations_by_military_score[0] = dcon::nation_id{};
+			state->nations_by_prestige_score[0] = dcon::nation_id{};
+			nations::update_rankings(*state);
+			nations::update_ui_rankings(*state);
+		});
+	};
+	BENCHMARK_ADVANCED("rankings, packed keys, order unchanged")(Catch::Benchmark::Chronometer meter) {
+		meter.measure([&]() {
+			nations::update_rankings(*state);
+			nations::update_ui_rankings(*state);
+		});
+	};
 	// ***************************/
 }
 
@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include <cstdio>
+#include <cmath>
+
+#ifndef _WIN64
+namespace {
+
+// a short mono 16 bit sine wave, so that the test does not depend on the game files
+void write_test_wav(char const* path) {
+	constexpr uint32_t sample_rate = 22050;
+	constexpr uint32_t sample_count = sample_rate / 10;
+	int16_t samples[sample_count];
+	for(uint32_t i = 0; i < sample_count; ++i)
+		samples[i] = int16_t(8000.0f * std::sin(float(i) * 0.1f));
+
+	auto put32 = [](FILE* f, uint32_t v) { fwrite(&v, 4, 1, f); };
+	auto put16 = [](FILE* f, uint16_t v) { fwrite(&v, 2, 1, f); };
+
+	FILE* f = fopen(path, "wb");
+	REQUIRE(f != nullptr);
+	fwrite("RIFF", 1, 4, f);
+	put32(f, 36 + sizeof(samples));
+	fwrite("WAVEfmt ", 1, 8, f);
+	put32(f, 16);
+	put16(f, 1); // pcm
+	put16(f, 1); // mono
+	put32(f, sample_rate);
+	put32(f, sample_rate * 2);
+	put16(f, 2);
+	put16(f, 16);
+	fwrite("data", 1, 4, f);
+	put32(f, sizeof(samples));
+	fwrite(samples, sizeof(samples), 1, f);
+	fclose(f);
+}
+
+}
+
+TEST_CASE("sound effects play without touching files", "[sound_tests]") {
+	char const* path = "alice_sound_test.wav";
+	write_test_wav(path);
+
+	sound::sound_impl impl(true); // null backend: nothing reaches an audio device
+	sound::audio_instance effect;
+	effect.filename = path;
+	sound::audio_instance other;
+	other.filename = path;
+
+	impl.load_into_memory(effect);
+	impl.load_into_memory(other);
+	REQUIRE(effect.is_loaded());
+	REQUIRE(other.is_loaded());
+	auto const opened = impl.files_opened();
+	REQUIRE(opened == 2);
+
+	impl.load_into_memory(effect); // already decoded
+	for(int32_t i = 0; i < 200; ++i) {
+		impl.play_from_memory(i % 3 == 0 ? other : effect, i % 2 == 0 ? sound::voice_category::effect : sound::voice_category::interface, 0.5f);
+	}
+	REQUIRE(impl.files_opened() == opened);
+
+	// a category volume reaches every voice of that category, and only those; voices that were never used keep their initial volume
+	auto expected_volume = [](sound::voice const& v) {
+		if(v.category == sound::voice_category::interface)
+			return 0.25f;
+		return v.started != 0 ? 0.5f : 1.0f;
+	};
+	impl.set_volume(sound::voice_category::interface, 0.25f);
+	uint32_t interface_voices = 0;
+	for(auto& v : impl.voices) {
+		REQUIRE(v.ready);
+		REQUIRE(ma_sound_get_volume(&v.sound) == expected_volume(v));
+		if(v.category == sound::voice_category::interface)
+			++interface_voices;
+	}
+	REQUIRE(interface_voices > 0);
+
+	// the volume of a single play applies to its own voice only
+	impl.play_from_memory(effect, sound::voice_category::interface, 0.75f);
+	sound::voice const* latest = nullptr;
+	for(auto& v : impl.voices) {
+		if(!latest || v.started > latest->started)
+			latest = &v;
+	}
+	REQUIRE(latest->playing == &effect);
+	REQUIRE(latest->category == sound::voice_category::interface);
+	REQUIRE(ma_sound_get_volume(&latest->sound) == 0.75f);
+	for(auto& v : impl.voices) {
+		if(&v != latest)
+			REQUIRE(ma_sound_get_volume(&v.sound) == expected_volume(v));
+	}
+
+	std::remove(path);
+}
+#endif
@@ -48,6 +48,11 @@ std::unique_ptr<sys::state> load_testing_scenario_file() {
 #include "scenario_building.cpp"
 #include "defines_tests.cpp"
 #include "triggers_tests.cpp"
+#include "military_tests.cpp"
+#include "nations_tests.cpp"
+#include "demographics_tests.cpp"
+#include "diplomatic_messages_tests.cpp"
+#include "sound_tests.cpp"
 
 TEST_CASE("Dummy test", "[dummy test instance]") {
     REQUIRE(1 + 1 == 2); 
@@ -1,5 +1,7 @@
 #include "catch.hpp"
 #include "text.hpp"
+#include "search_index.hpp"
+#include "parsers_declarations.hpp"
 
 TEST_CASE("text from csv", "[parsers]") {
     SECTION("sample_lines") {
@@ -42,6 +44,58 @@ TEST_CASE("text from csv", "[parsers]") {
     }
 }
 
+TEST_CASE("search index", "[parsers]") {
+    std::vector<std::string> names{ "Paris", "Parma", "Pas-de-Calais", "London", "Londonderry", "New London", "Lyon", "Lyons",
+        "Oslo", "ostrava", "OSTEND", "Bad Ischl", "Baden", "Ad", "A", "", "San Sebastian", "Santander", "Santa Fe", "Sant'Agata" };
+    // some generated names, so that every trigram has more than a handful of postings
+    uint32_t seed = 12345;
+    for(uint32_t i = 0; i < 500; ++i) {
+        std::string name;
+        auto length = 2 + (i % 9);
+        for(uint32_t j = 0; j < length; ++j) {
+            seed = seed * 1103515245 + 12345;
+            name += char(((seed >> 16) % 2 == 0 ? 'a' : 'A') + (seed >> 8) % 6);
+        }
+        names.push_back(name);
+    }
+
+    text::search_index index;
+    for(uint32_t i = 0; i < names.size(); ++i)
+        index.add(names[i], i);
+    index.finish();
+    REQUIRE(index.size() == names.size());
+
+    std::vector<std::string_view> terms{ "", "p", "PAR", "par", "lon", "London", "ondo", "ON", "sant", "an", "a", "aaa", "abc", "BaD", "fac", "zzz", "cdef", "ostr" };
+    for(auto& n : names) {
+        if(n.length() >= 4)
+            terms.push_back(std::string_view(n).substr(1, 3));
+    }
+
+    std::vector<uint32_t> found;
+    for(auto t : terms) {
+        auto folded = parsers::lowercase_str(t);
+        std::vector<uint32_t> prefix_expected;
+        std::vector<uint32_t> substring_expected;
+        std::vector<uint32_t> exact_expected;
+        for(uint32_t i = 0; i < names.size(); ++i) {
+            auto name = parsers::lowercase_str(names[i]);
+            if(name.starts_with(folded))
+                prefix_expected.push_back(i);
+            if(name.find(folded) != std::string::npos)
+                substring_expected.push_back(i);
+            if(name == folded)
+                exact_expected.push_back(i);
+        }
+
+        index.find_prefix(t, found);
+        REQUIRE(found == prefix_expected);
+        index.find_substring(t, found);
+        REQUIRE(found == substring_expected);
+        index.find_exact(t, found);
+        REQUIRE(found == exact_expected);
+    }
+}
+
 #ifndef IGNORE_REAL_FILES_TESTS
 TEST_CASE("text game files parsing", "[parsers]") {
     SECTION("empty_file_with_types") {